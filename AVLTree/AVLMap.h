@@ -0,0 +1,253 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: AVLMap.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - Refuses AVL_COUNTED, keys are unique already
+*		- 10/17/2026 - Refuses AVL_COPY_ON_WRITE, Find and operator[] change values in place
+**************************************************************/
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+#include "AVLTree.h"
+#include "AVLTreeIterator.h"
+
+/************************************************************************
+* Class: AVLMapEntry
+*
+* Purpose: One key/value pair of an AVLMap. Entries are ordered by
+*		their key alone, and can be compared with a bare key so the map
+*		never builds a dummy entry just to search.
+*
+* Manager functions:
+* template <typename KeyArg, typename... Args> AVLMapEntry(KeyArg&& key, Args&&... args);
+*		Builds the key from key and the value in place from args
+*
+* Methods:
+* const K& GetKey() const;
+*		Gets m_key
+* const V& GetValue() const; / V& GetValue();
+*		Gets m_value
+*
+*************************************************************************/
+template <typename K, typename V>
+class AVLMapEntry
+{
+public:
+	template <typename KeyArg, typename... Args,
+		typename = typename std::enable_if<!std::is_same<typename std::decay<KeyArg>::type, AVLMapEntry<K, V>>::value>::type>
+	explicit AVLMapEntry(KeyArg&& key, Args&&... args);
+
+	const K& GetKey() const;
+	const V& GetValue() const;
+	V& GetValue();
+
+	friend bool operator<(const AVLMapEntry<K, V>& lhs, const AVLMapEntry<K, V>& rhs) { return lhs.m_key < rhs.m_key; }
+	friend bool operator<(const K& lhs, const AVLMapEntry<K, V>& rhs) { return lhs < rhs.m_key; }
+	friend bool operator<(const AVLMapEntry<K, V>& lhs, const K& rhs) { return lhs.m_key < rhs; }
+
+private:
+	K m_key;
+	V m_value;
+};
+
+/************************************************************************
+* Class: AVLMap
+*
+* Purpose: This class is an ordered key/value map on top of AVLTree.
+*		It uses the same nodes, allocators and rotations, but every
+*		upsert finds or places its key in a single walk down the tree
+*		(AVLTree::FindOrInsert) instead of a search and then an Insert.
+*		Keys are unique and only need operator<. Copying and moving
+*		work like they do for AVLTree.
+*
+* Methods:
+* V& operator[](const K& key);
+*		Returns the value of key, inserting a default constructed value first if key is new
+* bool Insert(const K& key, const V& value);
+*		Adds key with value if key is new. Returns true if it was added, an existing value is left alone
+* template <typename M> bool InsertOrAssign(const K& key, M&& value);
+*		Adds key with value, or assigns value to the existing entry. Returns true if key was new
+* template <typename... Args> bool TryEmplace(const K& key, Args&&... args);
+*		Adds key with a value constructed in place from args if key is new. Returns true if it was added,
+*		args are not touched otherwise
+* void Delete(const K& key);
+*		Deletes the entry of key, throws if there is none
+* V* Find(const K& key); / const V* Find(const K& key) const;
+*		Returns the value of key, or nullptr
+* bool Contains(const K& key) const;
+*		Returns true if key is in the map
+* int Size() const;
+*		Returns the number of entries
+* bool IsEmpty() const;
+*		Returns true if the map has no entries
+* void Purge();
+*		Removes every entry
+* const_iterator begin() const; / end() const;
+*		In-order iterators over the entries (ordered by key)
+*
+*************************************************************************/
+template <typename K, typename V, template <typename> class Allocator = ArenaAllocator, unsigned Options = AVL_PLAIN>
+class AVLMap
+{
+public:
+	typedef AVLMapEntry<K, V> entry_type;
+	typedef AVLTreeIterator<AVLMapEntry<K, V>, Options> iterator;
+	typedef AVLTreeIterator<AVLMapEntry<K, V>, Options> const_iterator;
+
+	V& operator[](const K& key);
+	bool Insert(const K& key, const V& value);
+	template <typename M> bool InsertOrAssign(const K& key, M&& value);
+	template <typename... Args> bool TryEmplace(const K& key, Args&&... args);
+	void Delete(const K& key);
+
+	V* Find(const K& key);
+	const V* Find(const K& key) const;
+	bool Contains(const K& key) const;
+	int Size() const;
+	bool IsEmpty() const;
+	void Purge();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	static_assert((Options & AVL_COUNTED) == 0, "AVLMap keys are unique, AVL_COUNTED does not apply");
+	static_assert((Options & AVL_COPY_ON_WRITE) == 0, "AVLMap hands out values to change in place, AVL_COPY_ON_WRITE is not supported");
+
+	AVLTree<AVLMapEntry<K, V>, Allocator, Options> m_tree;
+};
+
+
+/// Function Code ///
+
+template<typename K, typename V>
+template<typename KeyArg, typename... Args, typename>
+inline AVLMapEntry<K, V>::AVLMapEntry(KeyArg&& key, Args&&... args) : m_key(std::forward<KeyArg>(key)), m_value(std::forward<Args>(args)...)
+{
+}
+
+template<typename K, typename V>
+inline const K& AVLMapEntry<K, V>::GetKey() const
+{
+	return m_key;
+}
+
+template<typename K, typename V>
+inline const V& AVLMapEntry<K, V>::GetValue() const
+{
+	return m_value;
+}
+
+template<typename K, typename V>
+inline V& AVLMapEntry<K, V>::GetValue()
+{
+	return m_value;
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline V& AVLMap<K, V, Allocator, Options>::operator[](const K & key)
+{
+	bool inserted = false;
+	auto make = [&]() { return m_tree.CreateNode(key); };
+
+	return m_tree.FindOrInsert(key, make, inserted)->m_data.GetValue();
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline bool AVLMap<K, V, Allocator, Options>::Insert(const K & key, const V & value)
+{
+	bool inserted = false;
+	auto make = [&]() { return m_tree.CreateNode(key, value); };
+
+	m_tree.FindOrInsert(key, make, inserted);
+
+	return inserted;
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+template<typename M>
+inline bool AVLMap<K, V, Allocator, Options>::InsertOrAssign(const K & key, M && value)
+{
+	bool inserted = false;
+	auto make = [&]() { return m_tree.CreateNode(key, std::forward<M>(value)); };
+
+	AVLTreeNode<AVLMapEntry<K, V>, Options>* node = m_tree.FindOrInsert(key, make, inserted);
+
+	if (!inserted)
+		node->m_data.GetValue() = std::forward<M>(value);
+
+	return inserted;
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+template<typename... Args>
+inline bool AVLMap<K, V, Allocator, Options>::TryEmplace(const K & key, Args&&... args)
+{
+	bool inserted = false;
+	auto make = [&]() { return m_tree.CreateNode(key, std::forward<Args>(args)...); };
+
+	m_tree.FindOrInsert(key, make, inserted);
+
+	return inserted;
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline void AVLMap<K, V, Allocator, Options>::Delete(const K & key)
+{
+	m_tree.DeleteKey(key);
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline V* AVLMap<K, V, Allocator, Options>::Find(const K & key)
+{
+	AVLTreeNode<AVLMapEntry<K, V>, Options>* found = m_tree.FindNode(key);
+
+	return found != nullptr ? &found->m_data.GetValue() : nullptr;
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline const V* AVLMap<K, V, Allocator, Options>::Find(const K & key) const
+{
+	AVLTreeNode<AVLMapEntry<K, V>, Options>* found = m_tree.FindNode(key);
+
+	return found != nullptr ? &found->m_data.GetValue() : nullptr;
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline bool AVLMap<K, V, Allocator, Options>::Contains(const K & key) const
+{
+	return m_tree.FindNode(key) != nullptr;
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline int AVLMap<K, V, Allocator, Options>::Size() const
+{
+	return m_tree.Size();
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline bool AVLMap<K, V, Allocator, Options>::IsEmpty() const
+{
+	return m_tree.IsEmpty();
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline void AVLMap<K, V, Allocator, Options>::Purge()
+{
+	m_tree.Purge();
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline typename AVLMap<K, V, Allocator, Options>::const_iterator AVLMap<K, V, Allocator, Options>::begin() const
+{
+	return m_tree.begin();
+}
+
+template<typename K, typename V, template <typename> class Allocator, unsigned Options>
+inline typename AVLMap<K, V, Allocator, Options>::const_iterator AVLMap<K, V, Allocator, Options>::end() const
+{
+	return m_tree.end();
+}
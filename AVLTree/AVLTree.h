@@ -3,589 +3,2461 @@
 * Filename: AVLTree.h
 * Date Created: 2/20/2019
 * Modifications:
-**************************************************************/
-
-#pragma once
-
-#define DEBUG true
-
-#include <iostream>
-#include <algorithm>
-using std::max;
-using std::min;
-#include "AVLTreeNode.h"
-#include "Exception.h"
-#include "Queue.h"
-
+*		- 10/17/2026 - Delete rebalances along the search path only (O(log n))
+*		- 10/17/2026 - Added Find, Contains and the ordered lookups (LowerBound, Floor, ...)
+*		- 10/17/2026 - Nodes come from an Allocator template parameter (ArenaAllocator by default)
+*		- 10/17/2026 - Added Size and the AVL_ORDER_STATISTICS queries (Select, Rank, CountRange)
+*		- 10/17/2026 - Height is kept up to date by Insert and Delete instead of scanning the tree
+*		- 10/17/2026 - Added in-order iterators; LowerBound and UpperBound return iterators
+*		- 10/17/2026 - Traversals take any callable, can stop early and no longer recurse
+*		- 10/17/2026 - Added BuildFromSorted and the sorted range constructor (O(n) bulk build)
+*		- 10/17/2026 - Added Join and the join/split based Union, Intersection and Difference
+*		- 10/17/2026 - Added the move constructor and assignment, Insert(T&&) and Emplace
+*		- 10/17/2026 - Lookups and deletes can search by key; added FindOrInsert for AVLMap
+*		- 10/17/2026 - Added the AVL_COUNTED multiset option and Count
+*		- 10/17/2026 - Documented the cost of copies and where to get O(1) ones
+*		- 10/17/2026 - Added Freeze for pointer-free read only copies
+*		- 10/17/2026 - Moves swap the allocator in O(1) instead of adopting its blocks
+*		- 10/17/2026 - Reverse iterators are AVLTreeReverseIterator, which does not copy its path to dereference
+*		- 10/17/2026 - Added AVL_COPY_ON_WRITE, copies share nodes in O(1) and writes copy the shared nodes they change
+*		- 10/17/2026 - Added TryInsert and TryEmplace for allocators with a fixed number of nodes (FixedAVLTree)
+*		- 10/17/2026 - Added TryDelete, which reports a missing item instead of throwing
+*		- 10/17/2026 - Added const traversals, which read shared nodes instead of copying them
+**************************************************************/
+
+#pragma once
+
+#define DEBUG true
+
+#include <iostream>
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <utility>
+using std::max;
+using std::min;
+#include "AVLTreeNode.h"
+#include "ArenaAllocator.h"
+#include "AVLTreeIterator.h"
+#include "AVLTreeReverseIterator.h"
+#include "Exception.h"
+#include "FrozenAVLTree.h"
+#include "Queue.h"
+
 /************************************************************************
 * Class: AVLTree
 *
 * Purpose: This class represents an AVLTree using AVLTreeNodes
+*		Node storage comes from Allocator<AVLTreeNode<T, Options>>, which is an
+*		ArenaAllocator unless another one (such as HeapAllocator) is given
+*		Options is a mask of AVL_OPTIONS. AVL_ORDER_STATISTICS keeps a subtree
+*		size in every node so Select, At, Rank and CountRange run in O(log n);
+*		trees without it do not store the field and cannot call those methods
+*		AVL_COUNTED stores equal items once with a count. Inserting a copy of
+*		an item already in the tree only bumps its count, so height and memory
+*		follow the number of distinct items. Size, Select, Rank and CountRange
+*		count every copy, while iterators and traversals visit each distinct
+*		item once
+*		AVL_COPY_ON_WRITE makes copies O(1): a copy shares every node, and
+*		each node counts the trees and parents pointing at it. A write copies
+*		only the shared nodes it changes (its path, plus a sibling or two when
+*		Delete rotates), a node used by one tree alone is changed in place.
+*		Traversals hand out T&, so they first give the tree its own copy of
+*		every node. Shared nodes outlive the tree that made them, so the
+*		option needs an Allocator that frees nodes one by one (HeapAllocator)
 *
 * Manager functions:
-* AVLTree();
-* AVLTree(const AVLTree<T>& copy);
-* ~AVLTree();
-* AVLTree<T>& operator=(const AVLTree<T>& rhs);
+* AVLTree();
+* AVLTree(const AVLTree<T, Allocator, Options>& copy);
+*		Copies every node in O(n), the nodes belong to this tree's allocator. With
+*		AVL_COPY_ON_WRITE it shares the nodes of copy in O(1) instead
+* AVLTree(AVLTree<T, Allocator, Options>&& other);
+*		Takes over the nodes of other, leaving it empty
+* template <typename ForwardIt> AVLTree(ForwardIt first, ForwardIt last);
+*		Builds the tree from a sorted range (see BuildFromSorted)
+* ~AVLTree();
+* AVLTree<T, Allocator, Options>& operator=(const AVLTree<T, Allocator, Options>& rhs);
+* AVLTree<T, Allocator, Options>& operator=(AVLTree<T, Allocator, Options>&& rhs);
 *
 * Methods:
-* void Insert(const T& data); 
-*		Inserts data into the tree
-* void Delete(const T& data); 
-*		Deletes the equivalent data from the tree. Returns if there was equivalent data or not
-* void Purge(); 
-*		calls Purge with m_root
-* int Height() const; 
-*		returns the height of the tree
-*
-* Testing:
-* bool IsEmpty() const; 
-*		Returns true if the tree is empty
-* bool IsBalanced() const; 
-*		Returns true if all balance factors are between -1 and 1
-* //bool IsHeightBalanced() const;
-*		Unused -- Checks the heights of the child nodes to determine if all nodes are actually balanced
-* //bool BalanceMatchesHeights(AVLTreeNode<T>* root) const;
-*		Unused -- Checks a node to see if its balance factor matches its actual calculated balance factor
-*
-* Traversals:
-* void InOrder(void visit(T&));
-*		Performs an InOrder traversal of the tree and calls visit with the node's data
-* void PreOrder(void visit(T&));
-*		Performs a PreOrder traversal of the tree and calls visit with the node's data
-* void PostOrder(void visit(T&));
-*		Performs a PostOrder traversal of the tree and calls visit with the node's data
+* void Insert(const T& data); 
+*		Inserts data into the tree
+* void Insert(T&& data);
+*		Inserts data into the tree, moving it into the node
+* template <typename... Args> void Emplace(Args&&... args);
+*		Inserts an item constructed in place in the node from args
+* bool TryInsert(const T& data); / bool TryInsert(T&& data);
+*		Inserts data into the tree, or returns false, leaving the tree as it was, if the
+*		allocator has no storage left (Insert throws then). Only an allocator with a fixed
+*		number of nodes, such as FixedAllocator, ever runs out. With AVL_COUNTED a copy of
+*		an item already in the tree still needs a free node to be turned into a count
+* template <typename... Args> bool TryEmplace(Args&&... args);
+*		Same as Emplace, returns false if the allocator has no storage left
+* void Delete(const T& data); 
+*		Deletes the equivalent data from the tree. Returns if there was equivalent data or not
+*		With AVL_COUNTED this removes one copy
+* bool TryDelete(const T& data);
+*		Same as Delete in one walk, returns false instead of throwing if there is no equivalent data
+* void Purge(); 
+*		calls Purge with m_root
+* template <typename ForwardIt> void BuildFromSorted(ForwardIt first, ForwardIt last);
+*		Replaces the contents with a sorted range in O(n), without rotations. Throws if the range is not sorted
+* FrozenAVLTree<T> Freeze(FROZEN_LAYOUT layout = FROZEN_EYTZINGER) const;
+*		Returns a read only copy in one pointer-free array (breadth first or van Emde Boas order)
+*		whose searches are branchless and cache friendly. With AVL_COUNTED each item is copied once
+* int Height() const; 
+*		returns the height of the tree in O(1)
+* int Size() const;
+*		returns the number of items in the tree in O(1)
+*
+* Order statistics (AVL_ORDER_STATISTICS only):
+* const T& Select(int k) const;
+*		Returns the k-th smallest item, counting from 0
+* const T& At(int k) const;
+*		Same as Select
+* int Rank(const T& data) const;
+*		Returns how many items are less than data
+* int CountRange(const T& low, const T& high) const;
+*		Returns how many items are between low and high, inclusive
+*
+* Set algebra (meant for trees of distinct items, other is left empty and its nodes are reused, not for AVL_COUNTED):
+* void Union(AVLTree<T, Allocator, Options>& other);
+*		Adds every item of other that is not already in the tree
+* void Intersection(AVLTree<T, Allocator, Options>& other);
+*		Keeps only the items that are also in other
+* void Difference(AVLTree<T, Allocator, Options>& other);
+*		Removes every item that is also in other
+* void Join(const T& pivot, AVLTree<T, Allocator, Options>& right);
+*		Appends pivot and then every item of right. Throws unless tree <= pivot <= right
+*
+* Lookups:
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* int Count(const T& data) const;
+*		Returns how many copies of data are in the tree, O(log n) with AVL_COUNTED
+* const T* Find(const T& data) const;
+*		Returns a pointer to the stored equivalent data, or nullptr if there is none
+* const_iterator LowerBound(const T& data) const;
+*		Returns an iterator to the smallest item that is not less than data, or end()
+* const_iterator UpperBound(const T& data) const;
+*		Returns an iterator to the smallest item that is greater than data, or end()
+* const T* Floor(const T& data) const;
+*		Returns the largest item that is not greater than data, or nullptr
+* const T* Ceiling(const T& data) const;
+*		Returns the smallest item that is not less than data, or nullptr
+* const T* Predecessor(const T& data) const;
+*		Returns the largest item that is less than data, or nullptr
+* const T* Successor(const T& data) const;
+*		Returns the smallest item that is greater than data, or nullptr
+*
+* Iterators:
+* const_iterator begin() const; / const_iterator end() const;
+*		In-order iterators over the items (iterator is the same read only type)
+* const_reverse_iterator rbegin() const; / const_reverse_iterator rend() const;
+*		Reverse in-order iterators over the items
+*
+* Testing:
+* bool IsEmpty() const; 
+*		Returns true if the tree is empty
+* bool IsBalanced() const; 
+*		Returns true if all balance factors are between -1 and 1
+* //bool IsHeightBalanced() const;
+*		Unused -- Checks the heights of the child nodes to determine if all nodes are actually balanced
+* //bool BalanceMatchesHeights(AVLTreeNode<T, Options>* root) const;
+*		Unused -- Checks a node to see if its balance factor matches its actual calculated balance factor
+*
+* Traversals:
+* void InOrder(void visit(T&));
+*		Performs an InOrder traversal of the tree and calls visit with the node's data
+* void PreOrder(void visit(T&));
+*		Performs a PreOrder traversal of the tree and calls visit with the node's data
+* void PostOrder(void visit(T&));
+*		Performs a PostOrder traversal of the tree and calls visit with the node's data
 * void BreadthFirst(void visit(T&));
 *		Performs a BreadthFirst traversal of the tree and calls visit with the node's data
+* template <typename Visitor> bool InOrder(Visitor visit); (also PreOrder, PostOrder, BreadthFirst)
+*		Same traversals for any callable taking T&. If visit returns a bool, returning
+*		false stops the traversal. Returns false if it was stopped, true if it finished.
+*		With AVL_COPY_ON_WRITE these first copy every node shared with another tree,
+*		since visit may change the items
+* void InOrder(void visit(const T&)) const; (also PreOrder, PostOrder, BreadthFirst)
+* template <typename Visitor> bool InOrder(Visitor visit) const; (also PreOrder, PostOrder, BreadthFirst)
+*		Same traversals handing out const T&. They only read, so shared nodes stay shared
 *
 * --- HELPER FUNCTIONS ---
-* Core helpers:
-* void CopyTree(AVLTreeNode<T>*& root, const AVLTreeNode<T>* copyRoot);
-*		Helps copy constructor by recursively copying data
-* void Purge(AVLTreeNode<T>*& root); //Purge  remove all items from the list.
-*		Helps Purge() function by recursively purging items
-*
-* Method helpers:
-* void InsertNode(AVLTreeNode<T>*& root, const T& data, bool& taller);
-*		Helps Insert function by recursively inserting and handling AVL logic
-* void LLRotation(AVLTreeNode<T>*& root);
-*		Performs an LL Rotation on "root"
-* void RRRotation(AVLTreeNode<T>*& root);
-*		Performs an RR Rotation on "root"
-* AVLTreeNode<T>* FindNodeAndDelete(AVLTreeNode<T>*& root, const T& data);
-*		Helps the Delete function by recursively finding a node, deleting it, and rebalancing the AVL tree
-* int GetHeightOfNode(AVLTreeNode<T>* root) const;
-*		Helps Height by recursively calculuating the height of a node "root"
-* int Rebalance(AVLTreeNode<T>*& root);
-*		Helps FindNodeAndDelete by recursively rebalancing the tree
-*
-* Testing helpers:
-* bool IsBalancedNode(AVLTreeNode<T>* root) const;
-*		Returns true if given node is balanced through recursion (Helps IsBalanced)
-* //bool IsHeightBalancedNode(AVLTreeNode<T>* root) const;
-*		Returns true if given node is truely balanced, based on heights, through recursion (Helps IsBalanced)
-*
-* Traversal helpers:
-* void InOrderTraverse(AVLTreeNode<T>* root, void visit(T&));
-*		Helps the InOrder function by recursively traversing and calling visit
-* void PreOrderTraverse(AVLTreeNode<T>* root, void visit(T&));
-*		Helps the PreOrder function by recursively traversing and calling visit
-* void PostOrderTraverse(AVLTreeNode<T>* root, void visit(T&));
-*		Helps the PostOrder function by recursively traversing and calling visit
+* Core helpers:
+* void CopyFrom(const AVLTree<T, Allocator, Options>& rhs, std::true_type);
+*		Helps the copy constructor and assignment, shares the nodes of rhs with
+*		AVL_COPY_ON_WRITE and copies them with CopyTree without it
+* void CopyTree(AVLTreeNode<T, Options>*& root, const AVLTreeNode<T, Options>* copyRoot);
+*		Helps copy constructor by recursively copying data
+* void Purge(AVLTreeNode<T, Options>*& root); //Purge  remove all items from the list.
+*		Helps Purge() function by recursively purging items, then gives every block back
+*		to m_alloc even when root is already empty
+* int PurgeNodes(AVLTreeNode<T, Options>* root);
+*		Destroys and deallocates every node under root and returns how many there were.
+*		Subtrees another tree still shares are only counted and let go of
+* template <typename... Args> AVLTreeNode<T, Options>* CreateNode(Args&&... args);
+*		Constructs a node whose data is built from args in storage from m_alloc
+* AVLTreeNode<T, Options>* CreateNode(const AVLTreeNode<T, Options>& copy);
+*		Constructs a copy of a node in storage from m_alloc
+* template <typename... Args> AVLTreeNode<T, Options>* ConstructNode(void* block, Args&&... args);
+*		Constructs a node from args in block, giving block back to m_alloc if that throws.
+*		The CreateNode functions throw if m_alloc has no block left, TryEmplace returns false
+* void DestroyNode(AVLTreeNode<T, Options>* node);
+*		Destroys a node and gives its storage back to m_alloc
+* template <typename ForwardIt> AVLTreeNode<T, Options>* BuildNode(ForwardIt& current, ForwardIt last, int count);
+*		Helps BuildFromSorted by building a perfectly balanced subtree out of the next count distinct
+*		items (every item without AVL_COUNTED)
+* template <typename ForwardIt> void TakeCopies(AVLTreeNode<T, Options>* node, ForwardIt& current, ForwardIt last, std::true_type);
+*		Moves current past the items equal to node and counts them in node (does nothing without AVL_COUNTED)
+* static int HeightOfCount(int count);
+*		Returns the height of a subtree BuildNode makes out of count items
+*
+* Sharing helpers (AVL_COPY_ON_WRITE only, the std::false_type versions do nothing):
+* void Unshare(AVLTreeNode<T, Options>*& node);
+*		Replaces node with a copy of its own if another tree or parent points at it too.
+*		The copy shares the children, so the parent of node has to be unshared already
+* void UnshareAll(AVLTreeNode<T, Options>*& root, std::true_type);
+*		Unshares every node under root (helps the traversals, which hand out T&)
+* bool ReleaseShared(AVLTreeNode<T, Options>* root, int& count, std::true_type);
+*		If root is shared, counts its subtree into count, lets go of this tree's reference
+*		and returns true, otherwise returns false and leaves root to the caller
+* void ReleaseNode(AVLTreeNode<T, Options>* node);
+*		Lets go of one reference to node, the last one destroys it and lets go of its children
+* static void ShareNode(AVLTreeNode<T, Options>* node);
+*		Adds a reference to node (nullptr is ignored)
+* static int CountNodes(const AVLTreeNode<T, Options>* root);
+*		Returns the number of nodes under root
+*
+* Method helpers:
+* void InsertNode(AVLTreeNode<T, Options>*& root, AVLTreeNode<T, Options>* node, bool& taller);
+*		Helps Insert function by recursively inserting an already built node and handling AVL logic
+* template <typename U> void InsertItem(U&& data, std::true_type);
+*		Helps Insert. Counted trees only build a node when data is new, plain trees always do
+* void LinkNode(AVLTreeNode<T, Options>* node);
+*		Inserts a new node at the root, destroying it if a comparison throws (or, with
+*		AVL_COUNTED, if an equal node already counts it)
+* void AddCopies(AVLTreeNode<T, Options>* node, int copies, std::true_type);
+*		Adds copies to the count of node and fixes its size (does nothing without AVL_COUNTED)
+* int CountCopies(const T& data, std::true_type) const;
+*		Helps Count, reads the count of one node or walks the equal items without AVL_COUNTED
+* template <typename Key, typename Maker> AVLTreeNode<T, Options>* FindOrInsert(const Key& key, Maker& make, bool& inserted);
+*		Returns the node equivalent to key, or links the node make() builds where key belongs.
+*		One walk down either way; make is only called when key is missing. With AVL_COUNTED
+*		finding key counts one more copy of it
+* template <typename Key, typename Maker> AVLTreeNode<T, Options>* FindOrInsertNode(root, const Key& key, Maker& make, bool& taller, bool& inserted);
+*		Helps FindOrInsert by recursively searching, inserting and handling AVL logic
+* void LeftTaller(AVLTreeNode<T, Options>*& root, bool& taller);
+*		Fixes the balance of "root" after its left subtree got taller
+* void RightTaller(AVLTreeNode<T, Options>*& root, bool& taller);
+*		Fixes the balance of "root" after its right subtree got taller
+* void LLRotation(AVLTreeNode<T, Options>*& root);
+*		Performs an LL Rotation on "root"
+* void RRRotation(AVLTreeNode<T, Options>*& root);
+*		Performs an RR Rotation on "root"
+* template <typename Key> void DeleteKey(const Key& key);
+*		Deletes the item equivalent to key (Delete, and AVLMap::Delete without building an item)
+* template <typename Key> bool TryDeleteKey(const Key& key);
+*		Same as DeleteKey, returns false instead of throwing if there is no equivalent item
+* template <typename Key> bool FindNodeAndDelete(AVLTreeNode<T, Options>*& root, const Key& key, bool& shorter);
+*		Helps the Delete function by recursively finding a node, deleting it, and rebalancing on the way back up.
+*		Returns false, with the tree as it was, if there is no equivalent node
+* AVLTreeNode<T, Options>* RemoveMaxNode(AVLTreeNode<T, Options>*& root, bool& shorter);
+*		Unlinks the largest node under "root" and returns it, rebalancing on the way back up
+* void LeftShorter(AVLTreeNode<T, Options>*& root, bool& shorter);
+*		Fixes the balance of "root" after its left subtree got shorter
+* void RightShorter(AVLTreeNode<T, Options>*& root, bool& shorter);
+*		Fixes the balance of "root" after its right subtree got shorter
+* void UpdateSize(AVLTreeNode<T, Options>* root);
+*		Recomputes the subtree size of "root" from its children (does nothing without AVL_ORDER_STATISTICS)
+* static int SizeOfNode(const AVLTreeNode<T, Options>* root);
+*		Returns the subtree size of "root", 0 for nullptr
+* int CountLess(const T& data, bool orEqual) const;
+*		Helps Rank and CountRange by counting the items less than (or equal to) data on one walk down
+* int GetHeightOfNode(AVLTreeNode<T, Options>* root) const;
+*		Recursively calculuates the height of a node "root" (only for checking m_height)
+*
+* Join and split helpers (heights are passed along so nothing is measured twice):
+* AVLTreeNode<T, Options>* JoinNodes(left, int leftHeight, pivot, right, int rightHeight, int& height);
+*		Joins left < pivot < right into one AVL tree in O(|leftHeight - rightHeight|)
+* void JoinRight(root, int rootHeight, pivot, right, int rightHeight, bool& taller);
+*		Helps JoinNodes when the left tree is taller by walking down its right spine
+* void JoinLeft(root, int rootHeight, left, int leftHeight, pivot, bool& taller);
+*		Helps JoinNodes when the right tree is taller by walking down its left spine
+* AVLTreeNode<T, Options>* JoinTwo(left, int leftHeight, right, int rightHeight, int& height);
+*		Joins two trees without a pivot by using the largest node of left as the pivot
+* AVLTreeNode<T, Options>* SplitNode(root, int height, const T& data, left&, int& leftHeight, right&, int& rightHeight);
+*		Splits root into the items less than and greater than data, returns the node equal to data or nullptr
+* AVLTreeNode<T, Options>* UnionNodes(a, int aHeight, b, int bHeight, int& height, int& removed);
+* AVLTreeNode<T, Options>* IntersectNodes(a, int aHeight, b, int bHeight, int& height, int& removed);
+* AVLTreeNode<T, Options>* DifferenceNodes(a, int aHeight, b, int bHeight, int& height, int& removed);
+*		Help the set algebra functions, removed counts the nodes that were destroyed
+* void TakeOver(AVLTree<T, Allocator, Options>& other);
+*		Adopts the storage of other and empties it, its nodes now belong to this tree
+* void TakeAll(AVLTree<T, Allocator, Options>& other);
+*		Helps the moves: swaps allocators with other, whose nodes this tree takes, and empties it.
+*		This tree must hold no nodes, so other gets back storage nothing points into
+*
+* Lookup helpers:
+* template <typename Key> AVLTreeNode<T, Options>* FindNode(const Key& key) const;
+*		Walks down from m_root and returns the first node equivalent to key, or nullptr.
+*		key only has to be comparable with T (AVLMap looks entries up by their key)
+* AVLTreeNode<T, Options>* LowerBoundNode(const T& data) const;
+*		Walks down from m_root and returns the first node that is not less than data, or nullptr
+* AVLTreeNode<T, Options>* UpperBoundNode(const T& data) const;
+*		Walks down from m_root and returns the first node that is greater than data, or nullptr
+* AVLTreeNode<T, Options>* FloorNode(const T& data) const;
+*		Walks down from m_root and returns the last node that is not greater than data, or nullptr
+* AVLTreeNode<T, Options>* PredecessorNode(const T& data) const;
+*		Walks down from m_root and returns the last node that is less than data, or nullptr
+*
+* Testing helpers:
+* bool IsBalancedNode(AVLTreeNode<T, Options>* root) const;
+*		Returns true if given node is balanced through recursion (Helps IsBalanced)
+* //bool IsHeightBalancedNode(AVLTreeNode<T, Options>* root) const;
+*		Returns true if given node is truely balanced, based on heights, through recursion (Helps IsBalanced)
+*
+* Traversal helpers:
+* template <typename Node, typename Visitor> static bool InOrderTraverse(Node* root, Visitor& visit);
+*		Helps the InOrder functions by traversing with a fixed-size stack and calling visit.
+*		Node is const for the const traversals, so visit gets const T& from them
+* template <typename Node, typename Visitor> static bool PreOrderTraverse(Node* root, Visitor& visit);
+*		Helps the PreOrder functions by traversing with a fixed-size stack and calling visit
+* template <typename Node, typename Visitor> static bool PostOrderTraverse(Node* root, Visitor& visit);
+*		Helps the PostOrder functions by traversing with a fixed-size stack and calling visit
+* template <typename Node, typename Visitor> static bool BreadthFirstTraverse(Node* root, Visitor& visit);
+*		Helps the BreadthFirst functions by traversing with a Queue and calling visit
+* template <typename Visitor, typename Data> static bool Visit(Visitor& visit, Data& data);
+*		Calls visit, returns false only when visit returned false
 *
-*************************************************************************/
-template <typename T>
-class AVLTree
-{
-public:
-	AVLTree();
-	AVLTree(const AVLTree<T>& copy);
-	~AVLTree();
-	AVLTree<T>& operator=(const AVLTree<T>& rhs);
-
-	//Methods
-	void Insert(const T& data); //Inserts data into the tree
-	void Delete(const T& data); //Deletes the equivalent data from the tree. Returns if there was equivalent data or not
-	void Purge(); //calls Purge with m_root
-	int Height() const; //returns the height of the tree
-
-	//Testing
-	bool IsEmpty() const; //Returns true if the tree is empty
-	bool IsBalanced() const; //Returns true if all balance factors are between -1 and 1
-	//bool IsHeightBalanced() const;
-	//bool BalanceMatchesHeights(AVLTreeNode<T>* root) const;
-
-	//Traversals
-	void InOrder(void visit(T&));
-	void PreOrder(void visit(T&));
-	void PostOrder(void visit(T&));
-	void BreadthFirst(void visit(T&));
-
-private:
-	//Core helpers
-	void CopyTree(AVLTreeNode<T>*& root, const AVLTreeNode<T>* copyRoot);
-	void Purge(AVLTreeNode<T>*& root); //Purge  remove all items from the list.
-
-	//Method helpers
-	void InsertNode(AVLTreeNode<T>*& root, const T& data, bool& taller);
-	void LLRotation(AVLTreeNode<T>*& root);
-	void RRRotation(AVLTreeNode<T>*& root);
-	AVLTreeNode<T>* FindNodeAndDelete(AVLTreeNode<T>*& root, const T& data);
-	int GetHeightOfNode(AVLTreeNode<T>* root) const;
-	int Rebalance(AVLTreeNode<T>*& root);
-
-	//Testing helpers
-	bool IsBalancedNode(AVLTreeNode<T>* root) const;
-	//bool IsHeightBalancedNode(AVLTreeNode<T>* root) const;
-	
-	//Traversal helpers
-	void InOrderTraverse(AVLTreeNode<T>* root, void visit(T&));
-	void PreOrderTraverse(AVLTreeNode<T>* root, void visit(T&));
-	void PostOrderTraverse(AVLTreeNode<T>* root, void visit(T&));
-
-	AVLTreeNode<T>* m_root;
-};
-
-template<typename T>
-inline AVLTree<T>::AVLTree() : m_root(nullptr)
-{
-}
-
-template<typename T>
-inline AVLTree<T>::AVLTree(const AVLTree<T> & copy) : m_root(nullptr)
-{
-	if (!copy.IsEmpty())
-	{
-		CopyTree(m_root, copy.m_root);
-	}
-}
-
-template<typename T>
-inline AVLTree<T>::~AVLTree()
-{
-	Purge(m_root);
-
-	//Default values
-	m_root = nullptr;
-}
-
-template<typename T>
-inline AVLTree<T>& AVLTree<T>::operator=(const AVLTree<T> & rhs)
-{
-	if (this != &rhs)
-	{
-		Purge(m_root);
-		m_root = nullptr;
-
-		//copy
-		if (!rhs.IsEmpty())
-		{
-			CopyTree(m_root, rhs.m_root);
-		}
-	}
-
-	return *this;
-}
-
-template<typename T>
-inline void AVLTree<T>::Insert(const T & data)
-{
-	bool taller = false;
-	InsertNode(m_root, data, taller);
-}
-
-template<typename T>
-inline void AVLTree<T>::Delete(const T & data)
-{
-	if (IsEmpty())
-		throw Exception("Tried to delete from empty tree");
-
-	m_root = FindNodeAndDelete(m_root, data);
-}
-
-template<typename T>
-inline void AVLTree<T>::Purge()
-{
-	Purge(m_root);
-	m_root = nullptr;
-}
-
-template<typename T>
-inline void AVLTree<T>::Purge(AVLTreeNode<T>*& root)
-{
-	if (root != nullptr)
-	{
-		Purge(root->m_left);
-		Purge(root->m_right);
-		delete root;
-	}
-}
-
-template<typename T>
-inline int AVLTree<T>::Height() const
-{
-	if (IsEmpty())
-		throw Exception("Tried to get height of empty tree");
-
-	return GetHeightOfNode(m_root);
-}
-
-template<typename T>
-inline void AVLTree<T>::InOrder(void visit(T&))
-{
-	InOrderTraverse(m_root, visit);
-}
-
-template<typename T>
-inline void AVLTree<T>::PreOrder(void visit(T&))
-{
-	PreOrderTraverse(m_root, visit);
-}
-
-template<typename T>
-inline void AVLTree<T>::PostOrder(void visit(T&))
-{
-	PostOrderTraverse(m_root, visit);
-}
-
-template<typename T>
-inline void AVLTree<T>::BreadthFirst(void visit(T&))
-{
-	if (!IsEmpty())
-	{
-		Queue<AVLTreeNode<T>*> nodes;
-
-		nodes.Enqueue(m_root);
-
-		while (!nodes.isEmpty())
-		{
-			AVLTreeNode<T>* current = nodes.Dequeue();
-
-			if (current->m_left != nullptr)
-				nodes.Enqueue(current->m_left);
-			if (current->m_right != nullptr)
-				nodes.Enqueue(current->m_right);
-		}
-	}
-}
-
-template<typename T>
-inline bool AVLTree<T>::IsEmpty() const
-{
-	return m_root == nullptr;
-}
-
-template<typename T>
-inline bool AVLTree<T>::IsBalanced() const
-{
-	return IsBalancedNode(m_root);
-}
-
-//template<typename T>
-//inline bool AVLTree<T>::IsHeightBalanced() const
-//{
-//	return IsHeightBalancedNode(m_root);
-//}
-
-//template<typename T>
-//inline bool AVLTree<T>::BalanceMatchesHeights(AVLTreeNode<T>* root) const
-//{
-//	int LH = GetHeightOfNode(root->m_left);
-//	int RH = GetHeightOfNode(root->m_right);
-//	return (LH - RH == root->m_balance);
-//}
-
-template<typename T>
-inline void AVLTree<T>::CopyTree(AVLTreeNode<T>*& root, const AVLTreeNode<T>* copyRoot)
-{
-	if (copyRoot != nullptr)
-	{
-		root = new AVLTreeNode<T>(*copyRoot);
-		CopyTree(root->m_left, copyRoot->m_left);
-		CopyTree(root->m_right, copyRoot->m_right);
-	}
-}
-
-template<typename T>
-inline void AVLTree<T>::InsertNode(AVLTreeNode<T>*& root, const T & data, bool& taller)
-{
-	if (root == nullptr)
-	{
-		root = new AVLTreeNode<T>(data);
-		taller = true;
-	}
-	else if (data < root->m_data)
-	{
-		InsertNode(root->m_left, data, taller);
-		if (taller)
-		{
-			switch (root->m_balance)
-			{
-			case AVLTreeNode<T>::BALANCE::LH:
-				if (data >= root->m_left->m_data) //Checks LR
-				{
-					++(root->m_left->m_balance);
-					RRRotation(root->m_left);	
-				}
-				//else
-				LLRotation(root);
-				taller = false;
-
-				break;
-			case AVLTreeNode<T>::BALANCE::EH:
-				root->m_balance = AVLTreeNode<T>::BALANCE::LH;
-
-				break;
-			case AVLTreeNode<T>::BALANCE::RH:
-				root->m_balance = AVLTreeNode<T>::BALANCE::EH;
-				taller = false;
-
-				break;
-			}
-		}
-	}
-	else
-	{
-		InsertNode(root->m_right, data, taller);
-		if (taller)
-		{
-			switch (root->m_balance)
-			{
-			case AVLTreeNode<T>::BALANCE::LH:
-				root->m_balance = AVLTreeNode<T>::BALANCE::EH;
-				taller = false;
-
-				break;
-			case AVLTreeNode<T>::BALANCE::EH:
-				root->m_balance = AVLTreeNode<T>::BALANCE::RH;
-
-				break;
-			case AVLTreeNode<T>::BALANCE::RH:
-				if (data < root->m_right->m_data) //Checks RL
-				{
-					--(root->m_right->m_balance);
-					LLRotation(root->m_right);
-				}
-				//else
-				RRRotation(root);
-				taller = false;
-
-				break;
-			}
-		}
-	}
-}
-
-template<typename T>
-inline void AVLTree<T>::LLRotation(AVLTreeNode<T>*& root)
-{
-	AVLTreeNode<T>* left = root->m_left;
-	AVLTreeNode<T>* leftRight = left->m_right;
-
-	++(root->m_balance);
-	root->m_balance = root->m_balance - 1 - max(left->m_balance, 0);
-	left->m_balance = left->m_balance - 1 + min(root->m_balance, 0);
-
-	left->m_right = root;
-	root->m_left = leftRight;
-
-	root = left;
-}
-
-template<typename T>
-inline void AVLTree<T>::RRRotation(AVLTreeNode<T>*& root)
-{
-	AVLTreeNode<T>* right = root->m_right;
-	AVLTreeNode<T>* rightLeft = right->m_left;
-	
-	--(root->m_balance);
-	root->m_balance = root->m_balance + 1 - min(right->m_balance, 0);
-	right->m_balance = right->m_balance + 1 + max(root->m_balance, 0);
-
-	right->m_left = root;
-	root->m_right = rightLeft;
-
-	root = right;
-}
-
-template<typename T>
-inline AVLTreeNode<T>* AVLTree<T>::FindNodeAndDelete(AVLTreeNode<T>*& root, const T & data)
-{
-	if (root == nullptr)
-		throw Exception("Could not find item to delete from tree");
-
-	if (data < root->m_data)
-	{
-		//data smaller, go left and set m_left to whatever the next node will be
-		FindNodeAndDelete(root->m_left, data);
-		return root;
-	}
-	else if (data > root->m_data)
-	{
-		FindNodeAndDelete(root->m_right, data);
-		return root;
-	}
-	else
-	{
-		//this is the node to delete, delete -> fix -> return this node to fix reference
-		//For AVL, delete node, then rebalance
-		if (root->m_left == nullptr && root->m_right == nullptr) //empty
-		{
-			delete root;
-			root = nullptr;
-
-			//Node is deleted, rebalance
-			Rebalance(m_root);
-
-			return root;
-		}
-		else if (root->m_left == nullptr) //right only
-		{
-			AVLTreeNode<T>* temp = root->m_right;
-			delete root;
-			root = temp;
-
-			//Node is deleted, rebalance
-			Rebalance(m_root);
-
-			return temp;
-		}
-		else if (root->m_right == nullptr) //left only
-		{
-			AVLTreeNode<T>* temp = root->m_left;
-			delete root;
-			root = temp;
-
-			//Node is deleted, rebalance
-			Rebalance(m_root);
-
-			return temp;
-		}
-		else //both
-		{
-			AVLTreeNode<T>* current = root->m_left;
-			AVLTreeNode<T>* previous = nullptr;
-
-			while (current->m_right != nullptr)
-			{
-				previous = current;
-				current = current->m_right;
-			}
-
-			root->m_data = current->m_data;
-
-			if (previous == nullptr)
-				root->m_left = current->m_left;
-			else
-				previous->m_right = current->m_left;
-
-			delete current;
-
-			//Node is deleted, rebalance
-			Rebalance(m_root);
-
-			return root;
-		}
-		
-	}
-}
-
-template<typename T>
-inline int AVLTree<T>::GetHeightOfNode(AVLTreeNode<T>* root) const
-{
-	if (root == nullptr)
-		return 0;
-
-	int leftHeight = GetHeightOfNode(root->m_left);
-	int rightHeight = GetHeightOfNode(root->m_right);
-	if (leftHeight > rightHeight)
-		return leftHeight + 1;
-	//else
-	return rightHeight + 1;
-}
-
-template<typename T>
-inline int AVLTree<T>::Rebalance(AVLTreeNode<T>*& root)
-{
-	if (root != nullptr)
-	{
-		int LH = Rebalance(root->m_left);
-		int RH = Rebalance(root->m_right);
-		root->m_balance = LH - RH;
-
-		//Rotate if balance is more than LH or less than RH
-		if (root->m_balance > AVLTreeNode<T>::BALANCE::LH) //LL or LR
-		{
-			LLRotation(root);
-			Rebalance(m_root);
-		}
-		else if (root->m_balance < AVLTreeNode<T>::BALANCE::RH) //RR or RL
-		{
-			RRRotation(root);
-			Rebalance(m_root);
-		}
-
-		return (1 + max(LH, RH));
-	}
-
-	return 0;
-}
-
-template<typename T>
-inline bool AVLTree<T>::IsBalancedNode(AVLTreeNode<T>* root) const
-{
-	if (root != nullptr)
-	{
-		return (IsBalancedNode(root->m_left) &&
-			root->m_balance >= -1 && root->m_balance <= 1 &&
-			IsBalancedNode(root->m_right));
-	}
-	return true;
-}
-
-//template<typename T>
-//inline bool AVLTree<T>::IsHeightBalancedNode(AVLTreeNode<T>* root) const
-//{
-//	if (root != nullptr)
-//	{
-//		int leftHeight = GetHeightOfNode(root->m_left);
-//		int rightHeight = GetHeightOfNode(root->m_right);
-//		return (IsHeightBalancedNode(root->m_left) &&
-//			leftHeight - rightHeight >= -1 && leftHeight - rightHeight <= 1 &&
-//			IsHeightBalancedNode(root->m_right));
-//	}
-//	return true;
-//}
-
-template<typename T>
-inline void AVLTree<T>::InOrderTraverse(AVLTreeNode<T>* root, void visit(T&))
-{
-	if (root != nullptr)
-	{
-		InOrderTraverse(root->m_left, visit);
-		visit(root->m_data);
-		InOrderTraverse(root->m_right, visit);
-	}
-}
-
-template<typename T>
-inline void AVLTree<T>::PreOrderTraverse(AVLTreeNode<T>* root, void visit(T&))
-{
-	if (root != nullptr)
-	{
-		visit(root->m_data);
-		PreOrderTraverse(root->m_left, visit);
-		PreOrderTraverse(root->m_right, visit);
-	}
-}
-
-template<typename T>
-inline void AVLTree<T>::PostOrderTraverse(AVLTreeNode<T>* root, void visit(T&))
-{
-	if (root != nullptr)
-	{
-		PostOrderTraverse(root->m_left, visit);
-		PostOrderTraverse(root->m_right, visit);
-		visit(root->m_data);
-	}
-}
+*************************************************************************/
+template <typename T, template <typename> class Allocator = ArenaAllocator, unsigned Options = AVL_PLAIN>
+class AVLTree
+{
+	template <typename K, typename V, template <typename> class A, unsigned O>
+	friend class AVLMap;
+	template <typename U, int N>
+	friend class FixedAVLTree;
+
+public:
+	AVLTree();
+	AVLTree(const AVLTree<T, Allocator, Options>& copy);
+	AVLTree(AVLTree<T, Allocator, Options>&& other);
+	template <typename ForwardIt> AVLTree(ForwardIt first, ForwardIt last);
+	~AVLTree();
+	AVLTree<T, Allocator, Options>& operator=(const AVLTree<T, Allocator, Options>& rhs);
+	AVLTree<T, Allocator, Options>& operator=(AVLTree<T, Allocator, Options>&& rhs);
+
+	//Methods
+	void Insert(const T& data); //Inserts data into the tree
+	void Insert(T&& data); //Inserts data into the tree, moving it into the node
+	template <typename... Args> void Emplace(Args&&... args); //Inserts an item constructed in place from args
+	bool TryInsert(const T& data); //Inserts data into the tree, false if the allocator is out of storage
+	bool TryInsert(T&& data); //Inserts data into the tree, moving it into the node
+	template <typename... Args> bool TryEmplace(Args&&... args); //Inserts an item built from args, false if out of storage
+	void Delete(const T& data); //Deletes the equivalent data from the tree. Returns if there was equivalent data or not
+	bool TryDelete(const T& data); //Deletes the equivalent data from the tree, false if there is none
+	void Purge(); //calls Purge with m_root
+	template <typename ForwardIt> void BuildFromSorted(ForwardIt first, ForwardIt last); //Replaces the contents with a sorted range in O(n)
+	FrozenAVLTree<T> Freeze(FROZEN_LAYOUT layout = FROZEN_EYTZINGER) const; //Returns a pointer-free read only copy
+	int Height() const; //returns the height of the tree
+	int Size() const; //returns the number of items in the tree
+
+	//Order statistics (AVL_ORDER_STATISTICS only)
+	const T& Select(int k) const; //Returns the k-th smallest item, counting from 0
+	const T& At(int k) const; //Same as Select
+	int Rank(const T& data) const; //Returns how many items are less than data
+	int CountRange(const T& low, const T& high) const; //Returns how many items are in [low, high]
+
+	//Set algebra (other is left empty, its nodes are moved into this tree)
+	void Union(AVLTree<T, Allocator, Options>& other);
+	void Intersection(AVLTree<T, Allocator, Options>& other);
+	void Difference(AVLTree<T, Allocator, Options>& other);
+	void Join(const T& pivot, AVLTree<T, Allocator, Options>& right);
+
+	//Iterators
+	typedef AVLTreeIterator<T, Options> iterator;
+	typedef AVLTreeIterator<T, Options> const_iterator;
+	typedef AVLTreeReverseIterator<T, Options> reverse_iterator;
+	typedef AVLTreeReverseIterator<T, Options> const_reverse_iterator;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_reverse_iterator rbegin() const;
+	const_reverse_iterator rend() const;
+
+	//Lookups
+	bool Contains(const T& data) const; //Returns true if equivalent data is in the tree
+	int Count(const T& data) const; //Returns how many equivalent items the tree holds
+	const T* Find(const T& data) const; //Returns the stored equivalent data, or nullptr
+	const_iterator LowerBound(const T& data) const; //First item >= data, or end()
+	const_iterator UpperBound(const T& data) const; //First item > data, or end()
+	const T* Floor(const T& data) const; //Largest item <= data, or nullptr
+	const T* Ceiling(const T& data) const; //Smallest item >= data, or nullptr
+	const T* Predecessor(const T& data) const; //Largest item < data, or nullptr
+	const T* Successor(const T& data) const; //Smallest item > data, or nullptr
+
+	//Testing
+	bool IsEmpty() const; //Returns true if the tree is empty
+	bool IsBalanced() const; //Returns true if all balance factors are between -1 and 1
+	//bool IsHeightBalanced() const;
+	//bool BalanceMatchesHeights(AVLTreeNode<T, Options>* root) const;
+
+	//Traversals
+	void InOrder(void visit(T&));
+	void PreOrder(void visit(T&));
+	void PostOrder(void visit(T&));
+	void BreadthFirst(void visit(T&));
+	template <typename Visitor> bool InOrder(Visitor visit);
+	template <typename Visitor> bool PreOrder(Visitor visit);
+	template <typename Visitor> bool PostOrder(Visitor visit);
+	template <typename Visitor> bool BreadthFirst(Visitor visit);
+	void InOrder(void visit(const T&)) const;
+	void PreOrder(void visit(const T&)) const;
+	void PostOrder(void visit(const T&)) const;
+	void BreadthFirst(void visit(const T&)) const;
+	template <typename Visitor> bool InOrder(Visitor visit) const;
+	template <typename Visitor> bool PreOrder(Visitor visit) const;
+	template <typename Visitor> bool PostOrder(Visitor visit) const;
+	template <typename Visitor> bool BreadthFirst(Visitor visit) const;
+
+private:
+	//Core helpers
+	void CopyFrom(const AVLTree<T, Allocator, Options>& rhs, std::true_type);
+	void CopyFrom(const AVLTree<T, Allocator, Options>& rhs, std::false_type);
+	void CopyTree(AVLTreeNode<T, Options>*& root, const AVLTreeNode<T, Options>* copyRoot);
+	void Purge(AVLTreeNode<T, Options>*& root); //Purge  remove all items from the list.
+	int PurgeNodes(AVLTreeNode<T, Options>* root);
+	template <typename... Args> AVLTreeNode<T, Options>* CreateNode(Args&&... args);
+	AVLTreeNode<T, Options>* CreateNode(const AVLTreeNode<T, Options>& copy);
+	template <typename... Args> AVLTreeNode<T, Options>* ConstructNode(void* block, Args&&... args);
+	void DestroyNode(AVLTreeNode<T, Options>* node);
+	template <typename ForwardIt> AVLTreeNode<T, Options>* BuildNode(ForwardIt& current, ForwardIt last, int count);
+	template <typename ForwardIt> void TakeCopies(AVLTreeNode<T, Options>* node, ForwardIt& current, ForwardIt last, std::true_type);
+	template <typename ForwardIt> void TakeCopies(AVLTreeNode<T, Options>* node, ForwardIt& current, ForwardIt last, std::false_type);
+	static int HeightOfCount(int count);
+
+	//Sharing helpers
+	void Unshare(AVLTreeNode<T, Options>*& node);
+	void Unshare(AVLTreeNode<T, Options>*& node, std::true_type);
+	void Unshare(AVLTreeNode<T, Options>*& node, std::false_type);
+	void UnshareAll(AVLTreeNode<T, Options>*& root, std::true_type);
+	void UnshareAll(AVLTreeNode<T, Options>*& root, std::false_type);
+	bool ReleaseShared(AVLTreeNode<T, Options>* root, int& count, std::true_type);
+	bool ReleaseShared(AVLTreeNode<T, Options>* root, int& count, std::false_type);
+	void ReleaseNode(AVLTreeNode<T, Options>* node);
+	static void ShareNode(AVLTreeNode<T, Options>* node);
+	static int CountNodes(const AVLTreeNode<T, Options>* root);
+
+	//Method helpers
+	void InsertNode(AVLTreeNode<T, Options>*& root, AVLTreeNode<T, Options>* node, bool& taller);
+	template <typename U> void InsertItem(U&& data, std::true_type);
+	template <typename U> void InsertItem(U&& data, std::false_type);
+	void LinkNode(AVLTreeNode<T, Options>* node);
+	void LinkNode(AVLTreeNode<T, Options>* node, std::true_type);
+	void LinkNode(AVLTreeNode<T, Options>* node, std::false_type);
+	void AddCopies(AVLTreeNode<T, Options>* node, int copies, std::true_type);
+	void AddCopies(AVLTreeNode<T, Options>* node, int copies, std::false_type);
+	int CountCopies(const T& data, std::true_type) const;
+	int CountCopies(const T& data, std::false_type) const;
+	template <typename Key, typename Maker> AVLTreeNode<T, Options>* FindOrInsert(const Key& key, Maker& make, bool& inserted);
+	template <typename Key, typename Maker> AVLTreeNode<T, Options>* FindOrInsertNode(AVLTreeNode<T, Options>*& root, const Key& key,
+		Maker& make, bool& taller, bool& inserted);
+	void LeftTaller(AVLTreeNode<T, Options>*& root, bool& taller);
+	void RightTaller(AVLTreeNode<T, Options>*& root, bool& taller);
+	void LLRotation(AVLTreeNode<T, Options>*& root);
+	void RRRotation(AVLTreeNode<T, Options>*& root);
+	template <typename Key> void DeleteKey(const Key& key);
+	template <typename Key> bool TryDeleteKey(const Key& key);
+	template <typename Key> bool FindNodeAndDelete(AVLTreeNode<T, Options>*& root, const Key& key, bool& shorter);
+	AVLTreeNode<T, Options>* RemoveMaxNode(AVLTreeNode<T, Options>*& root, bool& shorter);
+	void LeftShorter(AVLTreeNode<T, Options>*& root, bool& shorter);
+	void RightShorter(AVLTreeNode<T, Options>*& root, bool& shorter);
+	void UpdateSize(AVLTreeNode<T, Options>* root);
+	void UpdateSize(AVLTreeNode<T, Options>* root, std::true_type);
+	void UpdateSize(AVLTreeNode<T, Options>* root, std::false_type);
+	static int SizeOfNode(const AVLTreeNode<T, Options>* root);
+	int CountLess(const T& data, bool orEqual) const;
+	int GetHeightOfNode(AVLTreeNode<T, Options>* root) const;
+
+	//Join and split helpers
+	AVLTreeNode<T, Options>* JoinNodes(AVLTreeNode<T, Options>* left, int leftHeight, AVLTreeNode<T, Options>* pivot,
+		AVLTreeNode<T, Options>* right, int rightHeight, int& height);
+	void JoinRight(AVLTreeNode<T, Options>*& root, int rootHeight, AVLTreeNode<T, Options>* pivot,
+		AVLTreeNode<T, Options>* right, int rightHeight, bool& taller);
+	void JoinLeft(AVLTreeNode<T, Options>*& root, int rootHeight, AVLTreeNode<T, Options>* left, int leftHeight,
+		AVLTreeNode<T, Options>* pivot, bool& taller);
+	AVLTreeNode<T, Options>* JoinTwo(AVLTreeNode<T, Options>* left, int leftHeight,
+		AVLTreeNode<T, Options>* right, int rightHeight, int& height);
+	AVLTreeNode<T, Options>* SplitNode(AVLTreeNode<T, Options>* root, int height, const T& data,
+		AVLTreeNode<T, Options>*& left, int& leftHeight, AVLTreeNode<T, Options>*& right, int& rightHeight);
+	AVLTreeNode<T, Options>* UnionNodes(AVLTreeNode<T, Options>* a, int aHeight,
+		AVLTreeNode<T, Options>* b, int bHeight, int& height, int& removed);
+	AVLTreeNode<T, Options>* IntersectNodes(AVLTreeNode<T, Options>* a, int aHeight,
+		AVLTreeNode<T, Options>* b, int bHeight, int& height, int& removed);
+	AVLTreeNode<T, Options>* DifferenceNodes(AVLTreeNode<T, Options>* a, int aHeight,
+		AVLTreeNode<T, Options>* b, int bHeight, int& height, int& removed);
+	void TakeOver(AVLTree<T, Allocator, Options>& other);
+	void TakeAll(AVLTree<T, Allocator, Options>& other);
+
+	//Lookup helpers
+	template <typename Key> AVLTreeNode<T, Options>* FindNode(const Key& key) const;
+	AVLTreeNode<T, Options>* LowerBoundNode(const T& data) const;
+	AVLTreeNode<T, Options>* UpperBoundNode(const T& data) const;
+	AVLTreeNode<T, Options>* FloorNode(const T& data) const;
+	AVLTreeNode<T, Options>* PredecessorNode(const T& data) const;
+
+	//Testing helpers
+	bool IsBalancedNode(AVLTreeNode<T, Options>* root) const;
+	//bool IsHeightBalancedNode(AVLTreeNode<T, Options>* root) const;
+	
+	//Traversal helpers
+	template <typename Node, typename Visitor> static bool InOrderTraverse(Node* root, Visitor& visit);
+	template <typename Node, typename Visitor> static bool PreOrderTraverse(Node* root, Visitor& visit);
+	template <typename Node, typename Visitor> static bool PostOrderTraverse(Node* root, Visitor& visit);
+	template <typename Node, typename Visitor> static bool BreadthFirstTraverse(Node* root, Visitor& visit);
+	template <typename Visitor, typename Data> static bool Visit(Visitor& visit, Data& data);
+	template <typename Visitor, typename Data> static bool Visit(Visitor& visit, Data& data, std::true_type);
+	template <typename Visitor, typename Data> static bool Visit(Visitor& visit, Data& data, std::false_type);
+
+	static const bool ORDER_STATISTICS = (Options & AVL_ORDER_STATISTICS) != 0;
+	static const bool COUNTED = (Options & AVL_COUNTED) != 0;
+	static const bool COPY_ON_WRITE = (Options & AVL_COPY_ON_WRITE) != 0;
+
+	static_assert(!COPY_ON_WRITE || !Allocator<AVLTreeNode<T, Options>>::RELEASES_ALL,
+		"AVL_COPY_ON_WRITE trees share nodes, they need an allocator that frees nodes one by one such as HeapAllocator");
+
+	AVLTreeNode<T, Options>* m_root;
+	int m_numElements;
+	int m_height; //taller/shorter at the root tell Insert and Delete when this changes
+	Allocator<AVLTreeNode<T, Options>> m_alloc;
+};
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTree<T, Allocator, Options>::AVLTree() : m_root(nullptr), m_numElements(0), m_height(0)
+{
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTree<T, Allocator, Options>::AVLTree(const AVLTree<T, Allocator, Options> & copy) : m_root(nullptr), m_numElements(0), m_height(0)
+{
+	CopyFrom(copy, std::integral_constant<bool, COPY_ON_WRITE>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTree<T, Allocator, Options>::AVLTree(AVLTree<T, Allocator, Options> && other) : m_root(other.m_root), m_numElements(other.m_numElements), m_height(other.m_height)
+{
+	TakeAll(other);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename ForwardIt>
+inline AVLTree<T, Allocator, Options>::AVLTree(ForwardIt first, ForwardIt last) : m_root(nullptr), m_numElements(0), m_height(0)
+{
+	BuildFromSorted(first, last);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTree<T, Allocator, Options>::~AVLTree()
+{
+	Purge(m_root);
+
+	//Default values
+	m_root = nullptr;
+	m_numElements = 0;
+	m_height = 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTree<T, Allocator, Options>& AVLTree<T, Allocator, Options>::operator=(const AVLTree<T, Allocator, Options> & rhs)
+{
+	if (this != &rhs)
+	{
+		Purge(m_root);
+		m_root = nullptr;
+		m_numElements = 0;
+		m_height = 0;
+
+		//copy
+		CopyFrom(rhs, std::integral_constant<bool, COPY_ON_WRITE>());
+	}
+
+	return *this;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTree<T, Allocator, Options>& AVLTree<T, Allocator, Options>::operator=(AVLTree<T, Allocator, Options> && rhs)
+{
+	if (this != &rhs)
+	{
+		Purge(m_root);
+
+		//move
+		m_root = rhs.m_root;
+		m_numElements = rhs.m_numElements;
+		m_height = rhs.m_height;
+		TakeAll(rhs);
+	}
+
+	return *this;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Insert(const T & data)
+{
+	InsertItem(data, std::integral_constant<bool, COUNTED>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Insert(T && data)
+{
+	InsertItem(std::move(data), std::integral_constant<bool, COUNTED>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename... Args>
+inline void AVLTree<T, Allocator, Options>::Emplace(Args&&... args)
+{
+	LinkNode(CreateNode(std::forward<Args>(args)...));
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::TryInsert(const T & data)
+{
+	return TryEmplace(data);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::TryInsert(T && data)
+{
+	return TryEmplace(std::move(data));
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename... Args>
+inline bool AVLTree<T, Allocator, Options>::TryEmplace(Args&&... args)
+{
+	void* block = m_alloc.Allocate();
+
+	if (block == nullptr)
+		return false;
+
+	LinkNode(ConstructNode(block, std::forward<Args>(args)...));
+
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Delete(const T & data)
+{
+	DeleteKey(data);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::TryDelete(const T & data)
+{
+	return TryDeleteKey(data);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Key>
+inline void AVLTree<T, Allocator, Options>::DeleteKey(const Key & key)
+{
+	if (IsEmpty())
+		throw Exception("Tried to delete from empty tree");
+
+	if (!TryDeleteKey(key))
+		throw Exception("Could not find item to delete from tree");
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Key>
+inline bool AVLTree<T, Allocator, Options>::TryDeleteKey(const Key & key)
+{
+	bool shorter = false;
+	if (!FindNodeAndDelete(m_root, key, shorter))
+		return false;
+
+	--m_numElements;
+
+	if (shorter)
+		--m_height;
+
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Purge()
+{
+	Purge(m_root);
+	m_root = nullptr;
+	m_numElements = 0;
+	m_height = 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Purge(AVLTreeNode<T, Options>*& root)
+{
+	//An arena can drop every node at once when there are no destructors to run
+	if (root != nullptr && !(Allocator<AVLTreeNode<T, Options>>::RELEASES_ALL && std::is_trivially_destructible<T>::value))
+		PurgeNodes(root);
+
+	//a tree emptied by Delete still holds its chunks, so they are given back either way
+	m_alloc.Release();
+	root = nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::PurgeNodes(AVLTreeNode<T, Options>* root)
+{
+	int count = 0;
+
+	if (root != nullptr && !ReleaseShared(root, count, std::integral_constant<bool, COPY_ON_WRITE>()))
+	{
+		count += PurgeNodes(root->m_left);
+		count += PurgeNodes(root->m_right);
+		DestroyNode(root);
+		++count;
+	}
+
+	return count;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename... Args>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::CreateNode(Args&&... args)
+{
+	void* block = m_alloc.Allocate();
+
+	if (block == nullptr)
+		throw Exception("Tree storage is full");
+
+	return ConstructNode(block, std::forward<Args>(args)...);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename... Args>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::ConstructNode(void* block, Args&&... args)
+{
+	try
+	{
+		return new (block) AVLTreeNode<T, Options>(typename AVLTreeNode<T, Options>::InPlace(), std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		m_alloc.Deallocate(block);
+		throw;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::CreateNode(const AVLTreeNode<T, Options>& copy)
+{
+	void* block = m_alloc.Allocate();
+
+	if (block == nullptr)
+		throw Exception("Tree storage is full");
+
+	try
+	{
+		return new (block) AVLTreeNode<T, Options>(copy);
+	}
+	catch (...)
+	{
+		m_alloc.Deallocate(block);
+		throw;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename ForwardIt>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::BuildNode(ForwardIt& current, ForwardIt last, int count)
+{
+	if (count == 0)
+		return nullptr;
+
+	//the right side gets the extra item, so every node is EH or RH
+	int leftCount = (count - 1) / 2;
+	int rightCount = count - 1 - leftCount;
+
+	AVLTreeNode<T, Options>* left = BuildNode(current, last, leftCount);
+	AVLTreeNode<T, Options>* root = CreateNode(*current);
+	++current;
+	TakeCopies(root, current, last, std::integral_constant<bool, COUNTED>());
+
+	root->m_left = left;
+	root->m_right = BuildNode(current, last, rightCount);
+	root->m_balance = HeightOfCount(leftCount) - HeightOfCount(rightCount);
+	UpdateSize(root);
+
+	return root;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename ForwardIt>
+inline void AVLTree<T, Allocator, Options>::TakeCopies(AVLTreeNode<T, Options>* node, ForwardIt& current, ForwardIt last, std::true_type)
+{
+	while (current != last && !(node->m_data < *current))
+	{
+		++(node->m_count);
+		++current;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename ForwardIt>
+inline void AVLTree<T, Allocator, Options>::TakeCopies(AVLTreeNode<T, Options>*, ForwardIt&, ForwardIt, std::false_type)
+{
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::HeightOfCount(int count)
+{
+	//a subtree split evenly at every level is as tall as count has bits
+	int height = 0;
+
+	while (count > 0)
+	{
+		++height;
+		count >>= 1;
+	}
+
+	return height;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Unshare(AVLTreeNode<T, Options>*& node)
+{
+	Unshare(node, std::integral_constant<bool, COPY_ON_WRITE>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Unshare(AVLTreeNode<T, Options>*& node, std::true_type)
+{
+	if (node == nullptr || node->m_refs.load(std::memory_order_acquire) == 1)
+		return;
+
+	//another tree points here too, give this one its own copy. The const
+	//reference picks the copying CreateNode over the one that builds a T
+	const AVLTreeNode<T, Options>& original = *node;
+	AVLTreeNode<T, Options>* copy = CreateNode(original);
+	copy->m_left = node->m_left;
+	copy->m_right = node->m_right;
+	ShareNode(copy->m_left);
+	ShareNode(copy->m_right);
+
+	ReleaseNode(node);
+	node = copy;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Unshare(AVLTreeNode<T, Options>*&, std::false_type)
+{
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::UnshareAll(AVLTreeNode<T, Options>*& root, std::true_type)
+{
+	if (root != nullptr)
+	{
+		Unshare(root);
+		UnshareAll(root->m_left, std::true_type());
+		UnshareAll(root->m_right, std::true_type());
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::UnshareAll(AVLTreeNode<T, Options>*&, std::false_type)
+{
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::ReleaseShared(AVLTreeNode<T, Options>* root, int& count, std::true_type)
+{
+	if (root->m_refs.load(std::memory_order_acquire) == 1)
+		return false;
+
+	//count while this tree still holds its reference, the other trees may free the nodes right after
+	count = CountNodes(root);
+	ReleaseNode(root);
+
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::ReleaseShared(AVLTreeNode<T, Options>*, int&, std::false_type)
+{
+	return false;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::ReleaseNode(AVLTreeNode<T, Options>* node)
+{
+	if (node != nullptr && node->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		ReleaseNode(node->m_left);
+		ReleaseNode(node->m_right);
+		DestroyNode(node);
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::ShareNode(AVLTreeNode<T, Options>* node)
+{
+	if (node != nullptr)
+		node->m_refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::CountNodes(const AVLTreeNode<T, Options>* root)
+{
+	return root != nullptr ? CountNodes(root->m_left) + 1 + CountNodes(root->m_right) : 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::DestroyNode(AVLTreeNode<T, Options>* node)
+{
+	node->~AVLTreeNode();
+	m_alloc.Deallocate(node);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename ForwardIt>
+inline void AVLTree<T, Allocator, Options>::BuildFromSorted(ForwardIt first, ForwardIt last)
+{
+	//check the order first so a bad range leaves the tree alone
+	int count = 0;
+	int nodes = 0; //runs of equal items share a node with AVL_COUNTED
+	for (ForwardIt current = first; current != last; ++current)
+	{
+		ForwardIt next = current;
+		++next;
+
+		if (next != last && *next < *current)
+			throw Exception("Tried to build a tree from unsorted data");
+
+		if (!COUNTED || next == last || *current < *next)
+			++nodes;
+
+		++count;
+	}
+
+	Purge();
+
+	//every node of the build comes out of one reservation
+	m_alloc.Reserve(nodes);
+	m_root = BuildNode(first, last, nodes);
+	m_numElements = count;
+	m_height = HeightOfCount(nodes);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline FrozenAVLTree<T> AVLTree<T, Allocator, Options>::Freeze(FROZEN_LAYOUT layout) const
+{
+	return FrozenAVLTree<T>(begin(), end(), layout);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::Height() const
+{
+	if (IsEmpty())
+		throw Exception("Tried to get height of empty tree");
+
+	return m_height;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::Size() const
+{
+	return m_numElements;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline const T& AVLTree<T, Allocator, Options>::Select(int k) const
+{
+	static_assert(ORDER_STATISTICS, "Select needs an AVLTree with AVL_ORDER_STATISTICS");
+
+	if (k < 0 || k >= m_numElements)
+		throw Exception("Tried to select outside of the tree");
+
+	AVLTreeNode<T, Options>* current = m_root;
+
+	while (true)
+	{
+		int leftSize = SizeOfNode(current->m_left);
+
+		if (k < leftSize)
+		{
+			current = current->m_left;
+		}
+		else if (k < leftSize + current->CopyCount())
+		{
+			return current->m_data;
+		}
+		else
+		{
+			k -= leftSize + current->CopyCount();
+			current = current->m_right;
+		}
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline const T& AVLTree<T, Allocator, Options>::At(int k) const
+{
+	return Select(k);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::Rank(const T & data) const
+{
+	static_assert(ORDER_STATISTICS, "Rank needs an AVLTree with AVL_ORDER_STATISTICS");
+
+	return CountLess(data, false);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::CountRange(const T & low, const T & high) const
+{
+	static_assert(ORDER_STATISTICS, "CountRange needs an AVLTree with AVL_ORDER_STATISTICS");
+
+	if (high < low)
+		return 0;
+
+	return CountLess(high, true) - CountLess(low, false);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Union(AVLTree<T, Allocator, Options> & other)
+{
+	static_assert(!COUNTED, "Union needs an AVLTree without AVL_COUNTED");
+
+	if (this == &other)
+		return;
+
+	int total = m_numElements + other.m_numElements;
+	AVLTreeNode<T, Options>* b = other.m_root;
+	int bHeight = other.m_height;
+	int removed = 0;
+
+	TakeOver(other);
+	m_root = UnionNodes(m_root, m_height, b, bHeight, m_height, removed);
+	m_numElements = total - removed;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Intersection(AVLTree<T, Allocator, Options> & other)
+{
+	static_assert(!COUNTED, "Intersection needs an AVLTree without AVL_COUNTED");
+
+	if (this == &other)
+		return;
+
+	int total = m_numElements + other.m_numElements;
+	AVLTreeNode<T, Options>* b = other.m_root;
+	int bHeight = other.m_height;
+	int removed = 0;
+
+	TakeOver(other);
+	m_root = IntersectNodes(m_root, m_height, b, bHeight, m_height, removed);
+	m_numElements = total - removed;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Difference(AVLTree<T, Allocator, Options> & other)
+{
+	static_assert(!COUNTED, "Difference needs an AVLTree without AVL_COUNTED");
+
+	if (this == &other)
+	{
+		Purge();
+		return;
+	}
+
+	int total = m_numElements + other.m_numElements;
+	AVLTreeNode<T, Options>* b = other.m_root;
+	int bHeight = other.m_height;
+	int removed = 0;
+
+	TakeOver(other);
+	m_root = DifferenceNodes(m_root, m_height, b, bHeight, m_height, removed);
+	m_numElements = total - removed;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::Join(const T & pivot, AVLTree<T, Allocator, Options> & right)
+{
+	static_assert(!COUNTED, "Join needs an AVLTree without AVL_COUNTED");
+
+	if (this == &right)
+		throw Exception("Tried to join a tree with itself");
+
+	if ((!IsEmpty() && pivot < *rbegin()) || (!right.IsEmpty() && *right.begin() < pivot))
+		throw Exception("Tried to join trees that are out of order");
+
+	int total = m_numElements + right.m_numElements + 1;
+	AVLTreeNode<T, Options>* middle = CreateNode(pivot);
+	AVLTreeNode<T, Options>* b = right.m_root;
+	int bHeight = right.m_height;
+
+	TakeOver(right);
+	m_root = JoinNodes(m_root, m_height, middle, b, bHeight, m_height);
+	m_numElements = total;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::Contains(const T & data) const
+{
+	return FindNode(data) != nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::Count(const T & data) const
+{
+	return CountCopies(data, std::integral_constant<bool, COUNTED>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::CountCopies(const T & data, std::true_type) const
+{
+	AVLTreeNode<T, Options>* found = FindNode(data);
+
+	return found != nullptr ? found->m_count : 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::CountCopies(const T & data, std::false_type) const
+{
+	//equal items sit next to each other in order
+	int count = 0;
+
+	for (const_iterator current = LowerBound(data); current != end() && !(data < *current); ++current)
+		++count;
+
+	return count;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline const T* AVLTree<T, Allocator, Options>::Find(const T & data) const
+{
+	AVLTreeNode<T, Options>* found = FindNode(data);
+
+	return found != nullptr ? &found->m_data : nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline typename AVLTree<T, Allocator, Options>::const_iterator AVLTree<T, Allocator, Options>::LowerBound(const T & data) const
+{
+	const_iterator found(m_root);
+	found.SeekLowerBound(data);
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline typename AVLTree<T, Allocator, Options>::const_iterator AVLTree<T, Allocator, Options>::UpperBound(const T & data) const
+{
+	const_iterator found(m_root);
+	found.SeekUpperBound(data);
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline const T* AVLTree<T, Allocator, Options>::Floor(const T & data) const
+{
+	AVLTreeNode<T, Options>* found = FloorNode(data);
+
+	return found != nullptr ? &found->m_data : nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline const T* AVLTree<T, Allocator, Options>::Ceiling(const T & data) const
+{
+	AVLTreeNode<T, Options>* found = LowerBoundNode(data);
+
+	return found != nullptr ? &found->m_data : nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline const T* AVLTree<T, Allocator, Options>::Predecessor(const T & data) const
+{
+	AVLTreeNode<T, Options>* found = PredecessorNode(data);
+
+	return found != nullptr ? &found->m_data : nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline const T* AVLTree<T, Allocator, Options>::Successor(const T & data) const
+{
+	AVLTreeNode<T, Options>* found = UpperBoundNode(data);
+
+	return found != nullptr ? &found->m_data : nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline typename AVLTree<T, Allocator, Options>::const_iterator AVLTree<T, Allocator, Options>::begin() const
+{
+	const_iterator first(m_root);
+	first.SeekFirst();
+
+	return first;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline typename AVLTree<T, Allocator, Options>::const_iterator AVLTree<T, Allocator, Options>::end() const
+{
+	return const_iterator(m_root);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline typename AVLTree<T, Allocator, Options>::const_reverse_iterator AVLTree<T, Allocator, Options>::rbegin() const
+{
+	return const_reverse_iterator(end());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline typename AVLTree<T, Allocator, Options>::const_reverse_iterator AVLTree<T, Allocator, Options>::rend() const
+{
+	return const_reverse_iterator(begin());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::InOrder(void visit(T&))
+{
+	//visit can change the items, so no other tree may see them
+	UnshareAll(m_root, std::integral_constant<bool, COPY_ON_WRITE>());
+	InOrderTraverse(m_root, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::PreOrder(void visit(T&))
+{
+	UnshareAll(m_root, std::integral_constant<bool, COPY_ON_WRITE>());
+	PreOrderTraverse(m_root, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::PostOrder(void visit(T&))
+{
+	UnshareAll(m_root, std::integral_constant<bool, COPY_ON_WRITE>());
+	PostOrderTraverse(m_root, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::BreadthFirst(void visit(T&))
+{
+	UnshareAll(m_root, std::integral_constant<bool, COPY_ON_WRITE>());
+	BreadthFirstTraverse(m_root, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::InOrder(Visitor visit)
+{
+	UnshareAll(m_root, std::integral_constant<bool, COPY_ON_WRITE>());
+	return InOrderTraverse(m_root, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::PreOrder(Visitor visit)
+{
+	UnshareAll(m_root, std::integral_constant<bool, COPY_ON_WRITE>());
+	return PreOrderTraverse(m_root, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::PostOrder(Visitor visit)
+{
+	UnshareAll(m_root, std::integral_constant<bool, COPY_ON_WRITE>());
+	return PostOrderTraverse(m_root, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::BreadthFirst(Visitor visit)
+{
+	UnshareAll(m_root, std::integral_constant<bool, COPY_ON_WRITE>());
+	return BreadthFirstTraverse(m_root, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::InOrder(void visit(const T&)) const
+{
+	//visit only reads, so the nodes can stay shared
+	InOrderTraverse(static_cast<const AVLTreeNode<T, Options>*>(m_root), visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::PreOrder(void visit(const T&)) const
+{
+	PreOrderTraverse(static_cast<const AVLTreeNode<T, Options>*>(m_root), visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::PostOrder(void visit(const T&)) const
+{
+	PostOrderTraverse(static_cast<const AVLTreeNode<T, Options>*>(m_root), visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::BreadthFirst(void visit(const T&)) const
+{
+	BreadthFirstTraverse(static_cast<const AVLTreeNode<T, Options>*>(m_root), visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::InOrder(Visitor visit) const
+{
+	return InOrderTraverse(static_cast<const AVLTreeNode<T, Options>*>(m_root), visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::PreOrder(Visitor visit) const
+{
+	return PreOrderTraverse(static_cast<const AVLTreeNode<T, Options>*>(m_root), visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::PostOrder(Visitor visit) const
+{
+	return PostOrderTraverse(static_cast<const AVLTreeNode<T, Options>*>(m_root), visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::BreadthFirst(Visitor visit) const
+{
+	return BreadthFirstTraverse(static_cast<const AVLTreeNode<T, Options>*>(m_root), visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::IsEmpty() const
+{
+	return m_root == nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::IsBalanced() const
+{
+	return IsBalancedNode(m_root);
+}
+
+//template<typename T, template <typename> class Allocator, unsigned Options>
+//inline bool AVLTree<T, Allocator, Options>::IsHeightBalanced() const
+//{
+//	return IsHeightBalancedNode(m_root);
+//}
+
+//template<typename T, template <typename> class Allocator, unsigned Options>
+//inline bool AVLTree<T, Allocator, Options>::BalanceMatchesHeights(AVLTreeNode<T, Options>* root) const
+//{
+//	int LH = GetHeightOfNode(root->m_left);
+//	int RH = GetHeightOfNode(root->m_right);
+//	return (LH - RH == root->m_balance);
+//}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::CopyFrom(const AVLTree<T, Allocator, Options> & rhs, std::true_type)
+{
+	//whichever tree writes first copies the nodes it changes
+	m_root = rhs.m_root;
+	ShareNode(m_root);
+	m_numElements = rhs.m_numElements;
+	m_height = rhs.m_height;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::CopyFrom(const AVLTree<T, Allocator, Options> & rhs, std::false_type)
+{
+	if (!rhs.IsEmpty())
+	{
+		CopyTree(m_root, rhs.m_root);
+		m_numElements = rhs.m_numElements;
+		m_height = rhs.m_height;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::CopyTree(AVLTreeNode<T, Options>*& root, const AVLTreeNode<T, Options>* copyRoot)
+{
+	if (copyRoot != nullptr)
+	{
+		root = CreateNode(*copyRoot);
+		CopyTree(root->m_left, copyRoot->m_left);
+		CopyTree(root->m_right, copyRoot->m_right);
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::InsertNode(AVLTreeNode<T, Options>*& root, AVLTreeNode<T, Options>* node, bool& taller)
+{
+	if (root == nullptr)
+	{
+		root = node;
+		taller = true;
+	}
+	else if (node->m_data < root->m_data)
+	{
+		Unshare(root);
+		InsertNode(root->m_left, node, taller);
+		UpdateSize(root);
+		if (taller)
+			LeftTaller(root, taller);
+	}
+	else
+	{
+		Unshare(root);
+		InsertNode(root->m_right, node, taller);
+		UpdateSize(root);
+		if (taller)
+			RightTaller(root, taller);
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename U>
+inline void AVLTree<T, Allocator, Options>::InsertItem(U && data, std::true_type)
+{
+	//a copy of an item already in the tree is only counted, nothing is allocated
+	bool inserted = false;
+	auto make = [&]() { return CreateNode(std::forward<U>(data)); };
+
+	FindOrInsert(data, make, inserted);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename U>
+inline void AVLTree<T, Allocator, Options>::InsertItem(U && data, std::false_type)
+{
+	LinkNode(CreateNode(std::forward<U>(data)));
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::LinkNode(AVLTreeNode<T, Options>* node)
+{
+	LinkNode(node, std::integral_constant<bool, COUNTED>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::LinkNode(AVLTreeNode<T, Options>* node, std::true_type)
+{
+	bool inserted = false;
+	auto make = [node]() { return node; };
+
+	try
+	{
+		FindOrInsert(node->m_data, make, inserted);
+	}
+	catch (...)
+	{
+		DestroyNode(node);
+		throw;
+	}
+
+	//an equal node took the copy
+	if (!inserted)
+		DestroyNode(node);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::LinkNode(AVLTreeNode<T, Options>* node, std::false_type)
+{
+	bool taller = false;
+
+	try
+	{
+		InsertNode(m_root, node, taller);
+	}
+	catch (...)
+	{
+		//a comparison threw on the way down, nothing was linked yet
+		DestroyNode(node);
+		throw;
+	}
+
+	++m_numElements;
+
+	if (taller)
+		++m_height;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::AddCopies(AVLTreeNode<T, Options>* node, int copies, std::true_type)
+{
+	node->m_count += copies;
+	UpdateSize(node);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::AddCopies(AVLTreeNode<T, Options>*, int, std::false_type)
+{
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Key, typename Maker>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::FindOrInsert(const Key & key, Maker& make, bool& inserted)
+{
+	bool taller = false;
+	inserted = false;
+
+	//make() runs at the bottom of the walk, if it or a comparison throws nothing has been linked
+	AVLTreeNode<T, Options>* node = FindOrInsertNode(m_root, key, make, taller, inserted);
+
+	if (inserted || COUNTED)
+		++m_numElements;
+
+	if (taller)
+		++m_height;
+
+	return node;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Key, typename Maker>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::FindOrInsertNode(AVLTreeNode<T, Options>*& root, const Key & key,
+	Maker& make, bool& taller, bool& inserted)
+{
+	AVLTreeNode<T, Options>* node = nullptr;
+
+	if (root == nullptr)
+	{
+		root = make();
+		inserted = true;
+		taller = true;
+
+		node = root;
+	}
+	else if (key < root->m_data)
+	{
+		Unshare(root);
+		node = FindOrInsertNode(root->m_left, key, make, taller, inserted);
+		UpdateSize(root);
+		if (taller)
+			LeftTaller(root, taller);
+	}
+	else if (root->m_data < key)
+	{
+		Unshare(root);
+		node = FindOrInsertNode(root->m_right, key, make, taller, inserted);
+		UpdateSize(root);
+		if (taller)
+			RightTaller(root, taller);
+	}
+	else
+	{
+		//the caller may change the node it gets back
+		Unshare(root);
+		node = root;
+		AddCopies(node, 1, std::integral_constant<bool, COUNTED>());
+	}
+
+	return node;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::LeftTaller(AVLTreeNode<T, Options>*& root, bool& taller)
+{
+	switch (root->m_balance)
+	{
+	case AVLTreeNode<T, Options>::BALANCE::LH:
+		//the grown child is on the write path, but after a join its inner child can still be shared
+		if (root->m_left->m_balance == AVLTreeNode<T, Options>::BALANCE::RH) //Checks LR
+		{
+			Unshare(root->m_left->m_right);
+			++(root->m_left->m_balance);
+			RRRotation(root->m_left);
+			taller = false;
+		}
+		else if (root->m_left->m_balance == AVLTreeNode<T, Options>::BALANCE::LH)
+		{
+			taller = false;
+		}
+		//an even child (only after a join, never after an insert) keeps the extra height
+		LLRotation(root);
+
+		break;
+	case AVLTreeNode<T, Options>::BALANCE::EH:
+		root->m_balance = AVLTreeNode<T, Options>::BALANCE::LH;
+
+		break;
+	case AVLTreeNode<T, Options>::BALANCE::RH:
+		root->m_balance = AVLTreeNode<T, Options>::BALANCE::EH;
+		taller = false;
+
+		break;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::RightTaller(AVLTreeNode<T, Options>*& root, bool& taller)
+{
+	switch (root->m_balance)
+	{
+	case AVLTreeNode<T, Options>::BALANCE::LH:
+		root->m_balance = AVLTreeNode<T, Options>::BALANCE::EH;
+		taller = false;
+
+		break;
+	case AVLTreeNode<T, Options>::BALANCE::EH:
+		root->m_balance = AVLTreeNode<T, Options>::BALANCE::RH;
+
+		break;
+	case AVLTreeNode<T, Options>::BALANCE::RH:
+		if (root->m_right->m_balance == AVLTreeNode<T, Options>::BALANCE::LH) //Checks RL
+		{
+			Unshare(root->m_right->m_left);
+			--(root->m_right->m_balance);
+			LLRotation(root->m_right);
+			taller = false;
+		}
+		else if (root->m_right->m_balance == AVLTreeNode<T, Options>::BALANCE::RH)
+		{
+			taller = false;
+		}
+		RRRotation(root);
+
+		break;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::LLRotation(AVLTreeNode<T, Options>*& root)
+{
+	AVLTreeNode<T, Options>* left = root->m_left;
+	AVLTreeNode<T, Options>* leftRight = left->m_right;
+
+	++(root->m_balance);
+	root->m_balance = root->m_balance - 1 - max(left->m_balance, 0);
+	left->m_balance = left->m_balance - 1 + min(root->m_balance, 0);
+
+	left->m_right = root;
+	root->m_left = leftRight;
+
+	UpdateSize(root);
+	UpdateSize(left);
+
+	root = left;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::RRRotation(AVLTreeNode<T, Options>*& root)
+{
+	AVLTreeNode<T, Options>* right = root->m_right;
+	AVLTreeNode<T, Options>* rightLeft = right->m_left;
+	
+	--(root->m_balance);
+	root->m_balance = root->m_balance + 1 - min(right->m_balance, 0);
+	right->m_balance = right->m_balance + 1 + max(root->m_balance, 0);
+
+	right->m_left = root;
+	root->m_right = rightLeft;
+
+	UpdateSize(root);
+	UpdateSize(right);
+
+	root = right;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Key>
+inline bool AVLTree<T, Allocator, Options>::FindNodeAndDelete(AVLTreeNode<T, Options>*& root, const Key & key, bool& shorter)
+{
+	if (root == nullptr)
+		return false;
+
+	Unshare(root);
+
+	if (key < root->m_data)
+	{
+		//key smaller, go left and fix this node if the left side lost height
+		if (!FindNodeAndDelete(root->m_left, key, shorter))
+			return false;
+		UpdateSize(root);
+		if (shorter)
+			LeftShorter(root, shorter);
+	}
+	else if (root->m_data < key)
+	{
+		if (!FindNodeAndDelete(root->m_right, key, shorter))
+			return false;
+		UpdateSize(root);
+		if (shorter)
+			RightShorter(root, shorter);
+	}
+	else if (root->CopyCount() > 1)
+	{
+		//only one of the counted copies goes, the node stays
+		AddCopies(root, -1, std::integral_constant<bool, COUNTED>());
+	}
+	else
+	{
+		//this is the node to delete, unlink it and let the callers rebalance on the way back up
+		AVLTreeNode<T, Options>* old = root;
+
+		if (root->m_left == nullptr) //right only (or empty)
+		{
+			root = root->m_right;
+			shorter = true;
+		}
+		else if (root->m_right == nullptr) //left only
+		{
+			root = root->m_left;
+			shorter = true;
+		}
+		else //both
+		{
+			//the in-order predecessor takes this node's place
+			AVLTreeNode<T, Options>* previous = RemoveMaxNode(root->m_left, shorter);
+
+			previous->m_left = root->m_left;
+			previous->m_right = root->m_right;
+			previous->m_balance = root->m_balance;
+			root = previous;
+			UpdateSize(root);
+
+			if (shorter)
+				LeftShorter(root, shorter);
+		}
+
+		DestroyNode(old);
+	}
+
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::RemoveMaxNode(AVLTreeNode<T, Options>*& root, bool& shorter)
+{
+	Unshare(root);
+
+	if (root->m_right == nullptr)
+	{
+		AVLTreeNode<T, Options>* max = root;
+		root = root->m_left;
+		shorter = true;
+
+		return max;
+	}
+
+	AVLTreeNode<T, Options>* max = RemoveMaxNode(root->m_right, shorter);
+	UpdateSize(root);
+	if (shorter)
+		RightShorter(root, shorter);
+
+	return max;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::LeftShorter(AVLTreeNode<T, Options>*& root, bool& shorter)
+{
+	switch (root->m_balance)
+	{
+	case AVLTreeNode<T, Options>::BALANCE::LH:
+		root->m_balance = AVLTreeNode<T, Options>::BALANCE::EH;
+
+		break;
+	case AVLTreeNode<T, Options>::BALANCE::EH:
+		root->m_balance = AVLTreeNode<T, Options>::BALANCE::RH;
+		shorter = false;
+
+		break;
+	case AVLTreeNode<T, Options>::BALANCE::RH:
+		//the sibling is off the delete path and may still belong to other trees
+		Unshare(root->m_right);
+
+		if (root->m_right->m_balance == AVLTreeNode<T, Options>::BALANCE::LH) //Checks RL
+		{
+			Unshare(root->m_right->m_left);
+			--(root->m_right->m_balance);
+			LLRotation(root->m_right);
+		}
+		else if (root->m_right->m_balance == AVLTreeNode<T, Options>::BALANCE::EH)
+		{
+			shorter = false; //a single rotation over an even child keeps the height
+		}
+		RRRotation(root);
+
+		break;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::RightShorter(AVLTreeNode<T, Options>*& root, bool& shorter)
+{
+	switch (root->m_balance)
+	{
+	case AVLTreeNode<T, Options>::BALANCE::LH:
+		Unshare(root->m_left);
+
+		if (root->m_left->m_balance == AVLTreeNode<T, Options>::BALANCE::RH) //Checks LR
+		{
+			Unshare(root->m_left->m_right);
+			++(root->m_left->m_balance);
+			RRRotation(root->m_left);
+		}
+		else if (root->m_left->m_balance == AVLTreeNode<T, Options>::BALANCE::EH)
+		{
+			shorter = false; //a single rotation over an even child keeps the height
+		}
+		LLRotation(root);
+
+		break;
+	case AVLTreeNode<T, Options>::BALANCE::EH:
+		root->m_balance = AVLTreeNode<T, Options>::BALANCE::LH;
+		shorter = false;
+
+		break;
+	case AVLTreeNode<T, Options>::BALANCE::RH:
+		root->m_balance = AVLTreeNode<T, Options>::BALANCE::EH;
+
+		break;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::JoinNodes(AVLTreeNode<T, Options>* left, int leftHeight,
+	AVLTreeNode<T, Options>* pivot, AVLTreeNode<T, Options>* right, int rightHeight, int& height)
+{
+	bool taller = false;
+
+	if (leftHeight > rightHeight + 1)
+	{
+		JoinRight(left, leftHeight, pivot, right, rightHeight, taller);
+		height = leftHeight + (taller ? 1 : 0);
+
+		return left;
+	}
+
+	if (rightHeight > leftHeight + 1)
+	{
+		JoinLeft(right, rightHeight, left, leftHeight, pivot, taller);
+		height = rightHeight + (taller ? 1 : 0);
+
+		return right;
+	}
+
+	//close enough in height, pivot can sit on top
+	pivot->m_left = left;
+	pivot->m_right = right;
+	pivot->m_balance = leftHeight - rightHeight;
+	UpdateSize(pivot);
+	height = max(leftHeight, rightHeight) + 1;
+
+	return pivot;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::JoinRight(AVLTreeNode<T, Options>*& root, int rootHeight,
+	AVLTreeNode<T, Options>* pivot, AVLTreeNode<T, Options>* right, int rightHeight, bool& taller)
+{
+	if (rootHeight <= rightHeight + 1)
+	{
+		//this subtree and right are close enough in height, pivot takes its place
+		pivot->m_left = root;
+		pivot->m_right = right;
+		pivot->m_balance = rootHeight - rightHeight;
+		UpdateSize(pivot);
+		root = pivot;
+		taller = true;
+
+		return;
+	}
+
+	Unshare(root);
+
+	int childHeight = rootHeight - 1 - (root->m_balance == AVLTreeNode<T, Options>::BALANCE::LH ? 1 : 0);
+	JoinRight(root->m_right, childHeight, pivot, right, rightHeight, taller);
+	UpdateSize(root);
+	if (taller)
+		RightTaller(root, taller);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::JoinLeft(AVLTreeNode<T, Options>*& root, int rootHeight,
+	AVLTreeNode<T, Options>* left, int leftHeight, AVLTreeNode<T, Options>* pivot, bool& taller)
+{
+	if (rootHeight <= leftHeight + 1)
+	{
+		pivot->m_left = left;
+		pivot->m_right = root;
+		pivot->m_balance = leftHeight - rootHeight;
+		UpdateSize(pivot);
+		root = pivot;
+		taller = true;
+
+		return;
+	}
+
+	Unshare(root);
+
+	int childHeight = rootHeight - 1 - (root->m_balance == AVLTreeNode<T, Options>::BALANCE::RH ? 1 : 0);
+	JoinLeft(root->m_left, childHeight, left, leftHeight, pivot, taller);
+	UpdateSize(root);
+	if (taller)
+		LeftTaller(root, taller);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::JoinTwo(AVLTreeNode<T, Options>* left, int leftHeight,
+	AVLTreeNode<T, Options>* right, int rightHeight, int& height)
+{
+	if (left == nullptr)
+	{
+		height = rightHeight;
+		return right;
+	}
+
+	bool shorter = false;
+	AVLTreeNode<T, Options>* pivot = RemoveMaxNode(left, shorter);
+
+	return JoinNodes(left, leftHeight - (shorter ? 1 : 0), pivot, right, rightHeight, height);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::SplitNode(AVLTreeNode<T, Options>* root, int height, const T & data,
+	AVLTreeNode<T, Options>*& left, int& leftHeight, AVLTreeNode<T, Options>*& right, int& rightHeight)
+{
+	if (root == nullptr)
+	{
+		left = nullptr;
+		right = nullptr;
+		leftHeight = 0;
+		rightHeight = 0;
+
+		return nullptr;
+	}
+
+	//root is taken apart, its children go to the locals
+	Unshare(root);
+
+	AVLTreeNode<T, Options>* rootLeft = root->m_left;
+	AVLTreeNode<T, Options>* rootRight = root->m_right;
+	int rootLeftHeight = height - 1 - (root->m_balance == AVLTreeNode<T, Options>::BALANCE::RH ? 1 : 0);
+	int rootRightHeight = height - 1 - (root->m_balance == AVLTreeNode<T, Options>::BALANCE::LH ? 1 : 0);
+	AVLTreeNode<T, Options>* found = nullptr;
+
+	if (data < root->m_data)
+	{
+		//root and its right subtree belong to the greater side
+		AVLTreeNode<T, Options>* middle = nullptr;
+		int middleHeight = 0;
+
+		found = SplitNode(rootLeft, rootLeftHeight, data, left, leftHeight, middle, middleHeight);
+		right = JoinNodes(middle, middleHeight, root, rootRight, rootRightHeight, rightHeight);
+	}
+	else if (root->m_data < data)
+	{
+		AVLTreeNode<T, Options>* middle = nullptr;
+		int middleHeight = 0;
+
+		found = SplitNode(rootRight, rootRightHeight, data, middle, middleHeight, right, rightHeight);
+		left = JoinNodes(rootLeft, rootLeftHeight, root, middle, middleHeight, leftHeight);
+	}
+	else
+	{
+		left = rootLeft;
+		leftHeight = rootLeftHeight;
+		right = rootRight;
+		rightHeight = rootRightHeight;
+
+		found = root;
+		found->m_left = nullptr;
+		found->m_right = nullptr;
+		found->m_balance = AVLTreeNode<T, Options>::BALANCE::EH;
+		UpdateSize(found);
+	}
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::UnionNodes(AVLTreeNode<T, Options>* a, int aHeight,
+	AVLTreeNode<T, Options>* b, int bHeight, int& height, int& removed)
+{
+	if (a == nullptr)
+	{
+		height = bHeight;
+		return b;
+	}
+	if (b == nullptr)
+	{
+		height = aHeight;
+		return a;
+	}
+
+	Unshare(a);
+
+	AVLTreeNode<T, Options>* aLeft = a->m_left;
+	AVLTreeNode<T, Options>* aRight = a->m_right;
+	int aLeftHeight = aHeight - 1 - (a->m_balance == AVLTreeNode<T, Options>::BALANCE::RH ? 1 : 0);
+	int aRightHeight = aHeight - 1 - (a->m_balance == AVLTreeNode<T, Options>::BALANCE::LH ? 1 : 0);
+
+	AVLTreeNode<T, Options>* bLeft = nullptr;
+	AVLTreeNode<T, Options>* bRight = nullptr;
+	int bLeftHeight = 0;
+	int bRightHeight = 0;
+	AVLTreeNode<T, Options>* duplicate = SplitNode(b, bHeight, a->m_data, bLeft, bLeftHeight, bRight, bRightHeight);
+
+	if (duplicate != nullptr)
+	{
+		DestroyNode(duplicate);
+		++removed;
+	}
+
+	int leftHeight = 0;
+	int rightHeight = 0;
+	AVLTreeNode<T, Options>* left = UnionNodes(aLeft, aLeftHeight, bLeft, bLeftHeight, leftHeight, removed);
+	AVLTreeNode<T, Options>* right = UnionNodes(aRight, aRightHeight, bRight, bRightHeight, rightHeight, removed);
+
+	return JoinNodes(left, leftHeight, a, right, rightHeight, height);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::IntersectNodes(AVLTreeNode<T, Options>* a, int aHeight,
+	AVLTreeNode<T, Options>* b, int bHeight, int& height, int& removed)
+{
+	if (a == nullptr || b == nullptr)
+	{
+		removed += PurgeNodes(a) + PurgeNodes(b);
+		height = 0;
+
+		return nullptr;
+	}
+
+	Unshare(a);
+
+	AVLTreeNode<T, Options>* aLeft = a->m_left;
+	AVLTreeNode<T, Options>* aRight = a->m_right;
+	int aLeftHeight = aHeight - 1 - (a->m_balance == AVLTreeNode<T, Options>::BALANCE::RH ? 1 : 0);
+	int aRightHeight = aHeight - 1 - (a->m_balance == AVLTreeNode<T, Options>::BALANCE::LH ? 1 : 0);
+
+	AVLTreeNode<T, Options>* bLeft = nullptr;
+	AVLTreeNode<T, Options>* bRight = nullptr;
+	int bLeftHeight = 0;
+	int bRightHeight = 0;
+	AVLTreeNode<T, Options>* duplicate = SplitNode(b, bHeight, a->m_data, bLeft, bLeftHeight, bRight, bRightHeight);
+
+	int leftHeight = 0;
+	int rightHeight = 0;
+	AVLTreeNode<T, Options>* left = IntersectNodes(aLeft, aLeftHeight, bLeft, bLeftHeight, leftHeight, removed);
+	AVLTreeNode<T, Options>* right = IntersectNodes(aRight, aRightHeight, bRight, bRightHeight, rightHeight, removed);
+
+	if (duplicate != nullptr)
+	{
+		//in both, keep ours
+		DestroyNode(duplicate);
+		++removed;
+
+		return JoinNodes(left, leftHeight, a, right, rightHeight, height);
+	}
+
+	DestroyNode(a);
+	++removed;
+
+	return JoinTwo(left, leftHeight, right, rightHeight, height);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::DifferenceNodes(AVLTreeNode<T, Options>* a, int aHeight,
+	AVLTreeNode<T, Options>* b, int bHeight, int& height, int& removed)
+{
+	if (a == nullptr || b == nullptr)
+	{
+		removed += PurgeNodes(b);
+		height = aHeight;
+
+		return a;
+	}
+
+	Unshare(a);
+
+	AVLTreeNode<T, Options>* aLeft = a->m_left;
+	AVLTreeNode<T, Options>* aRight = a->m_right;
+	int aLeftHeight = aHeight - 1 - (a->m_balance == AVLTreeNode<T, Options>::BALANCE::RH ? 1 : 0);
+	int aRightHeight = aHeight - 1 - (a->m_balance == AVLTreeNode<T, Options>::BALANCE::LH ? 1 : 0);
+
+	AVLTreeNode<T, Options>* bLeft = nullptr;
+	AVLTreeNode<T, Options>* bRight = nullptr;
+	int bLeftHeight = 0;
+	int bRightHeight = 0;
+	AVLTreeNode<T, Options>* duplicate = SplitNode(b, bHeight, a->m_data, bLeft, bLeftHeight, bRight, bRightHeight);
+
+	int leftHeight = 0;
+	int rightHeight = 0;
+	AVLTreeNode<T, Options>* left = DifferenceNodes(aLeft, aLeftHeight, bLeft, bLeftHeight, leftHeight, removed);
+	AVLTreeNode<T, Options>* right = DifferenceNodes(aRight, aRightHeight, bRight, bRightHeight, rightHeight, removed);
+
+	if (duplicate != nullptr)
+	{
+		//in both, drop the pair
+		DestroyNode(duplicate);
+		DestroyNode(a);
+		removed += 2;
+
+		return JoinTwo(left, leftHeight, right, rightHeight, height);
+	}
+
+	return JoinNodes(left, leftHeight, a, right, rightHeight, height);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::TakeOver(AVLTree<T, Allocator, Options> & other)
+{
+	m_alloc.Adopt(other.m_alloc);
+
+	//Default values
+	other.m_root = nullptr;
+	other.m_numElements = 0;
+	other.m_height = 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::TakeAll(AVLTree<T, Allocator, Options> & other)
+{
+	m_alloc.Swap(other.m_alloc);
+
+	//Default values
+	other.m_root = nullptr;
+	other.m_numElements = 0;
+	other.m_height = 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::UpdateSize(AVLTreeNode<T, Options>* root)
+{
+	UpdateSize(root, std::integral_constant<bool, ORDER_STATISTICS>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::UpdateSize(AVLTreeNode<T, Options>* root, std::true_type)
+{
+	root->m_size = root->CopyCount() + SizeOfNode(root->m_left) + SizeOfNode(root->m_right);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void AVLTree<T, Allocator, Options>::UpdateSize(AVLTreeNode<T, Options>*, std::false_type)
+{
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::SizeOfNode(const AVLTreeNode<T, Options>* root)
+{
+	return root != nullptr ? root->m_size : 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::CountLess(const T & data, bool orEqual) const
+{
+	AVLTreeNode<T, Options>* current = m_root;
+	int count = 0;
+
+	while (current != nullptr)
+	{
+		if (current->m_data < data || (orEqual && !(data < current->m_data)))
+		{
+			//this node and everything left of it counts
+			count += SizeOfNode(current->m_left) + current->CopyCount();
+			current = current->m_right;
+		}
+		else
+		{
+			current = current->m_left;
+		}
+	}
+
+	return count;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int AVLTree<T, Allocator, Options>::GetHeightOfNode(AVLTreeNode<T, Options>* root) const
+{
+	if (root == nullptr)
+		return 0;
+
+	int leftHeight = GetHeightOfNode(root->m_left);
+	int rightHeight = GetHeightOfNode(root->m_right);
+	if (leftHeight > rightHeight)
+		return leftHeight + 1;
+	//else
+	return rightHeight + 1;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Key>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::FindNode(const Key & key) const
+{
+	AVLTreeNode<T, Options>* current = m_root;
+
+	while (current != nullptr)
+	{
+		if (key < current->m_data)
+			current = current->m_left;
+		else if (current->m_data < key)
+			current = current->m_right;
+		else
+			return current;
+	}
+
+	return nullptr;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::LowerBoundNode(const T & data) const
+{
+	AVLTreeNode<T, Options>* current = m_root;
+	AVLTreeNode<T, Options>* found = nullptr;
+
+	while (current != nullptr)
+	{
+		if (current->m_data < data)
+		{
+			current = current->m_right;
+		}
+		else
+		{
+			//candidate, but something smaller may still qualify on the left
+			found = current;
+			current = current->m_left;
+		}
+	}
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::UpperBoundNode(const T & data) const
+{
+	AVLTreeNode<T, Options>* current = m_root;
+	AVLTreeNode<T, Options>* found = nullptr;
+
+	while (current != nullptr)
+	{
+		if (data < current->m_data)
+		{
+			found = current;
+			current = current->m_left;
+		}
+		else
+		{
+			current = current->m_right;
+		}
+	}
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::FloorNode(const T & data) const
+{
+	AVLTreeNode<T, Options>* current = m_root;
+	AVLTreeNode<T, Options>* found = nullptr;
+
+	while (current != nullptr)
+	{
+		if (data < current->m_data)
+		{
+			current = current->m_left;
+		}
+		else
+		{
+			//candidate, but something larger may still qualify on the right
+			found = current;
+			current = current->m_right;
+		}
+	}
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTree<T, Allocator, Options>::PredecessorNode(const T & data) const
+{
+	AVLTreeNode<T, Options>* current = m_root;
+	AVLTreeNode<T, Options>* found = nullptr;
+
+	while (current != nullptr)
+	{
+		if (current->m_data < data)
+		{
+			found = current;
+			current = current->m_right;
+		}
+		else
+		{
+			current = current->m_left;
+		}
+	}
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool AVLTree<T, Allocator, Options>::IsBalancedNode(AVLTreeNode<T, Options>* root) const
+{
+	if (root != nullptr)
+	{
+		return (IsBalancedNode(root->m_left) &&
+			root->m_balance >= -1 && root->m_balance <= 1 &&
+			IsBalancedNode(root->m_right));
+	}
+	return true;
+}
+
+//template<typename T, template <typename> class Allocator, unsigned Options>
+//inline bool AVLTree<T, Allocator, Options>::IsHeightBalancedNode(AVLTreeNode<T, Options>* root) const
+//{
+//	if (root != nullptr)
+//	{
+//		int leftHeight = GetHeightOfNode(root->m_left);
+//		int rightHeight = GetHeightOfNode(root->m_right);
+//		return (IsHeightBalancedNode(root->m_left) &&
+//			leftHeight - rightHeight >= -1 && leftHeight - rightHeight <= 1 &&
+//			IsHeightBalancedNode(root->m_right));
+//	}
+//	return true;
+//}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Node, typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::InOrderTraverse(Node* root, Visitor& visit)
+{
+	Node* path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	Node* current = root;
+
+	while (current != nullptr || depth > 0)
+	{
+		//go as far left as possible, then visit and step into the right subtree
+		while (current != nullptr)
+		{
+			path[depth++] = current;
+			current = current->m_left;
+		}
+
+		current = path[--depth];
+		if (!Visit(visit, current->m_data))
+			return false;
+
+		current = current->m_right;
+	}
+
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Node, typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::PreOrderTraverse(Node* root, Visitor& visit)
+{
+	//holds the right children still to do, never more than one per level plus the root
+	Node* pending[AVL_MAX_HEIGHT + 1];
+	int depth = 0;
+
+	if (root != nullptr)
+		pending[depth++] = root;
+
+	while (depth > 0)
+	{
+		Node* current = pending[--depth];
+		if (!Visit(visit, current->m_data))
+			return false;
+
+		if (current->m_right != nullptr)
+			pending[depth++] = current->m_right;
+		if (current->m_left != nullptr)
+			pending[depth++] = current->m_left;
+	}
+
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Node, typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::PostOrderTraverse(Node* root, Visitor& visit)
+{
+	Node* path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	Node* current = root;
+	Node* previous = nullptr; //last node visited
+
+	while (current != nullptr || depth > 0)
+	{
+		while (current != nullptr)
+		{
+			path[depth++] = current;
+			current = current->m_left;
+		}
+
+		Node* top = path[depth - 1];
+
+		if (top->m_right != nullptr && top->m_right != previous)
+		{
+			//right subtree has not been done yet
+			current = top->m_right;
+		}
+		else
+		{
+			--depth;
+			if (!Visit(visit, top->m_data))
+				return false;
+
+			previous = top;
+		}
+	}
+
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Node, typename Visitor>
+inline bool AVLTree<T, Allocator, Options>::BreadthFirstTraverse(Node* root, Visitor& visit)
+{
+	if (root != nullptr)
+	{
+		Queue<Node*> nodes;
+
+		nodes.Enqueue(root);
+
+		while (!nodes.isEmpty())
+		{
+			Node* current = nodes.Dequeue();
+			if (!Visit(visit, current->m_data))
+				return false;
+
+			if (current->m_left != nullptr)
+				nodes.Enqueue(current->m_left);
+			if (current->m_right != nullptr)
+				nodes.Enqueue(current->m_right);
+		}
+	}
+
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor, typename Data>
+inline bool AVLTree<T, Allocator, Options>::Visit(Visitor& visit, Data& data)
+{
+	return Visit(visit, data, std::is_void<decltype(visit(data))>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor, typename Data>
+inline bool AVLTree<T, Allocator, Options>::Visit(Visitor& visit, Data& data, std::true_type)
+{
+	visit(data);
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor, typename Data>
+inline bool AVLTree<T, Allocator, Options>::Visit(Visitor& visit, Data& data, std::false_type)
+{
+	return static_cast<bool>(visit(data));
+}
@@ -0,0 +1,328 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: AVLTreeIterator.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - The node type is a template parameter so PersistentAVLTree can use it too
+*		- 10/17/2026 - The path is value-initialized; AVLTreeReverseIterator reads it without copying
+*		- 10/17/2026 - PersistentAVLTree hands out AVLTree's iterators, so it is no longer a friend
+*		- 10/17/2026 - The path is left uninitialized again, copies only copy the entries in use
+**************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include "AVLTreeNode.h"
+
+template <typename T, unsigned Options, typename Node>
+class AVLTreeReverseIterator;
+
+/************************************************************************
+* Class: AVLTreeIterator
+*
+* Purpose: This class is a bidirectional in-order iterator over an
+*		AVLTree. Nodes have no parent links, so the iterator keeps the
+*		path from the root to the current node in a fixed-size array.
+*		Moving it is amortized O(1) and never allocates. The items are
+*		read only, changing one could break the tree's ordering.
+*		Any Insert or Delete on the tree invalidates its iterators.
+*		Node is the node type of the tree, anything with GetLeft, GetRight
+*		and GetData works (AVLTreeNode by default).
+*
+* Manager functions:
+* AVLTreeIterator();
+*		Creates an iterator that is not attached to any tree
+* AVLTreeIterator(const AVLTreeIterator& copy);
+* AVLTreeIterator& operator=(const AVLTreeIterator& rhs);
+*		Copy only the first m_depth entries of the path, the rest are never read
+*
+* Methods:
+* const T& operator*() const;
+*		Returns the current item
+* const T* operator->() const;
+*		Returns a pointer to the current item
+* AVLTreeIterator& operator++(); / AVLTreeIterator operator++(int);
+*		Moves to the next item in order, or to the end
+* AVLTreeIterator& operator--(); / AVLTreeIterator operator--(int);
+*		Moves to the previous item in order, decrementing the end moves to the last item
+* bool operator==(const AVLTreeIterator& rhs) const; / operator!=
+*		Returns true if both iterators are on the same node (or both at the end)
+*
+* Helpers (used by AVLTree):
+* AVLTreeIterator(const Node* root);
+*		Creates the end iterator of the tree with root "root"
+* void SeekFirst(); / void SeekLast();
+*		Moves to the smallest / largest item
+* void SeekLowerBound(const T& data); / void SeekUpperBound(const T& data);
+*		Moves to the first item that is not less than / greater than data
+* void PushLeftSpine(const Node* node); / void PushRightSpine(...)
+*		Pushes node and every left / right child below it onto the path
+*
+*************************************************************************/
+template <typename T, unsigned Options = AVL_PLAIN, typename Node = AVLTreeNode<T, Options>>
+class AVLTreeIterator
+{
+	template <typename U, template <typename> class Allocator, unsigned O>
+	friend class AVLTree;
+	friend class AVLTreeReverseIterator<T, Options, Node>;
+
+public:
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const T* pointer;
+	typedef const T& reference;
+
+	AVLTreeIterator();
+	AVLTreeIterator(const AVLTreeIterator<T, Options, Node>& copy);
+	AVLTreeIterator<T, Options, Node>& operator=(const AVLTreeIterator<T, Options, Node>& rhs);
+
+	const T& operator*() const;
+	const T* operator->() const;
+	AVLTreeIterator<T, Options, Node>& operator++();
+	AVLTreeIterator<T, Options, Node> operator++(int);
+	AVLTreeIterator<T, Options, Node>& operator--();
+	AVLTreeIterator<T, Options, Node> operator--(int);
+	bool operator==(const AVLTreeIterator<T, Options, Node>& rhs) const;
+	bool operator!=(const AVLTreeIterator<T, Options, Node>& rhs) const;
+
+private:
+	explicit AVLTreeIterator(const Node* root);
+
+	void SeekFirst();
+	void SeekLast();
+	void SeekLowerBound(const T& data);
+	void SeekUpperBound(const T& data);
+	void PushLeftSpine(const Node* node);
+	void PushRightSpine(const Node* node);
+
+	const Node* m_root;
+	const Node* m_path[AVL_MAX_HEIGHT]; //m_path[m_depth - 1] is the current node
+	int m_depth; //0 is the end
+};
+
+
+/// Function Code ///
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node>::AVLTreeIterator() : m_root(nullptr), m_depth(0)
+{
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node>::AVLTreeIterator(const AVLTreeIterator<T, Options, Node>& copy) : m_root(copy.m_root), m_depth(copy.m_depth)
+{
+	std::copy(copy.m_path, copy.m_path + copy.m_depth, m_path);
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node>& AVLTreeIterator<T, Options, Node>::operator=(const AVLTreeIterator<T, Options, Node>& rhs)
+{
+	if (this != &rhs)
+	{
+		m_root = rhs.m_root;
+		m_depth = rhs.m_depth;
+		std::copy(rhs.m_path, rhs.m_path + rhs.m_depth, m_path);
+	}
+
+	return *this;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node>::AVLTreeIterator(const Node* root) : m_root(root), m_depth(0)
+{
+	//m_path is not initialized, m_depth says how much of it is in use
+}
+
+template<typename T, unsigned Options, typename Node>
+inline const T& AVLTreeIterator<T, Options, Node>::operator*() const
+{
+	return m_path[m_depth - 1]->GetData();
+}
+
+template<typename T, unsigned Options, typename Node>
+inline const T* AVLTreeIterator<T, Options, Node>::operator->() const
+{
+	return &m_path[m_depth - 1]->GetData();
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node>& AVLTreeIterator<T, Options, Node>::operator++()
+{
+	const Node* current = m_path[m_depth - 1];
+
+	if (current->GetRight() != nullptr)
+	{
+		PushLeftSpine(current->GetRight());
+	}
+	else
+	{
+		//climb until we come up out of a left subtree, that parent is next
+		const Node* child = current;
+		--m_depth;
+
+		while (m_depth > 0 && m_path[m_depth - 1]->GetRight() == child)
+		{
+			child = m_path[m_depth - 1];
+			--m_depth;
+		}
+	}
+
+	return *this;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node> AVLTreeIterator<T, Options, Node>::operator++(int)
+{
+	AVLTreeIterator<T, Options, Node> temp(*this);
+	++(*this);
+
+	return temp;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node>& AVLTreeIterator<T, Options, Node>::operator--()
+{
+	if (m_depth == 0)
+	{
+		SeekLast();
+		return *this;
+	}
+
+	const Node* current = m_path[m_depth - 1];
+
+	if (current->GetLeft() != nullptr)
+	{
+		PushRightSpine(current->GetLeft());
+	}
+	else
+	{
+		//climb until we come up out of a right subtree, that parent is previous
+		const Node* child = current;
+		--m_depth;
+
+		while (m_depth > 0 && m_path[m_depth - 1]->GetLeft() == child)
+		{
+			child = m_path[m_depth - 1];
+			--m_depth;
+		}
+	}
+
+	return *this;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node> AVLTreeIterator<T, Options, Node>::operator--(int)
+{
+	AVLTreeIterator<T, Options, Node> temp(*this);
+	--(*this);
+
+	return temp;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline bool AVLTreeIterator<T, Options, Node>::operator==(const AVLTreeIterator<T, Options, Node>& rhs) const
+{
+	if (m_depth == 0 || rhs.m_depth == 0)
+		return m_depth == rhs.m_depth;
+
+	return m_path[m_depth - 1] == rhs.m_path[rhs.m_depth - 1];
+}
+
+template<typename T, unsigned Options, typename Node>
+inline bool AVLTreeIterator<T, Options, Node>::operator!=(const AVLTreeIterator<T, Options, Node>& rhs) const
+{
+	return !(*this == rhs);
+}
+
+template<typename T, unsigned Options, typename Node>
+inline void AVLTreeIterator<T, Options, Node>::SeekFirst()
+{
+	m_depth = 0;
+
+	if (m_root != nullptr)
+		PushLeftSpine(m_root);
+}
+
+template<typename T, unsigned Options, typename Node>
+inline void AVLTreeIterator<T, Options, Node>::SeekLast()
+{
+	m_depth = 0;
+
+	if (m_root != nullptr)
+		PushRightSpine(m_root);
+}
+
+template<typename T, unsigned Options, typename Node>
+inline void AVLTreeIterator<T, Options, Node>::SeekLowerBound(const T & data)
+{
+	const Node* current = m_root;
+	int found = 0;
+	m_depth = 0;
+
+	while (current != nullptr)
+	{
+		m_path[m_depth++] = current;
+
+		if (current->GetData() < data)
+		{
+			current = current->GetRight();
+		}
+		else
+		{
+			//candidate, but something smaller may still qualify on the left
+			found = m_depth;
+			current = current->GetLeft();
+		}
+	}
+
+	//the candidate is on the path, drop everything below it
+	m_depth = found;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline void AVLTreeIterator<T, Options, Node>::SeekUpperBound(const T & data)
+{
+	const Node* current = m_root;
+	int found = 0;
+	m_depth = 0;
+
+	while (current != nullptr)
+	{
+		m_path[m_depth++] = current;
+
+		if (data < current->GetData())
+		{
+			found = m_depth;
+			current = current->GetLeft();
+		}
+		else
+		{
+			current = current->GetRight();
+		}
+	}
+
+	m_depth = found;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline void AVLTreeIterator<T, Options, Node>::PushLeftSpine(const Node* node)
+{
+	while (node != nullptr)
+	{
+		m_path[m_depth++] = node;
+		node = node->GetLeft();
+	}
+}
+
+template<typename T, unsigned Options, typename Node>
+inline void AVLTreeIterator<T, Options, Node>::PushRightSpine(const Node* node)
+{
+	while (node != nullptr)
+	{
+		m_path[m_depth++] = node;
+		node = node->GetRight();
+	}
+}
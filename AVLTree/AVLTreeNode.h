@@ -3,167 +3,280 @@
 * Filename: AVLTreeNode.h
 * Date Created: 2/20/2019
 * Modifications:
-**************************************************************/
-
-#pragma once
-
-template <typename T>
-class AVLTree;
-
+*		- 10/17/2026 - Befriends every AVLTree<T, Allocator> so trees can construct nodes in their own storage
+*		- 10/17/2026 - Added AVL_OPTIONS and the optional subtree size (AVLTreeNodeSize)
+*		- 10/17/2026 - Added AVL_MAX_HEIGHT for the fixed-size traversal stacks
+*		- 10/17/2026 - Data is constructed in place from any arguments; the destructor no longer resets it
+*		- 10/17/2026 - Befriends AVLMap so it can update values in place
+*		- 10/17/2026 - Added AVL_COUNTED and the per node copy count (AVLTreeNodeCount)
+*		- 10/17/2026 - Added AVL_COPY_ON_WRITE and the per node reference count (AVLTreeNodeRefs)
+**************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+template <typename T, template <typename> class Allocator, unsigned Options>
+class AVLTree;
+
+template <typename K, typename V, template <typename> class Allocator, unsigned Options>
+class AVLMap;
+
+//Longest root to leaf path an AVLTree can have, an AVL tree holding INT_MAX items is at most 44 levels tall
+const int AVL_MAX_HEIGHT = 48;
+
+//Compile time options for an AVLTree, combined as a bit mask
+enum AVL_OPTIONS : unsigned
+{
+	AVL_PLAIN = 0,
+	AVL_ORDER_STATISTICS = 1, //every node keeps the size of its subtree
+	AVL_COUNTED = 2, //equal items share one node that counts them (multiset)
+	AVL_COPY_ON_WRITE = 4 //copies share nodes, a write copies only the shared nodes it changes
+};
+
+/************************************************************************
+* Class: AVLTreeNodeRefs
+*
+* Purpose: Base of AVLTreeNodeSize that counts the trees and parent nodes
+*		pointing at a node when AVL_COPY_ON_WRITE is on. A copy of a node
+*		is a new node, so it starts at one reference whatever it copied.
+*
+*************************************************************************/
+template <bool Shared>
+class AVLTreeNodeRefs
+{
+};
+
+template <>
+class AVLTreeNodeRefs<true>
+{
+public:
+	AVLTreeNodeRefs() : m_refs(1) {}
+	AVLTreeNodeRefs(const AVLTreeNodeRefs&) : m_refs(1) {}
+	AVLTreeNodeRefs& operator=(const AVLTreeNodeRefs&) { return *this; }
+
+	std::atomic<int> m_refs; //atomic, copies of a tree may be used on different threads
+};
+
+/************************************************************************
+* Class: AVLTreeNodeSize
+*
+* Purpose: Base of AVLTreeNode that holds the subtree size when
+*		AVL_ORDER_STATISTICS is on. The plain version is empty so
+*		nodes of trees without the option do not grow. It derives from
+*		AVLTreeNodeRefs for the same reason AVLTreeNodeCount derives from it.
+*
+*************************************************************************/
+template <bool Sized, bool Shared>
+class AVLTreeNodeSize : public AVLTreeNodeRefs<Shared>
+{
+};
+
+template <bool Shared>
+class AVLTreeNodeSize<true, Shared> : public AVLTreeNodeRefs<Shared>
+{
+public:
+	AVLTreeNodeSize() : m_size(1) {}
+
+	int m_size; //number of nodes in this subtree, including this one
+};
+
+/************************************************************************
+* Class: AVLTreeNodeCount
+*
+* Purpose: Base of AVLTreeNode that holds how many equal items the node
+*		stands for when AVL_COUNTED is on. It derives from AVLTreeNodeSize
+*		instead of sitting next to it, so a plain node has a single empty
+*		base and still takes no extra space.
+*
+* Methods:
+* int CopyCount() const;
+*		Returns m_count, always 1 without AVL_COUNTED
+*
+*************************************************************************/
+template <bool Counted, bool Sized, bool Shared>
+class AVLTreeNodeCount : public AVLTreeNodeSize<Sized, Shared>
+{
+public:
+	int CopyCount() const { return 1; }
+};
+
+template <bool Sized, bool Shared>
+class AVLTreeNodeCount<true, Sized, Shared> : public AVLTreeNodeSize<Sized, Shared>
+{
+public:
+	AVLTreeNodeCount() : m_count(1) {}
+
+	int CopyCount() const { return m_count; }
+
+	int m_count; //number of equal items in this node
+};
+
 /************************************************************************
 * Class: AVLTreeNode
 *
 * Purpose: This class represents an AVLTreeNode used in an AVLTree
+*		Options are the AVL_OPTIONS of the owning tree, they pick which
+*		optional fields (the subtree size, the copy count, the reference
+*		count) the node carries
 * Manager functions:
-* AVLTreeNode();
-* AVLTreeNode(T data);
-* AVLTreeNode(const AVLTreeNode<T>& copy);
-* AVLTreeNode<T>& operator=(const AVLTreeNode<T>& rhs);
+* AVLTreeNode();
+* template <typename... Args> AVLTreeNode(InPlace, Args&&... args);
+*		Constructs m_data from args (copied, moved or emplaced by the tree)
+* AVLTreeNode(const AVLTreeNode<T, Options>& copy);
+* AVLTreeNode<T, Options>& operator=(const AVLTreeNode<T, Options>& rhs);
 * ~AVLTreeNode();
 *
 * Methods:
-* const T& GetData() const;
-*		Gets m_data
-* void SetData(T data);
-*		Sets m_data
-* AVLTreeNode<T>* GetLeft() const;
-*		Gets m_left
-* void SetLeft(AVLTreeNode<T>* left);
-*		Sets m_left
-* AVLTreeNode<T>* GetRight() const;
-*		Gets m_right
-* void SetRight(AVLTreeNode<T>* right);
-*		Sets m_right
-* int GetBalance() const;
-*		Gets m_balance
+* const T& GetData() const;
+*		Gets m_data
+* void SetData(T data);
+*		Sets m_data
+* AVLTreeNode<T, Options>* GetLeft() const;
+*		Gets m_left
+* void SetLeft(AVLTreeNode<T, Options>* left);
+*		Sets m_left
+* AVLTreeNode<T, Options>* GetRight() const;
+*		Gets m_right
+* void SetRight(AVLTreeNode<T, Options>* right);
+*		Sets m_right
+* int GetBalance() const;
+*		Gets m_balance
 * void SetBalance(int balance);
 *		Sets m_balance
 *
 *
-*************************************************************************/
-template <typename T>
-class AVLTreeNode
-{
-	friend class AVLTree<T>;
-
-public:
-
-	enum BALANCE : int { LH = 1, EH = 0, RH = -1}; //LeftHeavy, EqualHeavy, RightHeavy
-
-	const T& GetData() const;
-	void SetData(T data);
-	AVLTreeNode<T>* GetLeft() const;
-	void SetLeft(AVLTreeNode<T>* left);
-	AVLTreeNode<T>* GetRight() const;
-	void SetRight(AVLTreeNode<T>* right);
-	int GetBalance() const;
-	void SetBalance(int balance);
-
-private:
-	AVLTreeNode();
-	AVLTreeNode(T data);
-	AVLTreeNode(const AVLTreeNode<T>& copy);
-	AVLTreeNode<T>& operator=(const AVLTreeNode<T>& rhs);
-	~AVLTreeNode();
-
-	T m_data;
-	int m_balance;
-	AVLTreeNode<T>* m_left;
-	AVLTreeNode<T>* m_right;
-};
-
-
-/// Function Code ///
-
-template<typename T>
-inline const T& AVLTreeNode<T>::GetData() const
-{
-	return m_data;
-}
-
-template<typename T>
-inline void AVLTreeNode<T>::SetData(T data)
-{
-	m_data = data;
-}
-
-template<typename T>
-inline AVLTreeNode<T> * AVLTreeNode<T>::GetLeft() const
-{
-	return m_left;
-}
-
-template<typename T>
-inline void AVLTreeNode<T>::SetLeft(AVLTreeNode<T>* left)
-{
-	m_left = left;
-}
-
-template<typename T>
-inline AVLTreeNode<T>* AVLTreeNode<T>::GetRight() const
-{
-	return m_right;
-}
-
-template<typename T>
-inline void AVLTreeNode<T>::SetRight(AVLTreeNode<T>* right)
-{
-	m_right = right;
-}
-
-template<typename T>
-inline int AVLTreeNode<T>::GetBalance() const
-{
-	return m_balance;
-}
-
-template<typename T>
-inline void AVLTreeNode<T>::SetBalance(int balance)
-{
-	m_balance = balance;
-}
-
-
-
-template<typename T>
-inline AVLTreeNode<T>::AVLTreeNode() : m_data(T()), m_balance(EH), m_left(nullptr), m_right(nullptr)
-{
-}
-
-template<typename T>
-inline AVLTreeNode<T>::AVLTreeNode(T data) : m_data(data), m_balance(EH), m_left(nullptr), m_right(nullptr)
-{
-}
-
-template<typename T>
-inline AVLTreeNode<T>::AVLTreeNode(const AVLTreeNode<T>& copy) : m_data(copy.m_data), m_balance(copy.m_balance), m_left(nullptr), m_right(nullptr)
-{
-}
-
-template<typename T>
-inline AVLTreeNode<T>& AVLTreeNode<T>::operator=(const AVLTreeNode<T>& rhs)
-{
-	if (this != &rhs)
-	{
-		//nothing to delete
-
-		m_data = rhs.m_data;
-		m_balance = rhs.m_balance;
-		m_left = nullptr;
-		m_right = nullptr;
-	}
-
-	return *this;
-}
-
-template<typename T>
-inline AVLTreeNode<T>::~AVLTreeNode()
-{
-	//No deletes
-
-	//Default values
-	m_data = T();
-	m_balance = EH;
-	m_left = nullptr;
-	m_right = nullptr;
-}
+*************************************************************************/
+template <typename T, unsigned Options = AVL_PLAIN>
+class AVLTreeNode : private AVLTreeNodeCount<(Options & AVL_COUNTED) != 0, (Options & AVL_ORDER_STATISTICS) != 0, (Options & AVL_COPY_ON_WRITE) != 0>
+{
+	template <typename U, template <typename> class Allocator, unsigned O>
+	friend class AVLTree;
+	template <typename K, typename V, template <typename> class Allocator, unsigned O>
+	friend class AVLMap;
+
+public:
+
+	enum BALANCE : int { LH = 1, EH = 0, RH = -1}; //LeftHeavy, EqualHeavy, RightHeavy
+
+	const T& GetData() const;
+	void SetData(T data);
+	AVLTreeNode<T, Options>* GetLeft() const;
+	void SetLeft(AVLTreeNode<T, Options>* left);
+	AVLTreeNode<T, Options>* GetRight() const;
+	void SetRight(AVLTreeNode<T, Options>* right);
+	int GetBalance() const;
+	void SetBalance(int balance);
+
+private:
+	struct InPlace {}; //picks the forwarding constructor over the copy constructor
+
+	AVLTreeNode();
+	template <typename... Args> AVLTreeNode(InPlace, Args&&... args);
+	AVLTreeNode(const AVLTreeNode<T, Options>& copy);
+	AVLTreeNode<T, Options>& operator=(const AVLTreeNode<T, Options>& rhs);
+	~AVLTreeNode();
+
+	T m_data;
+	int m_balance;
+	AVLTreeNode<T, Options>* m_left;
+	AVLTreeNode<T, Options>* m_right;
+};
+
+
+/// Function Code ///
+
+template<typename T, unsigned Options>
+inline const T& AVLTreeNode<T, Options>::GetData() const
+{
+	return m_data;
+}
+
+template<typename T, unsigned Options>
+inline void AVLTreeNode<T, Options>::SetData(T data)
+{
+	m_data = data;
+}
+
+template<typename T, unsigned Options>
+inline AVLTreeNode<T, Options> * AVLTreeNode<T, Options>::GetLeft() const
+{
+	return m_left;
+}
+
+template<typename T, unsigned Options>
+inline void AVLTreeNode<T, Options>::SetLeft(AVLTreeNode<T, Options>* left)
+{
+	m_left = left;
+}
+
+template<typename T, unsigned Options>
+inline AVLTreeNode<T, Options>* AVLTreeNode<T, Options>::GetRight() const
+{
+	return m_right;
+}
+
+template<typename T, unsigned Options>
+inline void AVLTreeNode<T, Options>::SetRight(AVLTreeNode<T, Options>* right)
+{
+	m_right = right;
+}
+
+template<typename T, unsigned Options>
+inline int AVLTreeNode<T, Options>::GetBalance() const
+{
+	return m_balance;
+}
+
+template<typename T, unsigned Options>
+inline void AVLTreeNode<T, Options>::SetBalance(int balance)
+{
+	m_balance = balance;
+}
+
+
+
+template<typename T, unsigned Options>
+inline AVLTreeNode<T, Options>::AVLTreeNode() : m_data(), m_balance(EH), m_left(nullptr), m_right(nullptr)
+{
+}
+
+template<typename T, unsigned Options>
+template<typename... Args>
+inline AVLTreeNode<T, Options>::AVLTreeNode(InPlace, Args&&... args) : m_data(std::forward<Args>(args)...), m_balance(EH), m_left(nullptr), m_right(nullptr)
+{
+}
+
+template<typename T, unsigned Options>
+inline AVLTreeNode<T, Options>::AVLTreeNode(const AVLTreeNode<T, Options>& copy) : AVLTreeNodeCount<(Options & AVL_COUNTED) != 0, (Options & AVL_ORDER_STATISTICS) != 0, (Options & AVL_COPY_ON_WRITE) != 0>(copy), m_data(copy.m_data), m_balance(copy.m_balance), m_left(nullptr), m_right(nullptr)
+{
+}
+
+template<typename T, unsigned Options>
+inline AVLTreeNode<T, Options>& AVLTreeNode<T, Options>::operator=(const AVLTreeNode<T, Options>& rhs)
+{
+	if (this != &rhs)
+	{
+		//nothing to delete
+
+		AVLTreeNodeCount<(Options & AVL_COUNTED) != 0, (Options & AVL_ORDER_STATISTICS) != 0, (Options & AVL_COPY_ON_WRITE) != 0>::operator=(rhs);
+		m_data = rhs.m_data;
+		m_balance = rhs.m_balance;
+		m_left = nullptr;
+		m_right = nullptr;
+	}
+
+	return *this;
+}
+
+template<typename T, unsigned Options>
+inline AVLTreeNode<T, Options>::~AVLTreeNode()
+{
+	//No deletes
+
+	//Default values (m_data is destroyed right after this, resetting it would only cost a copy)
+	m_balance = EH;
+	m_left = nullptr;
+	m_right = nullptr;
+}
@@ -0,0 +1,157 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: AVLTreeReverseIterator.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include "AVLTreeIterator.h"
+
+/************************************************************************
+* Class: AVLTreeReverseIterator
+*
+* Purpose: This class is the reverse in-order iterator of an AVLTree. It
+*		works like std::reverse_iterator over AVLTreeIterator, but it
+*		keeps its forward iterator on the item it refers to rather than
+*		one past it. std::reverse_iterator copies its whole forward
+*		iterator (path array included) on every dereference; this one
+*		reads the item straight from its own path.
+*
+* Manager functions:
+* AVLTreeReverseIterator();
+*		Creates an iterator that is not attached to any tree
+* explicit AVLTreeReverseIterator(const AVLTreeIterator<T, Options, Node>& base);
+*		Creates an iterator to the item before base, like std::reverse_iterator
+*
+* Methods:
+* const T& operator*() const; / const T* operator->() const;
+*		Returns the current item
+* AVLTreeReverseIterator& operator++(); / AVLTreeReverseIterator operator++(int);
+*		Moves to the previous item in order, or to the reverse end
+* AVLTreeReverseIterator& operator--(); / AVLTreeReverseIterator operator--(int);
+*		Moves to the next item in order, decrementing the reverse end moves to the first item
+* AVLTreeIterator<T, Options, Node> base() const;
+*		Returns the forward iterator one past the current item, like std::reverse_iterator
+* bool operator==(const AVLTreeReverseIterator& rhs) const; / operator!=
+*		Returns true if both iterators are on the same node (or both at the reverse end)
+*
+*************************************************************************/
+template <typename T, unsigned Options = AVL_PLAIN, typename Node = AVLTreeNode<T, Options>>
+class AVLTreeReverseIterator
+{
+public:
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const T* pointer;
+	typedef const T& reference;
+
+	AVLTreeReverseIterator();
+	explicit AVLTreeReverseIterator(const AVLTreeIterator<T, Options, Node>& base);
+
+	const T& operator*() const;
+	const T* operator->() const;
+	AVLTreeReverseIterator<T, Options, Node>& operator++();
+	AVLTreeReverseIterator<T, Options, Node> operator++(int);
+	AVLTreeReverseIterator<T, Options, Node>& operator--();
+	AVLTreeReverseIterator<T, Options, Node> operator--(int);
+	AVLTreeIterator<T, Options, Node> base() const;
+	bool operator==(const AVLTreeReverseIterator<T, Options, Node>& rhs) const;
+	bool operator!=(const AVLTreeReverseIterator<T, Options, Node>& rhs) const;
+
+private:
+	AVLTreeIterator<T, Options, Node> m_current; //on the current item, at its end while this is at the reverse end
+};
+
+
+/// Function Code ///
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeReverseIterator<T, Options, Node>::AVLTreeReverseIterator()
+{
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeReverseIterator<T, Options, Node>::AVLTreeReverseIterator(const AVLTreeIterator<T, Options, Node>& base) : m_current(base)
+{
+	//decrementing the first item lands on the end, which stands for the reverse end here
+	--m_current;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline const T& AVLTreeReverseIterator<T, Options, Node>::operator*() const
+{
+	return *m_current;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline const T* AVLTreeReverseIterator<T, Options, Node>::operator->() const
+{
+	return m_current.operator->();
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeReverseIterator<T, Options, Node>& AVLTreeReverseIterator<T, Options, Node>::operator++()
+{
+	--m_current;
+
+	return *this;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeReverseIterator<T, Options, Node> AVLTreeReverseIterator<T, Options, Node>::operator++(int)
+{
+	AVLTreeReverseIterator<T, Options, Node> temp(*this);
+	--m_current;
+
+	return temp;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeReverseIterator<T, Options, Node>& AVLTreeReverseIterator<T, Options, Node>::operator--()
+{
+	if (m_current.m_depth == 0)
+		m_current.SeekFirst();
+	else
+		++m_current;
+
+	return *this;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeReverseIterator<T, Options, Node> AVLTreeReverseIterator<T, Options, Node>::operator--(int)
+{
+	AVLTreeReverseIterator<T, Options, Node> temp(*this);
+	--(*this);
+
+	return temp;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline AVLTreeIterator<T, Options, Node> AVLTreeReverseIterator<T, Options, Node>::base() const
+{
+	AVLTreeIterator<T, Options, Node> next(m_current);
+
+	if (next.m_depth == 0)
+		next.SeekFirst();
+	else
+		++next;
+
+	return next;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline bool AVLTreeReverseIterator<T, Options, Node>::operator==(const AVLTreeReverseIterator<T, Options, Node>& rhs) const
+{
+	return m_current == rhs.m_current;
+}
+
+template<typename T, unsigned Options, typename Node>
+inline bool AVLTreeReverseIterator<T, Options, Node>::operator!=(const AVLTreeReverseIterator<T, Options, Node>& rhs) const
+{
+	return !(*this == rhs);
+}
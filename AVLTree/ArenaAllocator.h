@@ -0,0 +1,306 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: ArenaAllocator.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - Added Reserve for bulk builds
+*		- 10/17/2026 - Added Adopt so trees can take over each other's nodes
+*		- 10/17/2026 - Adopt is O(1): the lists keep their tails and unused chunk tails are kept as ranges
+*		- 10/17/2026 - Added Swap so moving a tree hands its arena over whole
+**************************************************************/
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+/************************************************************************
+* Class: ArenaAllocator
+*
+* Purpose: This class hands out storage for Node objects from large
+*		contiguous chunks. Freed blocks go on a free list and are reused
+*		by the next Allocate, and every chunk is given back at once by
+*		Release. It only manages memory; the caller constructs and
+*		destroys the Nodes.
+*		The free list and the chunk list remember their last block, and
+*		the unused end of a chunk is kept as one range rather than block
+*		by block, so Adopt splices another arena in O(1) however many
+*		free blocks it has.
+*
+* Manager functions:
+* ArenaAllocator();
+* ~ArenaAllocator();
+*		Releases every chunk
+*
+* Methods:
+* void* Allocate();
+*		Returns storage for one Node, growing the arena if the free list is empty
+* void Deallocate(void* block);
+*		Puts a block back on the free list
+* void Reserve(int count);
+*		Makes sure the next count Allocates come from one contiguous chunk (or the free list)
+* void Release();
+*		Frees every chunk at once. Any Node still in the arena is invalid afterwards
+* void Adopt(ArenaAllocator<Node>& other);
+*		Takes over every chunk and free block of other in O(1), leaving it empty. Nodes
+*		built in other stay valid and are now owned by this arena
+* void Swap(ArenaAllocator<Node>& other);
+*		Exchanges every chunk and free block with other in O(1). Moves use it so the
+*		arena keeps its chunk size instead of starting over
+*
+* --- HELPER FUNCTIONS ---
+* void Grow(int count);
+*		Adds a chunk of count blocks and makes it the one Allocate cuts from
+* void PushRange(Block* first, Block* last);
+*		Keeps the unused blocks [first, last) as a range for later
+* void TakeRange();
+*		Makes the first kept range the one Allocate cuts from
+*
+* Constants:
+* RELEASES_ALL
+*		true, Release frees every block so the owner does not need to
+*		Deallocate nodes one by one before it
+*
+*************************************************************************/
+template <typename Node>
+class ArenaAllocator
+{
+public:
+	static const bool RELEASES_ALL = true;
+
+	ArenaAllocator();
+	~ArenaAllocator();
+
+	void* Allocate();
+	void Deallocate(void* block);
+	void Reserve(int count);
+	void Release();
+	void Adopt(ArenaAllocator<Node>& other);
+	void Swap(ArenaAllocator<Node>& other);
+
+private:
+	ArenaAllocator(const ArenaAllocator<Node>& copy);
+	ArenaAllocator<Node>& operator=(const ArenaAllocator<Node>& rhs);
+
+	union Block;
+
+	struct Range
+	{
+		Block* m_next; //next range
+		Block* m_end; //one past the last block of this range
+	};
+
+	union Block
+	{
+		Block* m_next;
+		Range m_range; //in the first block of an unused range
+		typename std::aligned_storage<sizeof(Node), alignof(Node)>::type m_storage;
+	};
+
+	enum CHUNK : int { FIRST_CHUNK = 64, MAX_CHUNK = 8192 }; //blocks per chunk, doubled up to MAX_CHUNK
+
+	void Grow(int count);
+	void PushRange(Block* first, Block* last);
+	void TakeRange();
+
+	Block* m_chunks; //the first block of every chunk links to the next chunk
+	Block* m_lastChunk;
+	Block* m_free;
+	Block* m_lastFree; //only meaningful while m_free is not empty
+	Block* m_ranges; //unused ends of chunks, each one kept in its first block
+	Block* m_lastRange; //only meaningful while m_ranges is not empty
+	Block* m_next; //bump pointer into the range Allocate cuts from
+	Block* m_end;
+	int m_chunkSize;
+};
+
+
+/// Function Code ///
+
+template<typename Node>
+inline ArenaAllocator<Node>::ArenaAllocator() : m_chunks(nullptr), m_lastChunk(nullptr), m_free(nullptr), m_lastFree(nullptr),
+	m_ranges(nullptr), m_lastRange(nullptr), m_next(nullptr), m_end(nullptr), m_chunkSize(FIRST_CHUNK)
+{
+}
+
+template<typename Node>
+inline ArenaAllocator<Node>::~ArenaAllocator()
+{
+	Release();
+}
+
+template<typename Node>
+inline void* ArenaAllocator<Node>::Allocate()
+{
+	if (m_free != nullptr)
+	{
+		Block* block = m_free;
+		m_free = block->m_next;
+
+		return block;
+	}
+
+	if (m_next == m_end)
+	{
+		if (m_ranges != nullptr)
+			TakeRange();
+		else
+			Grow(m_chunkSize);
+	}
+
+	return m_next++;
+}
+
+template<typename Node>
+inline void ArenaAllocator<Node>::Deallocate(void* block)
+{
+	Block* freed = static_cast<Block*>(block);
+	freed->m_next = m_free;
+
+	if (m_free == nullptr)
+		m_lastFree = freed;
+
+	m_free = freed;
+}
+
+template<typename Node>
+inline void ArenaAllocator<Node>::Reserve(int count)
+{
+	//blocks already on the free list or left in the newest chunk count too
+	for (Block* block = m_free; block != nullptr && count > 0; block = block->m_next)
+		--count;
+
+	count -= static_cast<int>(m_end - m_next);
+
+	if (count > 0)
+		Grow(count);
+}
+
+template<typename Node>
+inline void ArenaAllocator<Node>::Release()
+{
+	while (m_chunks != nullptr)
+	{
+		Block* next = m_chunks->m_next;
+		delete[] m_chunks;
+		m_chunks = next;
+	}
+
+	//Default values
+	m_lastChunk = nullptr;
+	m_free = nullptr;
+	m_lastFree = nullptr;
+	m_ranges = nullptr;
+	m_lastRange = nullptr;
+	m_next = nullptr;
+	m_end = nullptr;
+	m_chunkSize = FIRST_CHUNK;
+}
+
+template<typename Node>
+inline void ArenaAllocator<Node>::Adopt(ArenaAllocator<Node>& other)
+{
+	if (this == &other || other.m_chunks == nullptr)
+		return;
+
+	//the unused end of other's current range is still good storage
+	other.PushRange(other.m_next, other.m_end);
+
+	//splice other's free list in front of ours
+	if (other.m_free != nullptr)
+	{
+		other.m_lastFree->m_next = m_free;
+		if (m_free == nullptr)
+			m_lastFree = other.m_lastFree;
+
+		m_free = other.m_free;
+	}
+
+	//its ranges
+	if (other.m_ranges != nullptr)
+	{
+		other.m_lastRange->m_range.m_next = m_ranges;
+		if (m_ranges == nullptr)
+			m_lastRange = other.m_lastRange;
+
+		m_ranges = other.m_ranges;
+	}
+
+	//and its chunk list
+	other.m_lastChunk->m_next = m_chunks;
+	if (m_chunks == nullptr)
+		m_lastChunk = other.m_lastChunk;
+
+	m_chunks = other.m_chunks;
+
+	//Default values
+	other.m_chunks = nullptr;
+	other.m_lastChunk = nullptr;
+	other.m_free = nullptr;
+	other.m_lastFree = nullptr;
+	other.m_ranges = nullptr;
+	other.m_lastRange = nullptr;
+	other.m_next = nullptr;
+	other.m_end = nullptr;
+	other.m_chunkSize = FIRST_CHUNK;
+}
+
+template<typename Node>
+inline void ArenaAllocator<Node>::Swap(ArenaAllocator<Node>& other)
+{
+	std::swap(m_chunks, other.m_chunks);
+	std::swap(m_lastChunk, other.m_lastChunk);
+	std::swap(m_free, other.m_free);
+	std::swap(m_lastFree, other.m_lastFree);
+	std::swap(m_ranges, other.m_ranges);
+	std::swap(m_lastRange, other.m_lastRange);
+	std::swap(m_next, other.m_next);
+	std::swap(m_end, other.m_end);
+	std::swap(m_chunkSize, other.m_chunkSize);
+}
+
+template<typename Node>
+inline void ArenaAllocator<Node>::Grow(int count)
+{
+	Block* chunk = new Block[count + 1];
+
+	//whatever is left of the current range is kept so it is not lost
+	PushRange(m_next, m_end);
+
+	chunk->m_next = m_chunks;
+	if (m_chunks == nullptr)
+		m_lastChunk = chunk;
+
+	m_chunks = chunk;
+
+	m_next = chunk + 1;
+	m_end = m_next + count;
+
+	if (m_chunkSize < MAX_CHUNK)
+		m_chunkSize *= 2;
+}
+
+template<typename Node>
+inline void ArenaAllocator<Node>::PushRange(Block* first, Block* last)
+{
+	if (first == last)
+		return;
+
+	first->m_range.m_next = m_ranges;
+	first->m_range.m_end = last;
+
+	if (m_ranges == nullptr)
+		m_lastRange = first;
+
+	m_ranges = first;
+}
+
+template<typename Node>
+inline void ArenaAllocator<Node>::TakeRange()
+{
+	Block* range = m_ranges;
+
+	m_ranges = range->m_range.m_next;
+	m_end = range->m_range.m_end;
+	m_next = range;
+}
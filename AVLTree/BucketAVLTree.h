@@ -0,0 +1,1019 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: BucketAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+using std::max;
+using std::min;
+#include "AVLTreeNode.h"
+#include "ArenaAllocator.h"
+#include "BucketAVLTreeNode.h"
+#include "Exception.h"
+
+/************************************************************************
+* Class: BucketAVLTree
+*
+* Purpose: This class is an AVLTree whose nodes are sorted buckets of up
+*		to BucketSize items instead of single items. The nodes are kept
+*		AVL balanced the same way, and every item of a left subtree is
+*		not greater than the smallest item of the bucket above it (and
+*		the right side mirrors that). A search compares against the two
+*		ends of a bucket per level and then searches inside the one bucket
+*		that can hold the item, so it visits log(n / BucketSize) nodes,
+*		and a scan reads whole buckets from contiguous memory.
+*		Insert puts an item into the bucket its search ends at. A full
+*		bucket is split in half, so a node is allocated about once per
+*		BucketSize / 2 inserts at random and once per BucketSize inserts
+*		in order. Delete merges a bucket that fell below a quarter full
+*		with its in-order neighbour when both fit in one, and a bucket
+*		that empties is removed from the tree.
+*		Equal items are kept, like AVLTree.
+*
+* Manager functions:
+* BucketAVLTree();
+* BucketAVLTree(const BucketAVLTree<T, BucketSize, Allocator>& copy);
+*		Copies every bucket in O(n)
+* BucketAVLTree(BucketAVLTree<T, BucketSize, Allocator>&& other);
+*		Takes over the buckets of other, leaving it empty
+* ~BucketAVLTree();
+* BucketAVLTree<T, BucketSize, Allocator>& operator=(const BucketAVLTree<T, BucketSize, Allocator>& rhs);
+* BucketAVLTree<T, BucketSize, Allocator>& operator=(BucketAVLTree<T, BucketSize, Allocator>&& rhs);
+*
+* Methods:
+* void Insert(const T& data); / void Insert(T&& data);
+*		Inserts data into the tree
+* void Delete(const T& data);
+*		Deletes one equivalent item from the tree, throws if there is none
+* void Purge();
+*		Removes every item
+* int Height() const;
+*		returns the height of the tree (in buckets) in O(1)
+* int Size() const;
+*		returns the number of items in the tree in O(1)
+* int BucketCount() const;
+*		returns the number of buckets (nodes) in O(1)
+*
+* Lookups:
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* const T* Find(const T& data) const;
+*		Returns a pointer to the stored equivalent data, or nullptr. It is valid until the next change
+* const T* Floor(const T& data) const;
+*		Returns the largest item that is not greater than data, or nullptr
+* const T* Ceiling(const T& data) const;
+*		Returns the smallest item that is not less than data, or nullptr
+*
+* Testing:
+* bool IsEmpty() const;
+*		Returns true if the tree is empty
+* bool IsBalanced() const;
+*		Returns true if all balance factors are between -1 and 1
+*
+* Traversals:
+* template <typename Visitor> bool InOrder(Visitor visit);
+*		Calls visit with every item in order. If visit returns a bool, returning false stops
+*		the traversal. Returns false if it was stopped, true if it finished
+*
+* --- HELPER FUNCTIONS ---
+* void CopyTree(Node*& root, const Node* copyRoot);
+*		Helps the copy constructor by recursively copying buckets
+* int PurgeNodes(Node* root);
+*		Destroys and deallocates every node under root and returns how many there were
+* Node* CreateNode(); / Node* CreateNode(const Node& copy);
+*		Constructs an empty bucket (or a copy of one) in storage from m_alloc
+* void DestroyNode(Node* node);
+*		Destroys a bucket and gives its storage back to m_alloc
+* template <typename U> void InsertItem(Node*& root, U&& data, bool& taller);
+*		Helps Insert by recursively finding the bucket for data, splitting it if it is full
+* void InsertLeftmost(Node*& root, Node* node, bool& taller);
+*		Links node as the first bucket of the subtree at root, used for the upper half of a split
+* void DeleteItem(Node*& root, const T& data, bool& shorter);
+*		Helps Delete by recursively removing data and merging or removing drained buckets
+* bool AbsorbLeaf(Node* root, Node*& leaf, bool front);
+*		Merges a drained leaf child into root if both fit in one bucket. Returns true if it did
+* void Refill(Node*& root, bool& shorter);
+*		Merges a drained bucket with its in-order neighbour if both fit in one bucket
+* void Unlink(Node*& root, bool& shorter);
+*		Removes an empty bucket from the tree, its predecessor takes its place
+* Node* RemoveMaxNode(Node*& root, bool& shorter); / Node* RemoveMinNode(Node*& root, bool& shorter);
+*		Unlinks and returns the last / first bucket of the subtree at root
+* void LeftTaller(Node*& root, bool& taller); / void RightTaller(Node*& root, bool& taller);
+*		Fixes the balance of "root" after one side got taller
+* void LeftShorter(Node*& root, bool& shorter); / void RightShorter(Node*& root, bool& shorter);
+*		Fixes the balance of "root" after one side got shorter
+* void LLRotation(Node*& root); / void RRRotation(Node*& root);
+*		Rotates right / left around root
+* const Node* FindBucket(const T& data) const;
+*		Returns the bucket whose range holds data, or nullptr
+* static int LowerBoundIn(const Node* node, const T& data); / static int UpperBoundIn(const Node* node, const T& data);
+*		Returns the first slot of a bucket not less than / greater than data
+* bool IsBalancedNode(const Node* root) const;
+*		Checks the balance factors of the subtree at root
+* template <typename Visitor> static bool Visit(Visitor& visit, T& data);
+*		Calls visit and turns its result into "keep going"
+*
+*************************************************************************/
+template <typename T, int BucketSize = 16, template <typename> class Allocator = ArenaAllocator>
+class BucketAVLTree
+{
+public:
+	BucketAVLTree();
+	BucketAVLTree(const BucketAVLTree<T, BucketSize, Allocator>& copy);
+	BucketAVLTree(BucketAVLTree<T, BucketSize, Allocator>&& other);
+	~BucketAVLTree();
+	BucketAVLTree<T, BucketSize, Allocator>& operator=(const BucketAVLTree<T, BucketSize, Allocator>& rhs);
+	BucketAVLTree<T, BucketSize, Allocator>& operator=(BucketAVLTree<T, BucketSize, Allocator>&& rhs);
+
+	//Methods
+	void Insert(const T& data); //Inserts data into the tree
+	void Insert(T&& data); //Inserts data into the tree, moving it into a bucket
+	void Delete(const T& data); //Deletes one equivalent item from the tree
+	void Purge(); //Removes every item
+	int Height() const; //returns the height of the tree
+	int Size() const; //returns the number of items in the tree
+	int BucketCount() const; //returns the number of buckets
+
+	//Lookups
+	bool Contains(const T& data) const;
+	const T* Find(const T& data) const;
+	const T* Floor(const T& data) const;
+	const T* Ceiling(const T& data) const;
+
+	//Testing
+	bool IsEmpty() const;
+	bool IsBalanced() const;
+
+	//Traversals
+	template <typename Visitor> bool InOrder(Visitor visit);
+
+private:
+	static_assert(BucketSize >= 4, "BucketSize has to be at least 4, so a split leaves two usable halves");
+
+	typedef BucketAVLTreeNode<T, BucketSize> Node;
+
+	enum FILL : int { MIN_FILL = BucketSize / 4 }; //a bucket below this merges with a neighbour when they fit
+
+	void CopyTree(Node*& root, const Node* copyRoot);
+	int PurgeNodes(Node* root);
+	Node* CreateNode();
+	Node* CreateNode(const Node& copy);
+	void DestroyNode(Node* node);
+
+	template <typename U> void InsertItem(Node*& root, U&& data, bool& taller);
+	void InsertLeftmost(Node*& root, Node* node, bool& taller);
+	void DeleteItem(Node*& root, const T& data, bool& shorter);
+	bool AbsorbLeaf(Node* root, Node*& leaf, bool front);
+	void Refill(Node*& root, bool& shorter);
+	void Unlink(Node*& root, bool& shorter);
+	Node* RemoveMaxNode(Node*& root, bool& shorter);
+	Node* RemoveMinNode(Node*& root, bool& shorter);
+	void LeftTaller(Node*& root, bool& taller);
+	void RightTaller(Node*& root, bool& taller);
+	void LeftShorter(Node*& root, bool& shorter);
+	void RightShorter(Node*& root, bool& shorter);
+	void LLRotation(Node*& root);
+	void RRRotation(Node*& root);
+
+	const Node* FindBucket(const T& data) const;
+	static int LowerBoundIn(const Node* node, const T& data);
+	static int UpperBoundIn(const Node* node, const T& data);
+	bool IsBalancedNode(const Node* root) const;
+
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data);
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data, std::true_type);
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data, std::false_type);
+
+	Node* m_root;
+	int m_numElements;
+	int m_numBuckets;
+	int m_height; //taller/shorter at the root tell Insert and Delete when this changes
+	Allocator<Node> m_alloc;
+};
+
+
+/// Function Code ///
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline BucketAVLTree<T, BucketSize, Allocator>::BucketAVLTree() : m_root(nullptr), m_numElements(0), m_numBuckets(0), m_height(0)
+{
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline BucketAVLTree<T, BucketSize, Allocator>::BucketAVLTree(const BucketAVLTree<T, BucketSize, Allocator>& copy) : m_root(nullptr), m_numElements(0), m_numBuckets(0), m_height(0)
+{
+	if (!copy.IsEmpty())
+	{
+		CopyTree(m_root, copy.m_root);
+		m_numElements = copy.m_numElements;
+		m_height = copy.m_height;
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline BucketAVLTree<T, BucketSize, Allocator>::BucketAVLTree(BucketAVLTree<T, BucketSize, Allocator>&& other) : m_root(other.m_root), m_numElements(other.m_numElements),
+	m_numBuckets(other.m_numBuckets), m_height(other.m_height)
+{
+	m_alloc.Swap(other.m_alloc);
+
+	//Default values
+	other.m_root = nullptr;
+	other.m_numElements = 0;
+	other.m_numBuckets = 0;
+	other.m_height = 0;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline BucketAVLTree<T, BucketSize, Allocator>::~BucketAVLTree()
+{
+	Purge();
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline BucketAVLTree<T, BucketSize, Allocator>& BucketAVLTree<T, BucketSize, Allocator>::operator=(const BucketAVLTree<T, BucketSize, Allocator>& rhs)
+{
+	if (this != &rhs)
+	{
+		Purge();
+
+		//copy
+		if (!rhs.IsEmpty())
+		{
+			CopyTree(m_root, rhs.m_root);
+			m_numElements = rhs.m_numElements;
+			m_height = rhs.m_height;
+		}
+	}
+
+	return *this;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline BucketAVLTree<T, BucketSize, Allocator>& BucketAVLTree<T, BucketSize, Allocator>::operator=(BucketAVLTree<T, BucketSize, Allocator>&& rhs)
+{
+	if (this != &rhs)
+	{
+		Purge();
+
+		//move
+		m_root = rhs.m_root;
+		m_numElements = rhs.m_numElements;
+		m_numBuckets = rhs.m_numBuckets;
+		m_height = rhs.m_height;
+		m_alloc.Swap(rhs.m_alloc); //Purge left ours without buckets
+
+		//Default values
+		rhs.m_root = nullptr;
+		rhs.m_numElements = 0;
+		rhs.m_numBuckets = 0;
+		rhs.m_height = 0;
+	}
+
+	return *this;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::Insert(const T & data)
+{
+	bool taller = false;
+	InsertItem(m_root, data, taller);
+	++m_numElements;
+
+	if (taller)
+		++m_height;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::Insert(T && data)
+{
+	bool taller = false;
+	InsertItem(m_root, std::move(data), taller);
+	++m_numElements;
+
+	if (taller)
+		++m_height;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::Delete(const T & data)
+{
+	if (IsEmpty())
+		throw Exception("Tried to delete from empty tree");
+
+	bool shorter = false;
+	DeleteItem(m_root, data, shorter);
+	--m_numElements;
+
+	if (shorter)
+		--m_height;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::Purge()
+{
+	if (m_root != nullptr)
+	{
+		//An arena can drop every node at once when there are no destructors to run
+		if (!(Allocator<Node>::RELEASES_ALL && std::is_trivially_destructible<T>::value))
+			PurgeNodes(m_root);
+
+		m_alloc.Release();
+	}
+
+	//Default values
+	m_root = nullptr;
+	m_numElements = 0;
+	m_numBuckets = 0;
+	m_height = 0;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline int BucketAVLTree<T, BucketSize, Allocator>::Height() const
+{
+	if (IsEmpty())
+		throw Exception("Tried to get height of empty tree");
+
+	return m_height;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline int BucketAVLTree<T, BucketSize, Allocator>::Size() const
+{
+	return m_numElements;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline int BucketAVLTree<T, BucketSize, Allocator>::BucketCount() const
+{
+	return m_numBuckets;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::Contains(const T & data) const
+{
+	return Find(data) != nullptr;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline const T* BucketAVLTree<T, BucketSize, Allocator>::Find(const T & data) const
+{
+	const Node* bucket = FindBucket(data);
+
+	if (bucket == nullptr)
+		return nullptr;
+
+	int slot = LowerBoundIn(bucket, data);
+
+	return (slot < bucket->Count() && !(data < bucket->Item(slot))) ? &bucket->Item(slot) : nullptr;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline const T* BucketAVLTree<T, BucketSize, Allocator>::Floor(const T & data) const
+{
+	const T* best = nullptr;
+	const Node* current = m_root;
+
+	while (current != nullptr)
+	{
+		if (data < current->Min())
+		{
+			current = current->m_left;
+		}
+		else if (!(data < current->Max()))
+		{
+			//everything here fits, something bigger can only be to the right
+			best = &current->Max();
+			current = current->m_right;
+		}
+		else
+		{
+			//Min <= data < Max, the answer is in this bucket
+			return &current->Item(UpperBoundIn(current, data) - 1);
+		}
+	}
+
+	return best;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline const T* BucketAVLTree<T, BucketSize, Allocator>::Ceiling(const T & data) const
+{
+	const T* best = nullptr;
+	const Node* current = m_root;
+
+	while (current != nullptr)
+	{
+		if (current->Max() < data)
+		{
+			current = current->m_right;
+		}
+		else if (!(current->Min() < data))
+		{
+			best = &current->Min();
+			current = current->m_left;
+		}
+		else
+		{
+			//Min < data <= Max, the answer is in this bucket
+			return &current->Item(LowerBoundIn(current, data));
+		}
+	}
+
+	return best;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::IsEmpty() const
+{
+	return m_numElements == 0;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::IsBalanced() const
+{
+	return IsBalancedNode(m_root);
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+template<typename Visitor>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::InOrder(Visitor visit)
+{
+	Node* path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	Node* current = m_root;
+
+	while (current != nullptr || depth > 0)
+	{
+		//go as far left as possible, then visit the whole bucket and step into the right subtree
+		while (current != nullptr)
+		{
+			path[depth++] = current;
+			current = current->m_left;
+		}
+
+		current = path[--depth];
+		for (int slot = 0; slot < current->Count(); ++slot)
+		{
+			if (!Visit(visit, current->Item(slot)))
+				return false;
+		}
+
+		current = current->m_right;
+	}
+
+	return true;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::CopyTree(Node*& root, const Node* copyRoot)
+{
+	if (copyRoot != nullptr)
+	{
+		root = CreateNode(*copyRoot);
+		CopyTree(root->m_left, copyRoot->m_left);
+		CopyTree(root->m_right, copyRoot->m_right);
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline int BucketAVLTree<T, BucketSize, Allocator>::PurgeNodes(Node* root)
+{
+	int count = 0;
+
+	if (root != nullptr)
+	{
+		count += PurgeNodes(root->m_left);
+		count += PurgeNodes(root->m_right);
+		DestroyNode(root);
+		++count;
+	}
+
+	return count;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline typename BucketAVLTree<T, BucketSize, Allocator>::Node* BucketAVLTree<T, BucketSize, Allocator>::CreateNode()
+{
+	Node* node = new (m_alloc.Allocate()) Node();
+	++m_numBuckets;
+
+	return node;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline typename BucketAVLTree<T, BucketSize, Allocator>::Node* BucketAVLTree<T, BucketSize, Allocator>::CreateNode(const Node& copy)
+{
+	void* block = m_alloc.Allocate();
+
+	try
+	{
+		Node* node = new (block) Node(copy);
+		++m_numBuckets;
+
+		return node;
+	}
+	catch (...)
+	{
+		m_alloc.Deallocate(block);
+		throw;
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::DestroyNode(Node* node)
+{
+	node->~Node();
+	m_alloc.Deallocate(node);
+	--m_numBuckets;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+template<typename U>
+inline void BucketAVLTree<T, BucketSize, Allocator>::InsertItem(Node*& root, U&& data, bool& taller)
+{
+	if (root == nullptr)
+	{
+		Node* node = CreateNode();
+
+		try
+		{
+			node->InsertAt(0, std::forward<U>(data));
+		}
+		catch (...)
+		{
+			DestroyNode(node);
+			throw;
+		}
+
+		root = node;
+		taller = true;
+	}
+	else if (data < root->Min())
+	{
+		//with no left child data is between this bucket and its predecessor, so it can go in front
+		if (root->m_left == nullptr && !root->IsFull())
+		{
+			root->InsertAt(0, std::forward<U>(data));
+			return;
+		}
+
+		InsertItem(root->m_left, std::forward<U>(data), taller);
+		if (taller)
+			LeftTaller(root, taller);
+	}
+	else if (root->Max() < data)
+	{
+		if (root->m_right == nullptr && !root->IsFull())
+		{
+			root->InsertAt(root->Count(), std::forward<U>(data));
+			return;
+		}
+
+		InsertItem(root->m_right, std::forward<U>(data), taller);
+		if (taller)
+			RightTaller(root, taller);
+	}
+	else if (!root->IsFull())
+	{
+		//after any equal items, like AVLTree puts equal items to the right
+		root->InsertAt(UpperBoundIn(root, data), std::forward<U>(data));
+	}
+	else
+	{
+		//data may be an item of this bucket, which the split moves
+		T item(std::forward<U>(data));
+		int slot = UpperBoundIn(root, item);
+
+		//the upper half becomes the in-order successor of this bucket
+		Node* upper = CreateNode();
+		root->SplitInto(*upper);
+
+		try
+		{
+			if (slot <= root->Count())
+				root->InsertAt(slot, std::move(item));
+			else
+				upper->InsertAt(slot - root->Count(), std::move(item));
+		}
+		catch (...)
+		{
+			root->TakeBack(*upper);
+			DestroyNode(upper);
+			throw;
+		}
+
+		InsertLeftmost(root->m_right, upper, taller);
+		if (taller)
+			RightTaller(root, taller);
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::InsertLeftmost(Node*& root, Node* node, bool& taller)
+{
+	if (root == nullptr)
+	{
+		root = node;
+		taller = true;
+	}
+	else
+	{
+		InsertLeftmost(root->m_left, node, taller);
+		if (taller)
+			LeftTaller(root, taller);
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::DeleteItem(Node*& root, const T & data, bool& shorter)
+{
+	if (root == nullptr)
+		throw Exception("Could not find item to delete from tree");
+
+	if (data < root->Min())
+	{
+		//data smaller, go left and fix this node if the left side lost height
+		DeleteItem(root->m_left, data, shorter);
+
+		//a drained leaf below is folded into this bucket, which takes a level off the left side
+		if (!shorter && AbsorbLeaf(root, root->m_left, true))
+			shorter = true;
+
+		if (shorter)
+			LeftShorter(root, shorter);
+	}
+	else if (root->Max() < data)
+	{
+		DeleteItem(root->m_right, data, shorter);
+
+		if (!shorter && AbsorbLeaf(root, root->m_right, false))
+			shorter = true;
+
+		if (shorter)
+			RightShorter(root, shorter);
+	}
+	else
+	{
+		int slot = LowerBoundIn(root, data);
+
+		if (slot == root->Count() || data < root->Item(slot))
+			throw Exception("Could not find item to delete from tree");
+
+		root->RemoveAt(slot);
+
+		if (root->Count() == 0)
+			Unlink(root, shorter);
+		else if (root->Count() < MIN_FILL)
+			Refill(root, shorter);
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::AbsorbLeaf(Node* root, Node*& leaf, bool front)
+{
+	if (leaf == nullptr || leaf->m_left != nullptr || leaf->m_right != nullptr ||
+		leaf->Count() >= MIN_FILL || leaf->Count() + root->Count() > BucketSize)
+		return false;
+
+	if (front)
+		root->TakeFront(*leaf);
+	else
+		root->TakeBack(*leaf);
+
+	DestroyNode(leaf);
+	leaf = nullptr;
+
+	return true;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::Refill(Node*& root, bool& shorter)
+{
+	if (root->m_left != nullptr)
+	{
+		//the predecessor is the last bucket of the left subtree
+		const Node* previous = root->m_left;
+		while (previous->m_right != nullptr)
+			previous = previous->m_right;
+
+		if (previous->Count() + root->Count() <= BucketSize)
+		{
+			Node* removed = RemoveMaxNode(root->m_left, shorter);
+			root->TakeFront(*removed);
+			DestroyNode(removed);
+
+			if (shorter)
+				LeftShorter(root, shorter);
+
+			return;
+		}
+	}
+
+	if (root->m_right != nullptr)
+	{
+		const Node* next = root->m_right;
+		while (next->m_left != nullptr)
+			next = next->m_left;
+
+		if (next->Count() + root->Count() <= BucketSize)
+		{
+			Node* removed = RemoveMinNode(root->m_right, shorter);
+			root->TakeBack(*removed);
+			DestroyNode(removed);
+
+			if (shorter)
+				RightShorter(root, shorter);
+		}
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::Unlink(Node*& root, bool& shorter)
+{
+	Node* old = root;
+
+	if (root->m_left == nullptr) //right only (or empty)
+	{
+		root = root->m_right;
+		shorter = true;
+	}
+	else if (root->m_right == nullptr) //left only
+	{
+		root = root->m_left;
+		shorter = true;
+	}
+	else //both
+	{
+		//the in-order predecessor takes this node's place
+		Node* previous = RemoveMaxNode(root->m_left, shorter);
+
+		previous->m_left = root->m_left;
+		previous->m_right = root->m_right;
+		previous->m_balance = root->m_balance;
+		root = previous;
+
+		if (shorter)
+			LeftShorter(root, shorter);
+	}
+
+	DestroyNode(old);
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline typename BucketAVLTree<T, BucketSize, Allocator>::Node* BucketAVLTree<T, BucketSize, Allocator>::RemoveMaxNode(Node*& root, bool& shorter)
+{
+	if (root->m_right == nullptr)
+	{
+		Node* max = root;
+		root = root->m_left;
+		shorter = true;
+
+		return max;
+	}
+
+	Node* max = RemoveMaxNode(root->m_right, shorter);
+	if (shorter)
+		RightShorter(root, shorter);
+
+	return max;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline typename BucketAVLTree<T, BucketSize, Allocator>::Node* BucketAVLTree<T, BucketSize, Allocator>::RemoveMinNode(Node*& root, bool& shorter)
+{
+	if (root->m_left == nullptr)
+	{
+		Node* min = root;
+		root = root->m_right;
+		shorter = true;
+
+		return min;
+	}
+
+	Node* min = RemoveMinNode(root->m_left, shorter);
+	if (shorter)
+		LeftShorter(root, shorter);
+
+	return min;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::LeftTaller(Node*& root, bool& taller)
+{
+	switch (root->m_balance)
+	{
+	case Node::BALANCE::LH:
+		if (root->m_left->m_balance == Node::BALANCE::RH) //Checks LR
+		{
+			++(root->m_left->m_balance);
+			RRRotation(root->m_left);
+		}
+		taller = false;
+		LLRotation(root);
+
+		break;
+	case Node::BALANCE::EH:
+		root->m_balance = Node::BALANCE::LH;
+
+		break;
+	case Node::BALANCE::RH:
+		root->m_balance = Node::BALANCE::EH;
+		taller = false;
+
+		break;
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::RightTaller(Node*& root, bool& taller)
+{
+	switch (root->m_balance)
+	{
+	case Node::BALANCE::LH:
+		root->m_balance = Node::BALANCE::EH;
+		taller = false;
+
+		break;
+	case Node::BALANCE::EH:
+		root->m_balance = Node::BALANCE::RH;
+
+		break;
+	case Node::BALANCE::RH:
+		if (root->m_right->m_balance == Node::BALANCE::LH) //Checks RL
+		{
+			--(root->m_right->m_balance);
+			LLRotation(root->m_right);
+		}
+		taller = false;
+		RRRotation(root);
+
+		break;
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::LeftShorter(Node*& root, bool& shorter)
+{
+	switch (root->m_balance)
+	{
+	case Node::BALANCE::LH:
+		root->m_balance = Node::BALANCE::EH;
+
+		break;
+	case Node::BALANCE::EH:
+		root->m_balance = Node::BALANCE::RH;
+		shorter = false;
+
+		break;
+	case Node::BALANCE::RH:
+		if (root->m_right->m_balance == Node::BALANCE::LH) //Checks RL
+		{
+			--(root->m_right->m_balance);
+			LLRotation(root->m_right);
+		}
+		else if (root->m_right->m_balance == Node::BALANCE::EH)
+		{
+			shorter = false; //a single rotation over an even child keeps the height
+		}
+		RRRotation(root);
+
+		break;
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::RightShorter(Node*& root, bool& shorter)
+{
+	switch (root->m_balance)
+	{
+	case Node::BALANCE::LH:
+		if (root->m_left->m_balance == Node::BALANCE::RH) //Checks LR
+		{
+			++(root->m_left->m_balance);
+			RRRotation(root->m_left);
+		}
+		else if (root->m_left->m_balance == Node::BALANCE::EH)
+		{
+			shorter = false; //a single rotation over an even child keeps the height
+		}
+		LLRotation(root);
+
+		break;
+	case Node::BALANCE::EH:
+		root->m_balance = Node::BALANCE::LH;
+		shorter = false;
+
+		break;
+	case Node::BALANCE::RH:
+		root->m_balance = Node::BALANCE::EH;
+
+		break;
+	}
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::LLRotation(Node*& root)
+{
+	Node* left = root->m_left;
+	Node* leftRight = left->m_right;
+
+	++(root->m_balance);
+	root->m_balance = root->m_balance - 1 - max(left->m_balance, 0);
+	left->m_balance = left->m_balance - 1 + min(root->m_balance, 0);
+
+	left->m_right = root;
+	root->m_left = leftRight;
+
+	root = left;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline void BucketAVLTree<T, BucketSize, Allocator>::RRRotation(Node*& root)
+{
+	Node* right = root->m_right;
+	Node* rightLeft = right->m_left;
+
+	--(root->m_balance);
+	root->m_balance = root->m_balance + 1 - min(right->m_balance, 0);
+	right->m_balance = right->m_balance + 1 + max(root->m_balance, 0);
+
+	right->m_left = root;
+	root->m_right = rightLeft;
+
+	root = right;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline const typename BucketAVLTree<T, BucketSize, Allocator>::Node* BucketAVLTree<T, BucketSize, Allocator>::FindBucket(const T & data) const
+{
+	const Node* current = m_root;
+
+	while (current != nullptr)
+	{
+		if (data < current->Min())
+			current = current->m_left;
+		else if (current->Max() < data)
+			current = current->m_right;
+		else
+			return current;
+	}
+
+	return nullptr;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline int BucketAVLTree<T, BucketSize, Allocator>::LowerBoundIn(const Node* node, const T & data)
+{
+	const T* first = &node->Item(0);
+
+	return static_cast<int>(std::lower_bound(first, first + node->Count(), data) - first);
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline int BucketAVLTree<T, BucketSize, Allocator>::UpperBoundIn(const Node* node, const T & data)
+{
+	const T* first = &node->Item(0);
+
+	return static_cast<int>(std::upper_bound(first, first + node->Count(), data) - first);
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::IsBalancedNode(const Node* root) const
+{
+	if (root != nullptr)
+	{
+		return (IsBalancedNode(root->m_left) &&
+			root->m_balance >= -1 && root->m_balance <= 1 &&
+			IsBalancedNode(root->m_right));
+	}
+	return true;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+template<typename Visitor>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::Visit(Visitor& visit, T& data)
+{
+	return Visit(visit, data, std::is_void<decltype(visit(data))>());
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+template<typename Visitor>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::Visit(Visitor& visit, T& data, std::true_type)
+{
+	visit(data);
+	return true;
+}
+
+template<typename T, int BucketSize, template <typename> class Allocator>
+template<typename Visitor>
+inline bool BucketAVLTree<T, BucketSize, Allocator>::Visit(Visitor& visit, T& data, std::false_type)
+{
+	return static_cast<bool>(visit(data));
+}
@@ -0,0 +1,88 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: BucketAVLTreeNode.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - The bucket is an InlineArray, which SmallAVLTree shares
+**************************************************************/
+
+#pragma once
+
+#include "InlineArray.h"
+
+template <typename T, int BucketSize, template <typename> class Allocator>
+class BucketAVLTree;
+
+/************************************************************************
+* Class: BucketAVLTreeNode
+*
+* Purpose: This class represents a node of a BucketAVLTree. Instead of
+*		one item it holds a sorted bucket of up to BucketSize items in an
+*		inline array, so the items of a node share its allocation and its
+*		cache lines. The bucket is the InlineArray the node derives from,
+*		whose Item, InsertAt, RemoveAt, TakeFront, TakeBack, SplitInto
+*		and Clear BucketAVLTree uses to keep it sorted.
+*
+* Helpers (used by BucketAVLTree):
+* const T& Min() const; / const T& Max() const;
+*		Returns the first / last item of the bucket
+*
+*************************************************************************/
+template <typename T, int BucketSize>
+class BucketAVLTreeNode : private InlineArray<T, BucketSize>
+{
+	template <typename U, int B, template <typename> class Allocator>
+	friend class BucketAVLTree;
+
+public:
+
+	enum BALANCE : int { LH = 1, EH = 0, RH = -1}; //LeftHeavy, EqualHeavy, RightHeavy
+
+private:
+	BucketAVLTreeNode();
+	BucketAVLTreeNode(const BucketAVLTreeNode<T, BucketSize>& copy);
+	BucketAVLTreeNode<T, BucketSize>& operator=(const BucketAVLTreeNode<T, BucketSize>& rhs);
+	~BucketAVLTreeNode();
+
+	const T& Min() const;
+	const T& Max() const;
+
+	int m_balance;
+	BucketAVLTreeNode<T, BucketSize>* m_left;
+	BucketAVLTreeNode<T, BucketSize>* m_right;
+};
+
+
+/// Function Code ///
+
+template<typename T, int BucketSize>
+inline BucketAVLTreeNode<T, BucketSize>::BucketAVLTreeNode() : m_balance(EH), m_left(nullptr), m_right(nullptr)
+{
+}
+
+template<typename T, int BucketSize>
+inline BucketAVLTreeNode<T, BucketSize>::BucketAVLTreeNode(const BucketAVLTreeNode<T, BucketSize>& copy) : InlineArray<T, BucketSize>(), m_balance(copy.m_balance), m_left(nullptr), m_right(nullptr)
+{
+	this->CopyFrom(copy);
+}
+
+template<typename T, int BucketSize>
+inline BucketAVLTreeNode<T, BucketSize>::~BucketAVLTreeNode()
+{
+	//Default values
+	m_balance = EH;
+	m_left = nullptr;
+	m_right = nullptr;
+}
+
+template<typename T, int BucketSize>
+inline const T& BucketAVLTreeNode<T, BucketSize>::Min() const
+{
+	return this->Item(0);
+}
+
+template<typename T, int BucketSize>
+inline const T& BucketAVLTreeNode<T, BucketSize>::Max() const
+{
+	return this->Item(this->Count() - 1);
+}
@@ -0,0 +1,346 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: CombiningAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - Waiters try the lock once, then only retry it when no combiner is active
+*		- 10/17/2026 - The batch is sorted in a copy, so a throwing comparison cannot lose or repeat a request
+**************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AVLTree.h"
+#include "Exception.h"
+
+/************************************************************************
+* Class: CombiningAVLTree
+*
+* Purpose: This class puts one AVLTree behind a flat combining front
+*		end. A thread does not queue up for the lock with its request.
+*		It posts the request in a publication slot and tries the lock
+*		once. The thread that gets the lock becomes the combiner: it
+*		collects every posted request, sorts them by key and applies the
+*		batch to the tree in one pass, which walks neighbouring paths
+*		while they are still in cache. Then it hands each poster its
+*		result. The rest only watch their own slot, and try the lock
+*		again only once the combiner's active flag reads clear, so under
+*		contention the lock changes hands once per batch instead of once
+*		per operation and its cache line is not pulled around by the
+*		waiters. Without contention a request costs one slot and one
+*		uncontended lock.
+*		A thread's slot is picked by hashing its id, so a thread keeps
+*		finding the same slot without registering. Exceptions thrown
+*		while applying a request (Delete of a missing item, a throwing
+*		copy) are thrown again on the thread that posted it.
+*
+* Manager functions:
+* CombiningAVLTree();
+* ~CombiningAVLTree();
+*		No thread may use the tree anymore
+*
+* Methods (safe to call from any number of threads):
+* void Insert(const T& data); / void Insert(T&& data);
+*		Inserts data into the tree
+* void Delete(const T& data);
+*		Deletes the equivalent data from the tree, throws if there is none
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* int Size() const;
+*		returns the number of items after the last batch
+* bool IsEmpty() const;
+*		Returns true if the tree was empty after the last batch
+* template <typename Visitor> bool InOrder(Visitor visit) const;
+*		Calls visit with every item in order while holding the lock
+*		If visit returns a bool, returning false stops the traversal.
+*		Returns false if it was stopped, true if it finished
+* bool IsBalanced() const;
+*		Returns true if all balance factors are between -1 and 1
+*
+* --- HELPER FUNCTIONS ---
+* struct Slot
+*		One posted request: what to do, the caller's item, and the result
+* void Post(int operation, const T* item, bool* found) const;
+*		Posts a request, waits until some combiner applied it and rethrows its exception
+* int ClaimSlot() const;
+*		Takes a free slot, starting at the one this thread's id hashes to
+* void Combine() const;
+*		With the lock held, applies every posted request as one sorted batch
+* static void Apply(AVLTree<T, Allocator, Options>& tree, Slot& slot);
+*		Applies one request and stores its result in the slot
+*
+*************************************************************************/
+template <typename T, template <typename> class Allocator = ArenaAllocator, unsigned Options = AVL_PLAIN>
+class CombiningAVLTree
+{
+public:
+	enum TUNING : int { MAX_SLOTS = 64, COMBINE_PASSES = 3 };
+
+	CombiningAVLTree();
+	~CombiningAVLTree();
+
+	//Methods
+	void Insert(const T& data); //Inserts data into the tree
+	void Insert(T&& data); //Inserts data into the tree, moving it into the node
+	void Delete(const T& data); //Deletes the equivalent data from the tree
+	int Size() const; //returns the number of items in the tree
+
+	//Lookups
+	bool IsEmpty() const;
+	bool Contains(const T& data) const;
+	bool IsBalanced() const;
+	template <typename Visitor> bool InOrder(Visitor visit) const;
+
+private:
+	CombiningAVLTree(const CombiningAVLTree<T, Allocator, Options>& copy);
+	CombiningAVLTree<T, Allocator, Options>& operator=(const CombiningAVLTree<T, Allocator, Options>& rhs);
+
+	enum STATE : int { FREE, CLAIMED, POSTED, DONE };
+	enum OPERATION : int { INSERT, INSERT_MOVE, DELETE, CONTAINS };
+
+	//aligned to a cache line of its own, so posting never touches another thread's line
+	struct alignas(64) Slot
+	{
+		Slot() : m_state(FREE), m_operation(INSERT), m_item(nullptr), m_found(nullptr) {}
+
+		std::atomic<int> m_state;
+		int m_operation;
+		const T* m_item; //the caller's item, it waits in Post so this stays valid
+		bool* m_found;
+		std::exception_ptr m_error;
+	};
+
+	void Post(int operation, const T* item, bool* found) const;
+	int ClaimSlot() const;
+	void Combine() const;
+	static void Apply(AVLTree<T, Allocator, Options>& tree, Slot& slot);
+
+	mutable Slot m_slots[MAX_SLOTS];
+	mutable std::mutex m_lock; //held by the combiner
+	mutable AVLTree<T, Allocator, Options> m_tree; //only touched with m_lock held
+	mutable std::vector<Slot*> m_batch; //the combiner's scratch space, reused between batches
+	mutable std::vector<Slot*> m_sorted; //the batch is sorted here, m_batch stays whole if that throws
+	mutable std::atomic<int> m_numElements;
+	mutable std::atomic<bool> m_combining; //set while a combiner holds m_lock, waiters read it instead of the lock
+};
+
+
+/// Function Code ///
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline CombiningAVLTree<T, Allocator, Options>::CombiningAVLTree() : m_numElements(0), m_combining(false)
+{
+	m_batch.reserve(MAX_SLOTS);
+	m_sorted.reserve(MAX_SLOTS);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline CombiningAVLTree<T, Allocator, Options>::~CombiningAVLTree()
+{
+	//Default values
+	m_numElements = 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void CombiningAVLTree<T, Allocator, Options>::Insert(const T & data)
+{
+	Post(INSERT, &data, nullptr);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void CombiningAVLTree<T, Allocator, Options>::Insert(T && data)
+{
+	Post(INSERT_MOVE, &data, nullptr);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void CombiningAVLTree<T, Allocator, Options>::Delete(const T & data)
+{
+	Post(DELETE, &data, nullptr);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int CombiningAVLTree<T, Allocator, Options>::Size() const
+{
+	return m_numElements.load();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool CombiningAVLTree<T, Allocator, Options>::IsEmpty() const
+{
+	return Size() == 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool CombiningAVLTree<T, Allocator, Options>::Contains(const T & data) const
+{
+	bool found = false;
+	Post(CONTAINS, &data, &found);
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool CombiningAVLTree<T, Allocator, Options>::IsBalanced() const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	return m_tree.IsBalanced();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool CombiningAVLTree<T, Allocator, Options>::InOrder(Visitor visit) const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	return m_tree.InOrder(visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void CombiningAVLTree<T, Allocator, Options>::Post(int operation, const T * item, bool * found) const
+{
+	Slot& slot = m_slots[ClaimSlot()];
+	slot.m_operation = operation;
+	slot.m_item = item;
+	slot.m_found = found;
+	slot.m_state.store(POSTED, std::memory_order_release);
+
+	//try the lock once. An active combiner will pick the request up, so after that only retry
+	//when the flag says it finished, possibly before it saw this request
+	bool tryLock = true;
+	int spins = 0;
+	while (slot.m_state.load(std::memory_order_acquire) != DONE)
+	{
+		if (tryLock && m_lock.try_lock())
+		{
+			m_combining.store(true, std::memory_order_relaxed);
+
+			try
+			{
+				Combine();
+			}
+			catch (...)
+			{
+				m_combining.store(false, std::memory_order_release);
+				m_lock.unlock();
+				throw;
+			}
+
+			m_combining.store(false, std::memory_order_release);
+			m_lock.unlock();
+			continue;
+		}
+
+		if (++spins % 64 == 0)
+			std::this_thread::yield();
+
+		tryLock = !m_combining.load(std::memory_order_acquire);
+	}
+
+	std::exception_ptr error = slot.m_error;
+	slot.m_error = nullptr;
+	slot.m_state.store(FREE, std::memory_order_release);
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int CombiningAVLTree<T, Allocator, Options>::ClaimSlot() const
+{
+	int start = static_cast<int>(std::hash<std::thread::id>()(std::this_thread::get_id()) % MAX_SLOTS);
+
+	for (int tries = 0; ; ++tries)
+	{
+		int index = (start + tries) % MAX_SLOTS;
+		int expected = FREE;
+
+		if (m_slots[index].m_state.load(std::memory_order_relaxed) == FREE &&
+			m_slots[index].m_state.compare_exchange_strong(expected, CLAIMED, std::memory_order_acquire))
+			return index;
+
+		//more threads than slots are posting, wait for one to finish
+		if (tries % MAX_SLOTS == MAX_SLOTS - 1)
+			std::this_thread::yield();
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void CombiningAVLTree<T, Allocator, Options>::Combine() const
+{
+	//a few passes pick up the requests posted while the previous batch ran
+	for (int pass = 0; pass < COMBINE_PASSES; ++pass)
+	{
+		m_batch.clear();
+
+		for (int i = 0; i < MAX_SLOTS; ++i)
+		{
+			if (m_slots[i].m_state.load(std::memory_order_acquire) == POSTED)
+				m_batch.push_back(&m_slots[i]);
+		}
+
+		if (m_batch.empty())
+			break;
+
+		//stable, so two requests for the same key keep the order they were found in.
+		//A throwing comparison can leave the sorted copy with a request lost and another
+		//repeated, so then the batch is applied unsorted from m_batch instead
+		m_sorted.assign(m_batch.begin(), m_batch.end());
+
+		try
+		{
+			std::stable_sort(m_sorted.begin(), m_sorted.end(), [](const Slot* lhs, const Slot* rhs) { return *lhs->m_item < *rhs->m_item; });
+			m_batch.swap(m_sorted);
+		}
+		catch (...)
+		{
+		}
+
+		for (typename std::vector<Slot*>::iterator current = m_batch.begin(); current != m_batch.end(); ++current)
+			Apply(m_tree, **current);
+
+		m_numElements.store(m_tree.Size());
+
+		for (typename std::vector<Slot*>::iterator current = m_batch.begin(); current != m_batch.end(); ++current)
+			(*current)->m_state.store(DONE, std::memory_order_release);
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void CombiningAVLTree<T, Allocator, Options>::Apply(AVLTree<T, Allocator, Options>& tree, Slot& slot)
+{
+	try
+	{
+		switch (slot.m_operation)
+		{
+		case INSERT:
+			tree.Insert(*slot.m_item);
+
+			break;
+		case INSERT_MOVE:
+			//Insert(T&&) posted a pointer to its own rvalue
+			tree.Insert(std::move(*const_cast<T*>(slot.m_item)));
+
+			break;
+		case DELETE:
+			tree.Delete(*slot.m_item);
+
+			break;
+		case CONTAINS:
+			*slot.m_found = tree.Contains(*slot.m_item);
+
+			break;
+		}
+	}
+	catch (...)
+	{
+		slot.m_error = std::current_exception();
+	}
+}
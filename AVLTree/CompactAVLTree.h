@@ -0,0 +1,1205 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: CompactAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - Befriends SplitAVLMap, which keeps its values in a pool parallel to the keys
+*		- 10/17/2026 - Added FindOrInsert, so SplitAVLMap finds or adds a key in one walk
+**************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+using std::max;
+using std::min;
+#include "AVLTreeNode.h"
+#include "Exception.h"
+#include "Queue.h"
+
+template <typename K, typename V>
+class SplitAVLMap;
+
+/************************************************************************
+* Class: CompactAVLTree
+*
+* Purpose: This class is an AVLTree whose nodes live in one contiguous
+*		pool instead of one allocation each. A node is the item and two
+*		32 bit child indices into the pool, nothing else: the balance
+*		factor takes the top bit of each index (2 bits, LH, EH or RH, and
+*		the fourth code marks a free slot), leaving 31 bits for the index.
+*		An AVLTree<int> node is a 4 byte item, a 4 byte balance and two
+*		8 byte pointers; here it is 12 bytes, so twice as many nodes fit
+*		in every cache line and the whole tree can be moved or grown with
+*		the links still valid. Slot 0 is never used, index 0 is the empty
+*		link. Deleted slots go on a free list (threaded through the left
+*		index) and are reused before the pool grows. The pool doubles when
+*		it is full, moving the items over, so up to half of it can be
+*		empty; Reserve avoids that when the size is known.
+*		The methods work the same as AVLTree's. It has no Allocator and
+*		no AVL_OPTIONS, the pool is the allocator.
+*
+* Manager functions:
+* CompactAVLTree();
+* CompactAVLTree(const CompactAVLTree<T>& copy);
+*		Copies the pool slot by slot in O(n), keeping the same shape
+* CompactAVLTree(CompactAVLTree<T>&& other);
+*		Takes over the pool of other, leaving it empty
+* ~CompactAVLTree();
+* CompactAVLTree<T>& operator=(const CompactAVLTree<T>& rhs);
+* CompactAVLTree<T>& operator=(CompactAVLTree<T>&& rhs);
+*
+* Methods:
+* void Insert(const T& data); / void Insert(T&& data);
+*		Inserts data into the tree
+* template <typename... Args> void Emplace(Args&&... args);
+*		Inserts an item constructed in place in the pool from args
+* void Delete(const T& data);
+*		Deletes the equivalent data from the tree, throws if there is none
+* void Purge();
+*		Removes every item and gives the pool back
+* void Reserve(int count);
+*		Makes room for count more items, so the next count inserts do not grow the pool
+* int Height() const;
+*		returns the height of the tree in O(1)
+* int Size() const;
+*		returns the number of items in the tree in O(1)
+* int Capacity() const;
+*		returns how many items fit before the pool grows again
+*
+* Lookups:
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* const T* Find(const T& data) const;
+*		Returns a pointer to the stored equivalent data, or nullptr. It is valid until the next insert
+* const T* Floor(const T& data) const;
+*		Returns the largest item that is not greater than data, or nullptr
+* const T* Ceiling(const T& data) const;
+*		Returns the smallest item that is not less than data, or nullptr
+*
+* Testing:
+* bool IsEmpty() const;
+*		Returns true if the tree is empty
+* bool IsBalanced() const;
+*		Returns true if all balance factors are between -1 and 1
+*
+* Traversals:
+* template <typename Visitor> bool InOrder(Visitor visit); (also PreOrder, PostOrder, BreadthFirst)
+*		Calls visit with every item. If visit returns a bool, returning false stops
+*		the traversal. Returns false if it was stopped, true if it finished
+*
+* --- HELPER FUNCTIONS ---
+* struct Node
+*		Storage for one item and the two packed links
+* T& Data(Index node); / const T& Data(Index node) const;
+*		Returns the item in a slot
+* Index Left(Index node) const; / Index Right(Index node) const;
+*		Returns a child index without the balance bits
+* void SetLeft(Index node, Index left); / void SetRight(Index node, Index right);
+*		Sets a child index, keeping the balance bits
+* int GetBalance(Index node) const; / void SetBalance(Index node, int balance);
+*		Unpacks and packs the balance factor
+* bool IsLive(const Node& node) const;
+*		Returns true if the slot holds an item (false for free slots)
+* template <typename... Args> Index EmplaceNode(Args&&... args);
+*		Helps Emplace, returns the slot of the new item
+* Index FindOrInsert(const T& data, bool& inserted);
+*		Returns the slot of the item equivalent to data, or adds a copy of data and returns
+*		its slot. One walk down either way, inserted says which it was
+* template <typename... Args> Index CreateNode(Args&&... args);
+*		Constructs an item in a free slot, growing the pool if there is none
+* void DestroyNode(Index node);
+*		Destroys the item in a slot and puts the slot on the free list
+* void Grow(Index capacity);
+*		Moves the pool to one with capacity slots, the indices stay the same
+* void CopyPool(const CompactAVLTree<T>& copy);
+*		Copies every slot of copy into this empty tree
+* void Release();
+*		Destroys every item and frees the pool
+* Index InsertNode(Index root, Index node, bool& taller);
+*		Links node into the subtree at root, returns the new root of that subtree
+* Index FindOrInsertNode(Index root, const T& data, Index& node, bool& taller, bool& inserted);
+*		Helps FindOrInsert by recursively searching, creating the node at the bottom if data
+*		is missing and rebalancing on the way back up. Returns the new root of the subtree
+* Index LeftTaller(Index root, bool& taller); / Index RightTaller(Index root, bool& taller);
+*		Fixes the balance of root after one side got taller, returns the new root
+* Index LLRotation(Index root); / Index RRRotation(Index root);
+*		Rotates right / left around root and returns the new root
+* Index LRRotation(Index root); / Index RLRotation(Index root);
+*		Double rotations, done in one step. AVLTree does them as two single rotations,
+*		but the first one leaves a balance of 2 behind, which does not fit in two bits
+* Index FindNodeAndDelete(Index root, const T& data, bool& shorter);
+*		Unlinks and destroys the node equivalent to data, returns the new root
+* Index RemoveMaxNode(Index root, Index& max, bool& shorter);
+*		Unlinks the largest node of the subtree into max, returns the new root
+* Index LeftShorter(Index root, bool& shorter); / Index RightShorter(Index root, bool& shorter);
+*		Fixes the balance of root after one side got shorter, returns the new root
+* Index FindNode(const T& data) const;
+*		Returns the node equivalent to data, or NIL
+* bool IsBalancedNode(Index root) const;
+*		Checks the balance factors of the subtree at root
+* template <typename Visitor> static bool Visit(Visitor& visit, T& data);
+*		Calls visit and turns its result into "keep going"
+*
+*************************************************************************/
+template <typename T>
+class CompactAVLTree
+{
+	template <typename K, typename V>
+	friend class SplitAVLMap;
+
+public:
+	CompactAVLTree();
+	CompactAVLTree(const CompactAVLTree<T>& copy);
+	CompactAVLTree(CompactAVLTree<T>&& other);
+	~CompactAVLTree();
+	CompactAVLTree<T>& operator=(const CompactAVLTree<T>& rhs);
+	CompactAVLTree<T>& operator=(CompactAVLTree<T>&& rhs);
+
+	//Methods
+	void Insert(const T& data); //Inserts data into the tree
+	void Insert(T&& data); //Inserts data into the tree, moving it into the pool
+	template <typename... Args> void Emplace(Args&&... args); //Inserts an item built from args
+	void Delete(const T& data); //Deletes the equivalent data from the tree
+	void Purge(); //Removes every item and frees the pool
+	void Reserve(int count); //Makes room for count more items
+	int Height() const; //returns the height of the tree
+	int Size() const; //returns the number of items in the tree
+	int Capacity() const; //returns how many items fit in the pool
+
+	//Lookups
+	bool Contains(const T& data) const;
+	const T* Find(const T& data) const;
+	const T* Floor(const T& data) const;
+	const T* Ceiling(const T& data) const;
+
+	//Testing
+	bool IsEmpty() const;
+	bool IsBalanced() const;
+
+	//Traversals
+	template <typename Visitor> bool InOrder(Visitor visit);
+	template <typename Visitor> bool PreOrder(Visitor visit);
+	template <typename Visitor> bool PostOrder(Visitor visit);
+	template <typename Visitor> bool BreadthFirst(Visitor visit);
+
+private:
+	typedef std::uint32_t Index;
+
+	enum PACKING : Index
+	{
+		NIL = 0, //slot 0 is never handed out
+		BALANCE_BIT = 0x80000000u, //top bit of each link, left holds the low bit of the code
+		INDEX_MASK = 0x7FFFFFFFu,
+		FREE_CODE = 3 //balance codes are balance + 1 (0 to 2), both bits set marks a free slot
+	};
+
+	enum POOL : int { FIRST_POOL = 64 };
+
+	struct Node
+	{
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage;
+		Index m_left;
+		Index m_right;
+	};
+
+	T& Data(Index node);
+	const T& Data(Index node) const;
+	Index Left(Index node) const;
+	Index Right(Index node) const;
+	void SetLeft(Index node, Index left);
+	void SetRight(Index node, Index right);
+	int GetBalance(Index node) const;
+	void SetBalance(Index node, int balance);
+	bool IsLive(const Node& node) const;
+
+	template <typename... Args> Index EmplaceNode(Args&&... args);
+	Index FindOrInsert(const T& data, bool& inserted);
+	template <typename... Args> Index CreateNode(Args&&... args);
+	void DestroyNode(Index node);
+	void Grow(Index capacity);
+	void CopyPool(const CompactAVLTree<T>& copy);
+	void Release();
+
+	Index InsertNode(Index root, Index node, bool& taller);
+	Index FindOrInsertNode(Index root, const T& data, Index& node, bool& taller, bool& inserted);
+	Index LeftTaller(Index root, bool& taller);
+	Index RightTaller(Index root, bool& taller);
+	Index LLRotation(Index root);
+	Index RRRotation(Index root);
+	Index LRRotation(Index root);
+	Index RLRotation(Index root);
+	Index FindNodeAndDelete(Index root, const T& data, bool& shorter);
+	Index RemoveMaxNode(Index root, Index& max, bool& shorter);
+	Index LeftShorter(Index root, bool& shorter);
+	Index RightShorter(Index root, bool& shorter);
+	Index FindNode(const T& data) const;
+	bool IsBalancedNode(Index root) const;
+
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data);
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data, std::true_type);
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data, std::false_type);
+
+	std::vector<Node> m_pool;
+	Index m_used; //slots below this have been handed out at least once
+	Index m_free; //first slot of the free list, or NIL
+	Index m_root;
+	int m_numElements;
+	int m_height;
+};
+
+
+/// Function Code ///
+
+template<typename T>
+inline CompactAVLTree<T>::CompactAVLTree() : m_used(1), m_free(NIL), m_root(NIL), m_numElements(0), m_height(0)
+{
+}
+
+template<typename T>
+inline CompactAVLTree<T>::CompactAVLTree(const CompactAVLTree<T>& copy) : m_used(1), m_free(NIL), m_root(NIL), m_numElements(0), m_height(0)
+{
+	CopyPool(copy);
+}
+
+template<typename T>
+inline CompactAVLTree<T>::CompactAVLTree(CompactAVLTree<T>&& other) : m_pool(std::move(other.m_pool)), m_used(other.m_used), m_free(other.m_free),
+	m_root(other.m_root), m_numElements(other.m_numElements), m_height(other.m_height)
+{
+	//Default values
+	other.m_pool.clear();
+	other.m_used = 1;
+	other.m_free = NIL;
+	other.m_root = NIL;
+	other.m_numElements = 0;
+	other.m_height = 0;
+}
+
+template<typename T>
+inline CompactAVLTree<T>::~CompactAVLTree()
+{
+	Release();
+}
+
+template<typename T>
+inline CompactAVLTree<T>& CompactAVLTree<T>::operator=(const CompactAVLTree<T>& rhs)
+{
+	if (this != &rhs)
+	{
+		Purge();
+		CopyPool(rhs);
+	}
+
+	return *this;
+}
+
+template<typename T>
+inline CompactAVLTree<T>& CompactAVLTree<T>::operator=(CompactAVLTree<T>&& rhs)
+{
+	if (this != &rhs)
+	{
+		Purge();
+
+		m_pool.swap(rhs.m_pool);
+		std::swap(m_used, rhs.m_used);
+		std::swap(m_free, rhs.m_free);
+		std::swap(m_root, rhs.m_root);
+		std::swap(m_numElements, rhs.m_numElements);
+		std::swap(m_height, rhs.m_height);
+	}
+
+	return *this;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::Insert(const T & data)
+{
+	Emplace(data);
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::Insert(T && data)
+{
+	Emplace(std::move(data));
+}
+
+template<typename T>
+template<typename... Args>
+inline void CompactAVLTree<T>::Emplace(Args&&... args)
+{
+	EmplaceNode(std::forward<Args>(args)...);
+}
+
+template<typename T>
+template<typename... Args>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::EmplaceNode(Args&&... args)
+{
+	Index node = CreateNode(std::forward<Args>(args)...);
+	bool taller = false;
+
+	try
+	{
+		//the links are only written on the way back up, so a throwing comparison leaves the tree as it was
+		m_root = InsertNode(m_root, node, taller);
+	}
+	catch (...)
+	{
+		DestroyNode(node);
+		throw;
+	}
+
+	++m_numElements;
+	if (taller)
+		++m_height;
+
+	return node;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::FindOrInsert(const T & data, bool& inserted)
+{
+	Index node = NIL;
+	bool taller = false;
+	inserted = false;
+
+	//the node is created at the bottom of the walk, if that or a comparison throws nothing has been linked
+	m_root = FindOrInsertNode(m_root, data, node, taller, inserted);
+
+	if (inserted)
+		++m_numElements;
+
+	if (taller)
+		++m_height;
+
+	return node;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::Delete(const T & data)
+{
+	if (IsEmpty())
+		throw Exception("Tried to delete from empty tree");
+
+	bool shorter = false;
+	m_root = FindNodeAndDelete(m_root, data, shorter);
+	--m_numElements;
+
+	if (shorter)
+		--m_height;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::Purge()
+{
+	Release();
+
+	//Default values
+	m_used = 1;
+	m_free = NIL;
+	m_root = NIL;
+	m_numElements = 0;
+	m_height = 0;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::Reserve(int count)
+{
+	if (count > 0 && static_cast<Index>(m_pool.size()) < m_used + static_cast<Index>(count))
+		Grow(m_used + static_cast<Index>(count));
+}
+
+template<typename T>
+inline int CompactAVLTree<T>::Height() const
+{
+	if (IsEmpty())
+		throw Exception("Tried to get height of empty tree");
+
+	return m_height;
+}
+
+template<typename T>
+inline int CompactAVLTree<T>::Size() const
+{
+	return m_numElements;
+}
+
+template<typename T>
+inline int CompactAVLTree<T>::Capacity() const
+{
+	//slot 0 is never used
+	return m_pool.empty() ? 0 : static_cast<int>(m_pool.size()) - 1;
+}
+
+template<typename T>
+inline bool CompactAVLTree<T>::Contains(const T & data) const
+{
+	return FindNode(data) != NIL;
+}
+
+template<typename T>
+inline const T* CompactAVLTree<T>::Find(const T & data) const
+{
+	Index node = FindNode(data);
+
+	return node != NIL ? &Data(node) : nullptr;
+}
+
+template<typename T>
+inline const T* CompactAVLTree<T>::Floor(const T & data) const
+{
+	Index best = NIL;
+	Index current = m_root;
+
+	while (current != NIL)
+	{
+		if (data < Data(current))
+		{
+			current = Left(current);
+		}
+		else
+		{
+			best = current;
+			current = Right(current);
+		}
+	}
+
+	return best != NIL ? &Data(best) : nullptr;
+}
+
+template<typename T>
+inline const T* CompactAVLTree<T>::Ceiling(const T & data) const
+{
+	Index best = NIL;
+	Index current = m_root;
+
+	while (current != NIL)
+	{
+		if (Data(current) < data)
+		{
+			current = Right(current);
+		}
+		else
+		{
+			best = current;
+			current = Left(current);
+		}
+	}
+
+	return best != NIL ? &Data(best) : nullptr;
+}
+
+template<typename T>
+inline bool CompactAVLTree<T>::IsEmpty() const
+{
+	return m_numElements == 0;
+}
+
+template<typename T>
+inline bool CompactAVLTree<T>::IsBalanced() const
+{
+	return IsBalancedNode(m_root);
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool CompactAVLTree<T>::InOrder(Visitor visit)
+{
+	Index path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	Index current = m_root;
+
+	while (current != NIL || depth > 0)
+	{
+		//go as far left as possible, then visit and step into the right subtree
+		while (current != NIL)
+		{
+			path[depth++] = current;
+			current = Left(current);
+		}
+
+		current = path[--depth];
+		if (!Visit(visit, Data(current)))
+			return false;
+
+		current = Right(current);
+	}
+
+	return true;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool CompactAVLTree<T>::PreOrder(Visitor visit)
+{
+	//holds the right children still to do, never more than one per level plus the root
+	Index pending[AVL_MAX_HEIGHT + 1];
+	int depth = 0;
+
+	if (m_root != NIL)
+		pending[depth++] = m_root;
+
+	while (depth > 0)
+	{
+		Index current = pending[--depth];
+		if (!Visit(visit, Data(current)))
+			return false;
+
+		if (Right(current) != NIL)
+			pending[depth++] = Right(current);
+		if (Left(current) != NIL)
+			pending[depth++] = Left(current);
+	}
+
+	return true;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool CompactAVLTree<T>::PostOrder(Visitor visit)
+{
+	Index path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	Index current = m_root;
+	Index previous = NIL; //last node visited
+
+	while (current != NIL || depth > 0)
+	{
+		while (current != NIL)
+		{
+			path[depth++] = current;
+			current = Left(current);
+		}
+
+		Index top = path[depth - 1];
+
+		if (Right(top) != NIL && Right(top) != previous)
+		{
+			//right subtree has not been done yet
+			current = Right(top);
+		}
+		else
+		{
+			--depth;
+			if (!Visit(visit, Data(top)))
+				return false;
+
+			previous = top;
+		}
+	}
+
+	return true;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool CompactAVLTree<T>::BreadthFirst(Visitor visit)
+{
+	if (!IsEmpty())
+	{
+		Queue<Index> nodes;
+
+		nodes.Enqueue(m_root);
+
+		while (!nodes.isEmpty())
+		{
+			Index current = nodes.Dequeue();
+			if (!Visit(visit, Data(current)))
+				return false;
+
+			if (Left(current) != NIL)
+				nodes.Enqueue(Left(current));
+			if (Right(current) != NIL)
+				nodes.Enqueue(Right(current));
+		}
+	}
+
+	return true;
+}
+
+template<typename T>
+inline T& CompactAVLTree<T>::Data(Index node)
+{
+	return *reinterpret_cast<T*>(&m_pool[node].m_storage);
+}
+
+template<typename T>
+inline const T& CompactAVLTree<T>::Data(Index node) const
+{
+	return *reinterpret_cast<const T*>(&m_pool[node].m_storage);
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::Left(Index node) const
+{
+	return m_pool[node].m_left & INDEX_MASK;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::Right(Index node) const
+{
+	return m_pool[node].m_right & INDEX_MASK;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::SetLeft(Index node, Index left)
+{
+	m_pool[node].m_left = (m_pool[node].m_left & BALANCE_BIT) | left;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::SetRight(Index node, Index right)
+{
+	m_pool[node].m_right = (m_pool[node].m_right & BALANCE_BIT) | right;
+}
+
+template<typename T>
+inline int CompactAVLTree<T>::GetBalance(Index node) const
+{
+	Index code = (m_pool[node].m_left >> 31) | ((m_pool[node].m_right >> 31) << 1);
+
+	return static_cast<int>(code) - 1;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::SetBalance(Index node, int balance)
+{
+	Index code = static_cast<Index>(balance + 1);
+
+	m_pool[node].m_left = (m_pool[node].m_left & INDEX_MASK) | ((code & 1) << 31);
+	m_pool[node].m_right = (m_pool[node].m_right & INDEX_MASK) | ((code >> 1) << 31);
+}
+
+template<typename T>
+inline bool CompactAVLTree<T>::IsLive(const Node& node) const
+{
+	return (node.m_left & node.m_right & BALANCE_BIT) == 0;
+}
+
+template<typename T>
+template<typename... Args>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::CreateNode(Args&&... args)
+{
+	Index node = m_free;
+
+	if (node == NIL)
+	{
+		if (m_used > INDEX_MASK)
+			throw Exception("Tried to insert into a full CompactAVLTree");
+
+		node = m_used;
+
+		if (m_used >= static_cast<Index>(m_pool.size()))
+		{
+			//args may point into the pool, so the item is built before the pool moves
+			T item(std::forward<Args>(args)...);
+			Grow(max(static_cast<Index>(FIRST_POOL), min(static_cast<Index>(m_pool.size()) * 2, static_cast<Index>(INDEX_MASK) + 1)));
+			new (&m_pool[node].m_storage) T(std::move(item));
+		}
+		else
+		{
+			new (&m_pool[node].m_storage) T(std::forward<Args>(args)...);
+		}
+
+		++m_used;
+	}
+	else
+	{
+		Index next = Left(node);
+		new (&m_pool[node].m_storage) T(std::forward<Args>(args)...);
+		m_free = next;
+	}
+
+	m_pool[node].m_left = NIL;
+	m_pool[node].m_right = NIL;
+	SetBalance(node, AVLTreeNode<T>::BALANCE::EH);
+
+	return node;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::DestroyNode(Index node)
+{
+	Data(node).~T();
+
+	m_pool[node].m_left = m_free | BALANCE_BIT;
+	m_pool[node].m_right = NIL | BALANCE_BIT;
+	m_free = node;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::Grow(Index capacity)
+{
+	std::vector<Node> bigger(capacity);
+	Index moved = 1;
+
+	try
+	{
+		//a throwing copy leaves the old pool untouched, only items that cannot throw are moved
+		for (; moved < m_used; ++moved)
+		{
+			bigger[moved].m_left = m_pool[moved].m_left;
+			bigger[moved].m_right = m_pool[moved].m_right;
+
+			if (IsLive(m_pool[moved]))
+				new (&bigger[moved].m_storage) T(std::move_if_noexcept(Data(moved)));
+		}
+	}
+	catch (...)
+	{
+		for (Index slot = 1; slot < moved; ++slot)
+		{
+			if (IsLive(bigger[slot]))
+				reinterpret_cast<T*>(&bigger[slot].m_storage)->~T();
+		}
+
+		throw;
+	}
+
+	for (Index slot = 1; slot < m_used; ++slot)
+	{
+		if (IsLive(m_pool[slot]))
+			Data(slot).~T();
+	}
+
+	m_pool.swap(bigger);
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::CopyPool(const CompactAVLTree<T>& copy)
+{
+	if (copy.m_pool.empty())
+		return;
+
+	std::vector<Node> pool(copy.m_used);
+	Index copied = 1;
+
+	try
+	{
+		for (; copied < copy.m_used; ++copied)
+		{
+			pool[copied].m_left = copy.m_pool[copied].m_left;
+			pool[copied].m_right = copy.m_pool[copied].m_right;
+
+			if (IsLive(copy.m_pool[copied]))
+				new (&pool[copied].m_storage) T(copy.Data(copied));
+		}
+	}
+	catch (...)
+	{
+		for (Index slot = 1; slot < copied; ++slot)
+		{
+			if (IsLive(pool[slot]))
+				reinterpret_cast<T*>(&pool[slot].m_storage)->~T();
+		}
+
+		throw;
+	}
+
+	//the same slots and free list, so every index in the copy means the same node
+	m_pool.swap(pool);
+	m_used = copy.m_used;
+	m_free = copy.m_free;
+	m_root = copy.m_root;
+	m_numElements = copy.m_numElements;
+	m_height = copy.m_height;
+}
+
+template<typename T>
+inline void CompactAVLTree<T>::Release()
+{
+	if (!std::is_trivially_destructible<T>::value)
+	{
+		for (Index slot = 1; slot < m_used; ++slot)
+		{
+			if (IsLive(m_pool[slot]))
+				Data(slot).~T();
+		}
+	}
+
+	std::vector<Node>().swap(m_pool);
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::InsertNode(Index root, Index node, bool& taller)
+{
+	if (root == NIL)
+	{
+		taller = true;
+
+		return node;
+	}
+
+	if (Data(node) < Data(root))
+	{
+		SetLeft(root, InsertNode(Left(root), node, taller));
+		if (taller)
+			root = LeftTaller(root, taller);
+	}
+	else
+	{
+		SetRight(root, InsertNode(Right(root), node, taller));
+		if (taller)
+			root = RightTaller(root, taller);
+	}
+
+	return root;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::FindOrInsertNode(Index root, const T & data, Index& node, bool& taller, bool& inserted)
+{
+	if (root == NIL)
+	{
+		node = CreateNode(data);
+		inserted = true;
+		taller = true;
+
+		return node;
+	}
+
+	if (data < Data(root))
+	{
+		SetLeft(root, FindOrInsertNode(Left(root), data, node, taller, inserted));
+		if (taller)
+			root = LeftTaller(root, taller);
+	}
+	else if (Data(root) < data)
+	{
+		SetRight(root, FindOrInsertNode(Right(root), data, node, taller, inserted));
+		if (taller)
+			root = RightTaller(root, taller);
+	}
+	else
+	{
+		node = root;
+	}
+
+	return root;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::LeftTaller(Index root, bool& taller)
+{
+	switch (GetBalance(root))
+	{
+	case AVLTreeNode<T>::BALANCE::LH:
+		if (GetBalance(Left(root)) == AVLTreeNode<T>::BALANCE::RH) //Checks LR
+			root = LRRotation(root);
+		else
+			root = LLRotation(root);
+		taller = false;
+
+		break;
+	case AVLTreeNode<T>::BALANCE::EH:
+		SetBalance(root, AVLTreeNode<T>::BALANCE::LH);
+
+		break;
+	case AVLTreeNode<T>::BALANCE::RH:
+		SetBalance(root, AVLTreeNode<T>::BALANCE::EH);
+		taller = false;
+
+		break;
+	}
+
+	return root;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::RightTaller(Index root, bool& taller)
+{
+	switch (GetBalance(root))
+	{
+	case AVLTreeNode<T>::BALANCE::LH:
+		SetBalance(root, AVLTreeNode<T>::BALANCE::EH);
+		taller = false;
+
+		break;
+	case AVLTreeNode<T>::BALANCE::EH:
+		SetBalance(root, AVLTreeNode<T>::BALANCE::RH);
+
+		break;
+	case AVLTreeNode<T>::BALANCE::RH:
+		if (GetBalance(Right(root)) == AVLTreeNode<T>::BALANCE::LH) //Checks RL
+			root = RLRotation(root);
+		else
+			root = RRRotation(root);
+		taller = false;
+
+		break;
+	}
+
+	return root;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::LLRotation(Index root)
+{
+	Index left = Left(root);
+	Index leftRight = Right(left);
+
+	//the balance of root is one past LH here, so it is worked out in ints
+	int rootBalance = GetBalance(root) + 1;
+	int leftBalance = GetBalance(left);
+	rootBalance = rootBalance - 1 - max(leftBalance, 0);
+	leftBalance = leftBalance - 1 + min(rootBalance, 0);
+
+	SetRight(left, root);
+	SetLeft(root, leftRight);
+	SetBalance(root, rootBalance);
+	SetBalance(left, leftBalance);
+
+	return left;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::RRRotation(Index root)
+{
+	Index right = Right(root);
+	Index rightLeft = Left(right);
+
+	int rootBalance = GetBalance(root) - 1;
+	int rightBalance = GetBalance(right);
+	rootBalance = rootBalance + 1 - min(rightBalance, 0);
+	rightBalance = rightBalance + 1 + max(rootBalance, 0);
+
+	SetLeft(right, root);
+	SetRight(root, rightLeft);
+	SetBalance(root, rootBalance);
+	SetBalance(right, rightBalance);
+
+	return right;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::LRRotation(Index root)
+{
+	Index left = Left(root);
+	Index grandchild = Right(left);
+	int balance = GetBalance(grandchild);
+
+	//grandchild moves up, its subtrees go to left and root
+	SetRight(left, Left(grandchild));
+	SetLeft(root, Right(grandchild));
+	SetLeft(grandchild, left);
+	SetRight(grandchild, root);
+
+	SetBalance(left, balance == AVLTreeNode<T>::BALANCE::RH ? AVLTreeNode<T>::BALANCE::LH : AVLTreeNode<T>::BALANCE::EH);
+	SetBalance(root, balance == AVLTreeNode<T>::BALANCE::LH ? AVLTreeNode<T>::BALANCE::RH : AVLTreeNode<T>::BALANCE::EH);
+	SetBalance(grandchild, AVLTreeNode<T>::BALANCE::EH);
+
+	return grandchild;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::RLRotation(Index root)
+{
+	Index right = Right(root);
+	Index grandchild = Left(right);
+	int balance = GetBalance(grandchild);
+
+	SetLeft(right, Right(grandchild));
+	SetRight(root, Left(grandchild));
+	SetRight(grandchild, right);
+	SetLeft(grandchild, root);
+
+	SetBalance(right, balance == AVLTreeNode<T>::BALANCE::LH ? AVLTreeNode<T>::BALANCE::RH : AVLTreeNode<T>::BALANCE::EH);
+	SetBalance(root, balance == AVLTreeNode<T>::BALANCE::RH ? AVLTreeNode<T>::BALANCE::LH : AVLTreeNode<T>::BALANCE::EH);
+	SetBalance(grandchild, AVLTreeNode<T>::BALANCE::EH);
+
+	return grandchild;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::FindNodeAndDelete(Index root, const T & data, bool& shorter)
+{
+	if (root == NIL)
+		throw Exception("Could not find item to delete from tree");
+
+	if (data < Data(root))
+	{
+		//data smaller, go left and fix this node if the left side lost height
+		SetLeft(root, FindNodeAndDelete(Left(root), data, shorter));
+		if (shorter)
+			root = LeftShorter(root, shorter);
+	}
+	else if (Data(root) < data)
+	{
+		SetRight(root, FindNodeAndDelete(Right(root), data, shorter));
+		if (shorter)
+			root = RightShorter(root, shorter);
+	}
+	else
+	{
+		//this is the node to delete, unlink it and let the callers rebalance on the way back up
+		Index old = root;
+
+		if (Left(root) == NIL) //right only (or empty)
+		{
+			root = Right(root);
+			shorter = true;
+		}
+		else if (Right(root) == NIL) //left only
+		{
+			root = Left(root);
+			shorter = true;
+		}
+		else //both
+		{
+			//the in-order predecessor takes this node's place
+			Index previous = NIL;
+			Index left = RemoveMaxNode(Left(root), previous, shorter);
+
+			SetLeft(previous, left);
+			SetRight(previous, Right(root));
+			SetBalance(previous, GetBalance(root));
+			root = previous;
+
+			if (shorter)
+				root = LeftShorter(root, shorter);
+		}
+
+		DestroyNode(old);
+	}
+
+	return root;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::RemoveMaxNode(Index root, Index& max, bool& shorter)
+{
+	if (Right(root) == NIL)
+	{
+		max = root;
+		shorter = true;
+
+		return Left(root);
+	}
+
+	SetRight(root, RemoveMaxNode(Right(root), max, shorter));
+	if (shorter)
+		root = RightShorter(root, shorter);
+
+	return root;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::LeftShorter(Index root, bool& shorter)
+{
+	switch (GetBalance(root))
+	{
+	case AVLTreeNode<T>::BALANCE::LH:
+		SetBalance(root, AVLTreeNode<T>::BALANCE::EH);
+
+		break;
+	case AVLTreeNode<T>::BALANCE::EH:
+		SetBalance(root, AVLTreeNode<T>::BALANCE::RH);
+		shorter = false;
+
+		break;
+	case AVLTreeNode<T>::BALANCE::RH:
+		if (GetBalance(Right(root)) == AVLTreeNode<T>::BALANCE::LH) //Checks RL
+		{
+			root = RLRotation(root);
+		}
+		else
+		{
+			if (GetBalance(Right(root)) == AVLTreeNode<T>::BALANCE::EH)
+				shorter = false; //a single rotation over an even child keeps the height
+
+			root = RRRotation(root);
+		}
+
+		break;
+	}
+
+	return root;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::RightShorter(Index root, bool& shorter)
+{
+	switch (GetBalance(root))
+	{
+	case AVLTreeNode<T>::BALANCE::LH:
+		if (GetBalance(Left(root)) == AVLTreeNode<T>::BALANCE::RH) //Checks LR
+		{
+			root = LRRotation(root);
+		}
+		else
+		{
+			if (GetBalance(Left(root)) == AVLTreeNode<T>::BALANCE::EH)
+				shorter = false; //a single rotation over an even child keeps the height
+
+			root = LLRotation(root);
+		}
+
+		break;
+	case AVLTreeNode<T>::BALANCE::EH:
+		SetBalance(root, AVLTreeNode<T>::BALANCE::LH);
+		shorter = false;
+
+		break;
+	case AVLTreeNode<T>::BALANCE::RH:
+		SetBalance(root, AVLTreeNode<T>::BALANCE::EH);
+
+		break;
+	}
+
+	return root;
+}
+
+template<typename T>
+inline typename CompactAVLTree<T>::Index CompactAVLTree<T>::FindNode(const T & data) const
+{
+	Index current = m_root;
+
+	while (current != NIL)
+	{
+		if (data < Data(current))
+			current = Left(current);
+		else if (Data(current) < data)
+			current = Right(current);
+		else
+			return current;
+	}
+
+	return NIL;
+}
+
+template<typename T>
+inline bool CompactAVLTree<T>::IsBalancedNode(Index root) const
+{
+	if (root != NIL)
+	{
+		return (IsBalancedNode(Left(root)) &&
+			GetBalance(root) >= -1 && GetBalance(root) <= 1 &&
+			IsBalancedNode(Right(root)));
+	}
+	return true;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool CompactAVLTree<T>::Visit(Visitor& visit, T& data)
+{
+	return Visit(visit, data, std::is_void<decltype(visit(data))>());
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool CompactAVLTree<T>::Visit(Visitor& visit, T& data, std::true_type)
+{
+	visit(data);
+	return true;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool CompactAVLTree<T>::Visit(Visitor& visit, T& data, std::false_type)
+{
+	return static_cast<bool>(visit(data));
+}
@@ -0,0 +1,707 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: ConcurrentAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+using std::max;
+using std::min;
+#include "AVLTreeNode.h"
+#include "ConcurrentAVLTreeNode.h"
+#include "Exception.h"
+#include "ReadWriteSpinLock.h"
+
+/************************************************************************
+* Class: ConcurrentAVLTree
+*
+* Purpose: This class represents an AVLTree that any number of threads
+*		can insert into, delete from and search at the same time. Every
+*		node has its own lock, taken hand over hand on the way down, so a
+*		thread holds the lock of a node before it reads a child pointer.
+*		A writer only keeps the locks of the part of its path its
+*		rebalancing can reach. Below a node whose height the change cannot
+*		alter (unbalanced for Insert, balanced for Delete) the locks above
+*		its parent are let go, so writers in different regions of the key
+*		space run in parallel and only meet near the root when a change
+*		can really reach it. Lookups take the locks shared.
+*		The balance rules and rotations are the ones AVLTree uses, applied
+*		to locked nodes, so the tree is a valid AVL tree between any two
+*		operations. A node is only freed while its parent is held
+*		exclusively, and no thread can be on its way into it then.
+*
+* Manager functions:
+* ConcurrentAVLTree();
+* ~ConcurrentAVLTree();
+*		Frees every node, no other thread may use the tree anymore
+*
+* Methods (safe to call from any number of threads):
+* void Insert(const T& data); / void Insert(T&& data);
+*		Inserts data into the tree
+* void Delete(const T& data);
+*		Deletes the equivalent data from the tree, throws if there is none
+* void Purge();
+*		Removes every item, waiting for the operations already under way
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* bool Find(const T& data, T& found) const;
+*		Like Contains, and copies the stored item into found if it is there
+* int Size() const;
+*		Returns the number of items in the tree
+* bool IsEmpty() const;
+*		Returns true if the tree has no items
+*
+* Methods (only while no other thread changes the tree):
+* int Height() const;
+*		returns the height of the tree, throws if it is empty
+* bool IsBalanced() const;
+*		Returns true if every balance factor is between -1 and 1 and matches the
+*		heights of its subtrees
+* template <typename Visitor> bool InOrder(Visitor visit) const;
+*		Calls visit with every item in order. If visit returns a bool, returning false stops
+*		the traversal. Returns false if it was stopped, true if it finished
+*
+* --- HELPER FUNCTIONS ---
+* struct Step
+*		One locked node on a writer's path, the link it was read from and the side taken next
+* template <typename U> void InsertItem(U&& data);
+*		Helps both Inserts by building the node, linking it in and rebalancing the locked path
+* void ReleaseAbove(Step* path, int& keep, int newKeep);
+*		Unlocks the path above newKeep, whose node stays locked as the owner of the next link
+* void UnlockPath(Step* path, int keep, int depth);
+*		Unlocks everything a writer still holds
+* void LeftTaller / RightTaller(ConcurrentAVLTreeNode<T>*& root, bool& taller);
+* void LeftShorter / RightShorter(ConcurrentAVLTreeNode<T>*& root, bool& shorter);
+*		Fix the balance of "root" after one side changed height. The shorter fixes lock the
+*		sibling (and its inner child) before rotating it, the taller ones only touch the path
+* static void LLRotation / RRRotation(ConcurrentAVLTreeNode<T>*& root);
+*		Rotate "root" and its child, with the same balance rules as AVLTree
+* template <typename Reader> bool Search(const T& data, Reader read) const;
+*		Walks down with shared locks and calls read with the equivalent item while it is locked
+* void PurgeNode(ConcurrentAVLTreeNode<T>* root, bool lock);
+*		Frees root and everything under it, locking each node first if lock is true
+* int GetHeightOfNode(const ConcurrentAVLTreeNode<T>* root) const;
+*		Returns the height of root, or -1 if a balance factor under it is wrong
+* template <typename Visitor> static bool Visit(Visitor& visit, const T& data);
+*		Calls visit and turns its result into "keep going"
+*
+*************************************************************************/
+template <typename T>
+class ConcurrentAVLTree
+{
+public:
+	ConcurrentAVLTree();
+	~ConcurrentAVLTree();
+
+	//Methods
+	void Insert(const T& data); //Inserts data into the tree
+	void Insert(T&& data); //Inserts data into the tree, moving it into the node
+	void Delete(const T& data); //Deletes the equivalent data from the tree
+	void Purge(); //Removes every item
+	int Size() const; //returns the number of items in the tree
+
+	//Lookups
+	bool IsEmpty() const;
+	bool Contains(const T& data) const;
+	bool Find(const T& data, T& found) const;
+
+	//Quiescent checks
+	int Height() const; //returns the height of the tree
+	bool IsBalanced() const;
+	template <typename Visitor> bool InOrder(Visitor visit) const;
+
+private:
+	ConcurrentAVLTree(const ConcurrentAVLTree<T>& copy);
+	ConcurrentAVLTree<T>& operator=(const ConcurrentAVLTree<T>& rhs);
+
+	struct Step
+	{
+		ConcurrentAVLTreeNode<T>* m_node;
+		ConcurrentAVLTreeNode<T>** m_link; //where the parent (or m_root) points at m_node
+		bool m_left; //the side the walk went on from m_node
+	};
+
+	template <typename U> void InsertItem(U&& data);
+	void ReleaseAbove(Step* path, int& keep, int newKeep);
+	void UnlockPath(Step* path, int keep, int depth);
+	void LeftTaller(ConcurrentAVLTreeNode<T>*& root, bool& taller);
+	void RightTaller(ConcurrentAVLTreeNode<T>*& root, bool& taller);
+	void LeftShorter(ConcurrentAVLTreeNode<T>*& root, bool& shorter);
+	void RightShorter(ConcurrentAVLTreeNode<T>*& root, bool& shorter);
+	static void LLRotation(ConcurrentAVLTreeNode<T>*& root);
+	static void RRRotation(ConcurrentAVLTreeNode<T>*& root);
+	template <typename Reader> bool Search(const T& data, Reader read) const;
+	void PurgeNode(ConcurrentAVLTreeNode<T>* root, bool lock);
+	int GetHeightOfNode(const ConcurrentAVLTreeNode<T>* root) const;
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data);
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data, std::true_type);
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data, std::false_type);
+
+	mutable ReadWriteSpinLock m_rootLock; //guards m_root like a node lock guards its children
+	ConcurrentAVLTreeNode<T>* m_root;
+	std::atomic<int> m_numElements;
+};
+
+
+/// Function Code ///
+
+template<typename T>
+inline ConcurrentAVLTree<T>::ConcurrentAVLTree() : m_root(nullptr), m_numElements(0)
+{
+}
+
+template<typename T>
+inline ConcurrentAVLTree<T>::~ConcurrentAVLTree()
+{
+	PurgeNode(m_root, false);
+
+	//Default values
+	m_root = nullptr;
+	m_numElements = 0;
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::Insert(const T & data)
+{
+	InsertItem(data);
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::Insert(T && data)
+{
+	InsertItem(std::move(data));
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::Delete(const T & data)
+{
+	Step path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	int keep = -1; //-1 while m_rootLock is still held, else the first locked step
+	int target = -1;
+
+	m_rootLock.Lock();
+
+	if (m_root == nullptr)
+	{
+		m_rootLock.Unlock();
+		throw Exception("Tried to delete from empty tree");
+	}
+
+	ConcurrentAVLTreeNode<T>** link = &m_root;
+
+	try
+	{
+		while (*link != nullptr)
+		{
+			ConcurrentAVLTreeNode<T>* current = *link;
+			current->m_lock.Lock();
+
+			path[depth].m_node = current;
+			path[depth].m_link = link;
+			++depth;
+
+			bool left = false; //past the target the walk goes left once, then right to the predecessor
+			if (target == -1)
+			{
+				if (data < current->m_data)
+					left = true;
+				else if (!(current->m_data < data))
+				{
+					target = depth - 1;
+					if (current->m_left == nullptr || current->m_right == nullptr)
+						break;
+
+					left = true;
+				}
+			}
+
+			//a balanced node gets one side shorter without changing height, so nothing above it
+			//can change. The target itself must stay locked, its item is replaced at the end
+			if (current->m_balance == ConcurrentAVLTreeNode<T>::BALANCE::EH && (target == -1 || target == depth - 1))
+				ReleaseAbove(path, keep, depth - 2);
+
+			path[depth - 1].m_left = left;
+			link = left ? &current->m_left : &current->m_right;
+		}
+	}
+	catch (...)
+	{
+		//a comparison threw, nothing has changed yet
+		UnlockPath(path, keep, depth);
+		throw;
+	}
+
+	if (target == -1)
+	{
+		UnlockPath(path, keep, depth);
+		throw Exception("Could not find item to delete from tree");
+	}
+
+	//the node to unlink is the target itself or, if it has two children, its predecessor
+	Step removed = path[--depth];
+
+	if (removed.m_node != path[target].m_node)
+		path[target].m_node->m_data = std::move(removed.m_node->m_data);
+
+	*removed.m_link = (removed.m_node->m_left != nullptr) ? removed.m_node->m_left : removed.m_node->m_right;
+	removed.m_node->m_lock.Unlock();
+	delete removed.m_node;
+	--m_numElements;
+
+	bool shorter = true;
+	for (int i = depth - 1; i > keep && shorter; --i)
+	{
+		if (path[i].m_left)
+			LeftShorter(*path[i].m_link, shorter);
+		else
+			RightShorter(*path[i].m_link, shorter);
+	}
+
+	UnlockPath(path, keep, depth);
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::Purge()
+{
+	//nothing new gets in while the root is held, the walk waits out what is already inside
+	m_rootLock.Lock();
+
+	ConcurrentAVLTreeNode<T>* root = m_root;
+	m_root = nullptr;
+	PurgeNode(root, true);
+	m_numElements = 0;
+
+	m_rootLock.Unlock();
+}
+
+template<typename T>
+inline int ConcurrentAVLTree<T>::Size() const
+{
+	return m_numElements.load();
+}
+
+template<typename T>
+inline bool ConcurrentAVLTree<T>::IsEmpty() const
+{
+	return Size() == 0;
+}
+
+template<typename T>
+inline bool ConcurrentAVLTree<T>::Contains(const T & data) const
+{
+	return Search(data, [](const T&) {});
+}
+
+template<typename T>
+inline bool ConcurrentAVLTree<T>::Find(const T & data, T & found) const
+{
+	return Search(data, [&found](const T& item) { found = item; });
+}
+
+template<typename T>
+inline int ConcurrentAVLTree<T>::Height() const
+{
+	if (m_root == nullptr)
+		throw Exception("Tried to get height of empty tree");
+
+	return GetHeightOfNode(m_root);
+}
+
+template<typename T>
+inline bool ConcurrentAVLTree<T>::IsBalanced() const
+{
+	return GetHeightOfNode(m_root) != -1;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool ConcurrentAVLTree<T>::InOrder(Visitor visit) const
+{
+	const ConcurrentAVLTreeNode<T>* path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	const ConcurrentAVLTreeNode<T>* current = m_root;
+
+	while (current != nullptr || depth > 0)
+	{
+		//go as far left as possible, then visit and step into the right subtree
+		while (current != nullptr)
+		{
+			path[depth++] = current;
+			current = current->m_left;
+		}
+
+		current = path[--depth];
+		if (!Visit(visit, current->m_data))
+			return false;
+
+		current = current->m_right;
+	}
+
+	return true;
+}
+
+template<typename T>
+template<typename U>
+inline void ConcurrentAVLTree<T>::InsertItem(U && data)
+{
+	ConcurrentAVLTreeNode<T>* node = new ConcurrentAVLTreeNode<T>(typename ConcurrentAVLTreeNode<T>::InPlace(), std::forward<U>(data));
+	Step path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	int keep = -1; //-1 while m_rootLock is still held, else the first locked step
+
+	m_rootLock.Lock();
+	ConcurrentAVLTreeNode<T>** link = &m_root;
+
+	try
+	{
+		while (*link != nullptr)
+		{
+			ConcurrentAVLTreeNode<T>* current = *link;
+			current->m_lock.Lock();
+
+			path[depth].m_node = current;
+			path[depth].m_link = link;
+			++depth;
+
+			//an unbalanced node absorbs the growth (or rotates back to its old height), so only
+			//its parent, whose link a rotation rewrites, and the nodes below matter from here on
+			if (current->m_balance != ConcurrentAVLTreeNode<T>::BALANCE::EH)
+				ReleaseAbove(path, keep, depth - 2);
+
+			path[depth - 1].m_left = node->m_data < current->m_data;
+			link = path[depth - 1].m_left ? &current->m_left : &current->m_right;
+		}
+	}
+	catch (...)
+	{
+		//a comparison threw, nothing has changed yet
+		UnlockPath(path, keep, depth);
+		delete node;
+		throw;
+	}
+
+	*link = node;
+	++m_numElements;
+
+	bool taller = true;
+	for (int i = depth - 1; i > keep && taller; --i)
+	{
+		if (path[i].m_left)
+			LeftTaller(*path[i].m_link, taller);
+		else
+			RightTaller(*path[i].m_link, taller);
+	}
+
+	UnlockPath(path, keep, depth);
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::ReleaseAbove(Step* path, int& keep, int newKeep)
+{
+	if (newKeep <= keep)
+		return;
+
+	if (keep == -1)
+		m_rootLock.Unlock();
+
+	for (int i = max(keep, 0); i < newKeep; ++i)
+		path[i].m_node->m_lock.Unlock();
+
+	keep = newKeep;
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::UnlockPath(Step* path, int keep, int depth)
+{
+	if (keep == -1)
+		m_rootLock.Unlock();
+
+	for (int i = max(keep, 0); i < depth; ++i)
+		path[i].m_node->m_lock.Unlock();
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::LeftTaller(ConcurrentAVLTreeNode<T>*& root, bool& taller)
+{
+	switch (root->m_balance)
+	{
+	case ConcurrentAVLTreeNode<T>::BALANCE::LH:
+		//the grown left child and its grown child are on the insert path, so already locked
+		if (root->m_left->m_balance == ConcurrentAVLTreeNode<T>::BALANCE::RH) //Checks LR
+		{
+			++(root->m_left->m_balance);
+			RRRotation(root->m_left);
+		}
+		LLRotation(root);
+		taller = false;
+
+		break;
+	case ConcurrentAVLTreeNode<T>::BALANCE::EH:
+		root->m_balance = ConcurrentAVLTreeNode<T>::BALANCE::LH;
+
+		break;
+	case ConcurrentAVLTreeNode<T>::BALANCE::RH:
+		root->m_balance = ConcurrentAVLTreeNode<T>::BALANCE::EH;
+		taller = false;
+
+		break;
+	}
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::RightTaller(ConcurrentAVLTreeNode<T>*& root, bool& taller)
+{
+	switch (root->m_balance)
+	{
+	case ConcurrentAVLTreeNode<T>::BALANCE::LH:
+		root->m_balance = ConcurrentAVLTreeNode<T>::BALANCE::EH;
+		taller = false;
+
+		break;
+	case ConcurrentAVLTreeNode<T>::BALANCE::EH:
+		root->m_balance = ConcurrentAVLTreeNode<T>::BALANCE::RH;
+
+		break;
+	case ConcurrentAVLTreeNode<T>::BALANCE::RH:
+		if (root->m_right->m_balance == ConcurrentAVLTreeNode<T>::BALANCE::LH) //Checks RL
+		{
+			--(root->m_right->m_balance);
+			LLRotation(root->m_right);
+		}
+		RRRotation(root);
+		taller = false;
+
+		break;
+	}
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::LeftShorter(ConcurrentAVLTreeNode<T>*& root, bool& shorter)
+{
+	switch (root->m_balance)
+	{
+	case ConcurrentAVLTreeNode<T>::BALANCE::LH:
+		root->m_balance = ConcurrentAVLTreeNode<T>::BALANCE::EH;
+
+		break;
+	case ConcurrentAVLTreeNode<T>::BALANCE::EH:
+		root->m_balance = ConcurrentAVLTreeNode<T>::BALANCE::RH;
+		shorter = false;
+
+		break;
+	case ConcurrentAVLTreeNode<T>::BALANCE::RH:
+	{
+		//the sibling is off the delete path, so other threads may be reading it. Holding root
+		//keeps new ones out, locking it waits for the ones already there
+		ConcurrentAVLTreeNode<T>* sibling = root->m_right;
+		ConcurrentAVLTreeNode<T>* inner = nullptr;
+		sibling->m_lock.Lock();
+
+		if (sibling->m_balance == ConcurrentAVLTreeNode<T>::BALANCE::LH) //Checks RL
+		{
+			inner = sibling->m_left;
+			inner->m_lock.Lock();
+			--(root->m_right->m_balance);
+			LLRotation(root->m_right);
+		}
+		else if (sibling->m_balance == ConcurrentAVLTreeNode<T>::BALANCE::EH)
+		{
+			shorter = false; //a single rotation over an even child keeps the height
+		}
+		RRRotation(root);
+
+		if (inner != nullptr)
+			inner->m_lock.Unlock();
+		sibling->m_lock.Unlock();
+
+		break;
+	}
+	}
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::RightShorter(ConcurrentAVLTreeNode<T>*& root, bool& shorter)
+{
+	switch (root->m_balance)
+	{
+	case ConcurrentAVLTreeNode<T>::BALANCE::LH:
+	{
+		ConcurrentAVLTreeNode<T>* sibling = root->m_left;
+		ConcurrentAVLTreeNode<T>* inner = nullptr;
+		sibling->m_lock.Lock();
+
+		if (sibling->m_balance == ConcurrentAVLTreeNode<T>::BALANCE::RH) //Checks LR
+		{
+			inner = sibling->m_right;
+			inner->m_lock.Lock();
+			++(root->m_left->m_balance);
+			RRRotation(root->m_left);
+		}
+		else if (sibling->m_balance == ConcurrentAVLTreeNode<T>::BALANCE::EH)
+		{
+			shorter = false; //a single rotation over an even child keeps the height
+		}
+		LLRotation(root);
+
+		if (inner != nullptr)
+			inner->m_lock.Unlock();
+		sibling->m_lock.Unlock();
+
+		break;
+	}
+	case ConcurrentAVLTreeNode<T>::BALANCE::EH:
+		root->m_balance = ConcurrentAVLTreeNode<T>::BALANCE::LH;
+		shorter = false;
+
+		break;
+	case ConcurrentAVLTreeNode<T>::BALANCE::RH:
+		root->m_balance = ConcurrentAVLTreeNode<T>::BALANCE::EH;
+
+		break;
+	}
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::LLRotation(ConcurrentAVLTreeNode<T>*& root)
+{
+	//the subtrees that change parent are not touched, threads inside them keep going
+	ConcurrentAVLTreeNode<T>* left = root->m_left;
+	ConcurrentAVLTreeNode<T>* leftRight = left->m_right;
+
+	++(root->m_balance);
+	root->m_balance = root->m_balance - 1 - max(left->m_balance, 0);
+	left->m_balance = left->m_balance - 1 + min(root->m_balance, 0);
+
+	left->m_right = root;
+	root->m_left = leftRight;
+
+	root = left;
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::RRRotation(ConcurrentAVLTreeNode<T>*& root)
+{
+	ConcurrentAVLTreeNode<T>* right = root->m_right;
+	ConcurrentAVLTreeNode<T>* rightLeft = right->m_left;
+
+	--(root->m_balance);
+	root->m_balance = root->m_balance + 1 - min(right->m_balance, 0);
+	right->m_balance = right->m_balance + 1 + max(root->m_balance, 0);
+
+	right->m_left = root;
+	root->m_right = rightLeft;
+
+	root = right;
+}
+
+template<typename T>
+template<typename Reader>
+inline bool ConcurrentAVLTree<T>::Search(const T & data, Reader read) const
+{
+	m_rootLock.LockShared();
+
+	ConcurrentAVLTreeNode<T>* current = m_root;
+	if (current == nullptr)
+	{
+		m_rootLock.UnlockShared();
+		return false;
+	}
+
+	current->m_lock.LockShared();
+	m_rootLock.UnlockShared();
+
+	bool found = false;
+
+	try
+	{
+		while (current != nullptr)
+		{
+			ConcurrentAVLTreeNode<T>* next = nullptr;
+
+			if (data < current->m_data)
+				next = current->m_left;
+			else if (current->m_data < data)
+				next = current->m_right;
+			else
+			{
+				read(current->m_data);
+				found = true;
+			}
+
+			//take the child before letting go of its parent, so it cannot be freed in between
+			if (next != nullptr)
+				next->m_lock.LockShared();
+			current->m_lock.UnlockShared();
+			current = next;
+		}
+	}
+	catch (...)
+	{
+		current->m_lock.UnlockShared();
+		throw;
+	}
+
+	return found;
+}
+
+template<typename T>
+inline void ConcurrentAVLTree<T>::PurgeNode(ConcurrentAVLTreeNode<T>* root, bool lock)
+{
+	if (root != nullptr)
+	{
+		if (lock)
+			root->m_lock.Lock();
+
+		PurgeNode(root->m_left, lock);
+		PurgeNode(root->m_right, lock);
+
+		if (lock)
+			root->m_lock.Unlock();
+
+		delete root;
+	}
+}
+
+template<typename T>
+inline int ConcurrentAVLTree<T>::GetHeightOfNode(const ConcurrentAVLTreeNode<T>* root) const
+{
+	if (root == nullptr)
+		return 0;
+
+	int left = GetHeightOfNode(root->m_left);
+	int right = GetHeightOfNode(root->m_right);
+
+	if (left == -1 || right == -1 || left - right != root->m_balance || root->m_balance < -1 || root->m_balance > 1)
+		return -1;
+
+	return max(left, right) + 1;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool ConcurrentAVLTree<T>::Visit(Visitor& visit, const T& data)
+{
+	return Visit(visit, data, std::is_void<decltype(visit(data))>());
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool ConcurrentAVLTree<T>::Visit(Visitor& visit, const T& data, std::true_type)
+{
+	visit(data);
+	return true;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool ConcurrentAVLTree<T>::Visit(Visitor& visit, const T& data, std::false_type)
+{
+	return static_cast<bool>(visit(data));
+}
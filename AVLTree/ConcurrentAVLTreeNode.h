@@ -0,0 +1,59 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: ConcurrentAVLTreeNode.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <utility>
+#include "ReadWriteSpinLock.h"
+
+template <typename T>
+class ConcurrentAVLTree;
+
+/************************************************************************
+* Class: ConcurrentAVLTreeNode
+*
+* Purpose: This class represents a node of a ConcurrentAVLTree. Every
+*		node carries its own lock, which guards its balance and child
+*		pointers. A thread only follows a child pointer while it holds
+*		the lock of the node it read the pointer from.
+*
+* Helpers (used by ConcurrentAVLTree):
+* template <typename... Args> ConcurrentAVLTreeNode(InPlace, Args&&... args);
+*		Constructs an unlocked leaf whose data is built from args
+*
+*************************************************************************/
+template <typename T>
+class ConcurrentAVLTreeNode
+{
+	friend class ConcurrentAVLTree<T>;
+
+public:
+
+	enum BALANCE : int { LH = 1, EH = 0, RH = -1}; //LeftHeavy, EqualHeavy, RightHeavy
+
+private:
+	struct InPlace {}; //picks the forwarding constructor over the copy constructor
+
+	template <typename... Args> ConcurrentAVLTreeNode(InPlace, Args&&... args);
+	ConcurrentAVLTreeNode(const ConcurrentAVLTreeNode<T>& copy);
+	ConcurrentAVLTreeNode<T>& operator=(const ConcurrentAVLTreeNode<T>& rhs);
+
+	ReadWriteSpinLock m_lock;
+	T m_data;
+	int m_balance;
+	ConcurrentAVLTreeNode<T>* m_left;
+	ConcurrentAVLTreeNode<T>* m_right;
+};
+
+
+/// Function Code ///
+
+template<typename T>
+template<typename... Args>
+inline ConcurrentAVLTreeNode<T>::ConcurrentAVLTreeNode(InPlace, Args&&... args) : m_data(std::forward<Args>(args)...), m_balance(EH), m_left(nullptr), m_right(nullptr)
+{
+}
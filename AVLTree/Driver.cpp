@@ -1,627 +1,3550 @@
-/*************************************************************
-*
-* Lab / Assignment: Lab4 - AVL Tree
-*
-* Overview:
-*		This program is an implementation of an AVL Tree.
-*		The user will either execute the program with an
-*		argument of how many items they want to insert into
-*		a large-scale test tree with random data, or if no
-*		argument is sent then the program will prompt the user
-*		to input the number of elements to the console instead.
-*		After inserting, the amount of time the operation took
-*		will be printed in milliseconds. Afterward, the
-*		program will execute a series of tests and output
-*		whether they were successful or failed.
-*
-* Input:
-*		The program takes a command argument or otherwise
-*		user input for the number of elements for the large-
-*		scale timing test.
-*
-* Output:
-*		The program will prompt the user for an amount of elements
-*		to perform the large-scale timing test with if not
-*		given with a command argument. The program will then
-*		output how long the insertion operation took in milliseconds
-*		and output the results of subsequent tests on preset data.
-*
-**************************************************************/
-
-/*************************************************************
-* Author: Dillon Wall
-* Filename: Driver.cpp
-* Date Created: 2/20/2019
-* Modifications:
-**************************************************************/
-#define _CRTDBG_MAP_ALLOC
-
-typedef bool(*FunctionPointer)();  // Define a funtion pointer type
-
-#include <crtdbg.h>
-#include <conio.h>
-#include <ctime>
-#include <iostream>
-using std::cout;
-using std::cin;
-using std::endl;
-
-#include "AVLTree.h"
-#include "Exception.h"
-#include "Random.h"
-
-//globals
-int g_int = 0;
-bool g_testVal = false;
-//int g_large_test_data[] = { 23051, 23001, 26015, 14910, 1837, 26646, 5933, 22953, 4959, 20841, 18870, 11710, 11852, 11360, 25049, 25989, 5292,
-//							9571, 29351, 16086, 26566, 2094, 19004, 31598, 7731, 32133, 2210, 11331, 29156, 20770, 7666, 18197, 28519, 21491,
-//							29628, 14918, 2661, 11906, 17833, 29419, 23408, 14261, 27999, 2339, 27387, 9143, 9637, 1704, 11690, 7990, 2248,
-//							31651, 5581, 10959, 20029, 21957, 24103, 19142, 2951, 11667, 29171, 24315, 31836, 32257, 5673, 14105, 5635, 31299,
-//							14333, 14097, 27136, 30176, 1192, 8135, 7155, 4872, 11884, 20490, 28350, 11047, 722, 4554, 11494, 9658, 13879, 18309,
-//							28732, 12642, 2182, 3587, 3260, 4918, 10055, 9795, 8885, 94, 28889, 15285, 7210, 13790 };
-int g_test_data[] = {8, 9, 10, 2, 1, 5, 3, 6, 4, 7, 11};//{ 20, 5, 12, 7, 36, 27, 94, 10, 44 };//{ 20, 12, 25, 11, 18, 22 };
-int g_test_delete_order[] = {4, 5, 8, 9, 10, 2, 1, 3, 6, 7, 11};
-int g_test_data_preorder[] = {5, 3, 2, 1, 4, 8, 6, 7, 10, 9, 11};//{ 20, 5, 12, 7, 10, 36, 27, 94, 44 };
-int g_test_data_postorder[] = {1, 2, 4, 3, 7, 6, 9, 11, 10, 8, 5};//{ 10, 7, 12, 5, 27, 44, 94, 36, 20 };
-int g_test_data_breadthfirst[] = {5, 3, 8, 2, 4, 6, 10, 1, 7, 9, 11};//{ 20, 5, 36, 12, 27, 94, 7, 44, 10 };
-int g_num_elements = 11;
-int g_height = 4;
-
-//traverse functions
-void PrintInt(int& i);
-void CheckInOrder(int& i);
-void CheckPreOrder(int& i);
-void CheckPostOrder(int& i);
-void CheckBreadthFirst(int& i);
-
-// Test function declaration
-bool test_default_ctor();
-bool test_copy_ctor();
-bool test_op_eql();
-
-bool test_insert();
-bool test_delete();
-bool test_delete_empty();
-bool test_purge();
-bool test_height();
-bool test_height_empty();
-
-bool test_in_order();
-bool test_in_order_empty();
-bool test_pre_order();
-bool test_pre_order_empty();
-bool test_post_order();
-bool test_post_order_empty();
-bool test_breadth_first();
-bool test_breadth_first_empty();
-
-
-// Array of test functions
-FunctionPointer test_functions[] = { test_default_ctor, test_copy_ctor, test_op_eql,
-									test_insert, test_delete, test_delete_empty, test_purge, test_height, 
-									test_height_empty, test_in_order, test_in_order_empty, test_pre_order,
-									test_pre_order_empty, test_post_order, test_post_order_empty, 
-									test_breadth_first, test_breadth_first_empty };
-
-int main(int argc, char * argv[])
-{
-	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
-	
-	///-----------------------------LARGE-SCALE-TIMING-TEST-----------------------------///
-	Random::Init();
-
-	int n = 0;
-	if (argc != 2)
-	{
-		cout << "Please enter an integer number of how many elements to add to the tree..." << endl;
-		cin >> n;
-	}
-	else
-	{
-		n = atoi(argv[1]);
-	}
-
-	if (n <= 1)
-	{
-		cout << "Incorrect input (n was <= 1), terminating program" << endl;
-		exit(1);
-	}
-
-	cout << "Inserting " << n << " elements..." << endl;
-
-	AVLTree<int> tree;
-
-	clock_t startTime;
-	clock_t endTime;
-	startTime = clock(); //set timer to current time
-	//create and insert random data
-	for (int i = 0; i < n; ++i)
-	//for (int i = 0; i < 100; ++i)
-	{
-		int r = Random::GetRand();
-		//cout << r << ", ";
-		tree.Insert(r);
-
-		//if (!tree.IsHeightBalanced())
-		//	cout << "The tree is ***NOT*** balanced!" << endl;
-	}
-	endTime = clock(); //set timer to current time
-	double milliSeconds = (endTime - startTime) / (CLOCKS_PER_SEC / 1000); //difference between now and before
-	cout << "It took " << milliSeconds << "ms" << endl;
-
-	//Check in order
-	g_int = -1;
-	g_testVal = true;
-	tree.InOrder(CheckInOrder);
-
-	if (!g_testVal)
-		cout << "The tree is ***NOT*** in order!" << endl;
-	else
-		cout << "The tree is in order!" << endl;
-
-	//Check balanced
-	if (!tree.IsBalanced())
-		cout << "The tree is ***NOT*** balanced!" << endl;
-	else
-		cout << "The tree is balanced!" << endl;
-	///-------------------------------------------------------------------------------///
-
-	///-------------------------------------TESTS-------------------------------------///
-	bool tests_passed = true;
-
-	// Run the test functions
-	for (FunctionPointer func : test_functions)
-	{
-		if (func())
-		{
-			cout << "passed\n";
-		}
-		else
-		{
-			cout << "***** failed *****\n";
-			tests_passed = false;
-		}
-	}
-
-	if (tests_passed) cout << "All tests passed";
-
-	cout << "\nPress Any Key to Exit";
-
-	cin.get();
-}
-
-//-----------------//
-///Test functions ///
-//-----------------//
-
-void PrintInt(int & i)
-{
-	cout << i << " ";
-}
-
-void CheckInOrder(int & i)
-{
-	if (i < g_int)
-		g_testVal = false;
-}
-
-void CheckPreOrder(int & i)
-{
-	if (g_test_data_preorder[g_int] != i)
-		g_testVal = false;
-
-	++g_int;
-}
-
-void CheckPostOrder(int & i)
-{
-	if (g_test_data_postorder[g_int] != i)
-		g_testVal = false;
-
-	++g_int;
-}
-
-void CheckBreadthFirst(int & i)
-{
-	if (g_test_data_breadthfirst[g_int] != i)
-		g_testVal = false;
-
-	++g_int;
-}
-
-bool test_default_ctor()
-{
-	bool pass = true;
-	int default_size = 0;
-
-	AVLTree<int> tree;
-
-	if (!tree.IsEmpty())
-		pass = false;
-
-	cout << "Default ctor test ";
-
-	return pass;
-}
-
-bool test_copy_ctor()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	AVLTree<int> treeCpy(tree);
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		treeCpy.Delete(g_test_data[i]);
-
-		g_int = -1;
-		g_testVal = true;
-		treeCpy.InOrder(CheckInOrder);
-
-		if (!g_testVal)
-			pass = false;
-	}
-
-	cout << "Copy ctor test ";
-
-	return pass;
-}
-
-bool test_op_eql()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	AVLTree<int> treeCpy;
-	treeCpy = tree;
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		treeCpy.Delete(g_test_data[i]);
-
-		g_int = -1;
-		g_testVal = true;
-		treeCpy.InOrder(CheckInOrder);
-
-		if (!g_testVal)
-			pass = false;
-	}
-
-	cout << "Op equals test ";
-
-	return pass;
-}
-
-bool test_insert()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-
-		//Check in order
-		g_int = -1;
-		g_testVal = true;
-		tree.InOrder(CheckInOrder);
-
-		if (!g_testVal)
-			pass = false;
-
-		//Check balanced
-		if (!tree.IsBalanced())
-			pass = false;
-	}
-
-	cout << "Insert test ";
-
-	return pass;
-}
-
-bool test_delete()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		tree.Delete(g_test_delete_order[i]);
-
-		g_int = -1;
-		g_testVal = true;
-		tree.InOrder(CheckInOrder);
-
-		if (!g_testVal)
-			pass = false;
-	}
-
-	if (!tree.IsEmpty())
-		pass = false;
-
-	cout << "Delete test ";
-
-	return pass;
-}
-
-bool test_delete_empty()
-{
-	bool pass = false;
-	bool pass2 = false;
-
-	AVLTree<int> tree;
-
-	try
-	{
-		tree.Delete(42);
-	}
-	catch (Exception c)
-	{
-		pass = true;
-	}
-
-	for (int i = 0; i < g_num_elements; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	try
-	{
-		for (int i = 0; i < g_num_elements + 1 && pass; ++i) //one extra
-		{
-			tree.Delete(g_test_data[i]);
-		}
-	}
-	catch (Exception c)
-	{
-		pass2 = true;
-	}
-
-	cout << "Delete empty test ";
-
-	return pass && pass2;
-}
-
-bool test_purge()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	tree.Purge();
-
-	pass = tree.IsEmpty();
-
-	cout << "Purge test ";
-
-	return pass;
-}
-
-bool test_height()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	pass = tree.Height() == g_height;
-
-	cout << "Height test ";
-
-	return pass;
-}
-
-bool test_height_empty()
-{
-	bool pass = false;
-
-	AVLTree<int> tree;
-
-	try
-	{
-		tree.Height();
-	}
-	catch (Exception e)
-	{
-		pass = true;
-	}
-
-	cout << "Height empty test ";
-
-	return pass;
-}
-
-bool test_in_order()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-
-		g_int = -1;
-		g_testVal = true;
-		tree.InOrder(CheckInOrder);
-
-		if (!g_testVal)
-			pass = false;
-	}
-
-	cout << "In order test ";
-
-	return pass;
-}
-
-bool test_in_order_empty()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	g_int = -1;
-	g_testVal = true;
-	tree.InOrder(CheckInOrder);
-
-	if (!g_testVal)
-		pass = false;
-
-	cout << "In order empty test ";
-
-	return pass;
-}
-
-bool test_pre_order()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	g_int = 0;
-	g_testVal = true;
-	//tree.PreOrder(PrintInt);
-	tree.PreOrder(CheckPreOrder);
-
-	if (!g_testVal)
-		pass = false;
-
-	cout << "Pre-order test ";
-
-	return pass;
-}
-
-bool test_pre_order_empty()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	g_int = 0;
-	g_testVal = true;
-	tree.PreOrder(CheckPreOrder);
-
-	if (!g_testVal)
-		pass = false;
-
-	cout << "Pre-order empty test ";
-
-	return pass;
-}
-
-bool test_post_order()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	g_int = 0;
-	g_testVal = true;
-	//tree.PostOrder(PrintInt);
-	tree.PostOrder(CheckPostOrder);
-
-	if (!g_testVal)
-		pass = false;
-
-	cout << "Post-order test ";
-
-	return pass;
-}
-
-bool test_post_order_empty()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	g_int = 0;
-	g_testVal = true;
-	tree.PostOrder(CheckPostOrder);
-
-	if (!g_testVal)
-		pass = false;
-
-	cout << "Post-order empty test ";
-
-	return pass;
-}
-
-bool test_breadth_first()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	for (int i = 0; i < g_num_elements && pass; ++i)
-	{
-		tree.Insert(g_test_data[i]);
-	}
-
-	g_int = 0;
-	g_testVal = true;
-	tree.BreadthFirst(CheckBreadthFirst);
-
-	if (!g_testVal)
-		pass = false;
-
-	cout << "Breadth-first test ";
-
-	return pass;
-}
-
-bool test_breadth_first_empty()
-{
-	bool pass = true;
-
-	AVLTree<int> tree;
-
-	g_int = 0;
-	g_testVal = true;
-	tree.BreadthFirst(CheckBreadthFirst);
-
-	if (!g_testVal)
-		pass = false;
-
-	cout << "Breadth-first empty test ";
-
-	return pass;
-}
+/*************************************************************
+*
+* Lab / Assignment: Lab4 - AVL Tree
+*
+* Overview:
+*		This program is an implementation of an AVL Tree.
+*		The user will either execute the program with an
+*		argument of how many items they want to insert into
+*		a large-scale test tree with random data, or if no
+*		argument is sent then the program will prompt the user
+*		to input the number of elements to the console instead.
+*		After inserting, the amount of time the operation took
+*		will be printed in milliseconds. Afterward, the
+*		program will execute a series of tests and output
+*		whether they were successful or failed.
+*
+* Input:
+*		The program takes a command argument or otherwise
+*		user input for the number of elements for the large-
+*		scale timing test.
+*
+* Output:
+*		The program will prompt the user for an amount of elements
+*		to perform the large-scale timing test with if not
+*		given with a command argument. The program will then
+*		output how long the insertion operation took in milliseconds
+*		and output the results of subsequent tests on preset data.
+*
+**************************************************************/
+
+/*************************************************************
+* Author: Dillon Wall
+* Filename: Driver.cpp
+* Date Created: 2/20/2019
+* Modifications:
+**************************************************************/
+#define _CRTDBG_MAP_ALLOC
+
+typedef bool(*FunctionPointer)();  // Define a funtion pointer type
+
+#include <crtdbg.h>
+#include <conio.h>
+#include <ctime>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+using std::cout;
+using std::cin;
+using std::endl;
+
+#include "AVLMap.h"
+#include "AVLTree.h"
+#include "BucketAVLTree.h"
+#include "CombiningAVLTree.h"
+#include "CompactAVLTree.h"
+#include "ConcurrentAVLTree.h"
+#include "Exception.h"
+#include "FixedAVLTree.h"
+#include "FrozenBlockTree.h"
+#include "HeapAllocator.h"
+#include "PersistentAVLTree.h"
+#include "Random.h"
+#include "ReadMostlyAVLTree.h"
+#include "ShardedAVLTree.h"
+#include "SmallAVLTree.h"
+#include "SplitAVLMap.h"
+
+//globals
+int g_int = 0;
+bool g_testVal = false;
+//int g_large_test_data[] = { 23051, 23001, 26015, 14910, 1837, 26646, 5933, 22953, 4959, 20841, 18870, 11710, 11852, 11360, 25049, 25989, 5292,
+//							9571, 29351, 16086, 26566, 2094, 19004, 31598, 7731, 32133, 2210, 11331, 29156, 20770, 7666, 18197, 28519, 21491,
+//							29628, 14918, 2661, 11906, 17833, 29419, 23408, 14261, 27999, 2339, 27387, 9143, 9637, 1704, 11690, 7990, 2248,
+//							31651, 5581, 10959, 20029, 21957, 24103, 19142, 2951, 11667, 29171, 24315, 31836, 32257, 5673, 14105, 5635, 31299,
+//							14333, 14097, 27136, 30176, 1192, 8135, 7155, 4872, 11884, 20490, 28350, 11047, 722, 4554, 11494, 9658, 13879, 18309,
+//							28732, 12642, 2182, 3587, 3260, 4918, 10055, 9795, 8885, 94, 28889, 15285, 7210, 13790 };
+int g_test_data[] = {8, 9, 10, 2, 1, 5, 3, 6, 4, 7, 11};//{ 20, 5, 12, 7, 36, 27, 94, 10, 44 };//{ 20, 12, 25, 11, 18, 22 };
+int g_test_delete_order[] = {4, 5, 8, 9, 10, 2, 1, 3, 6, 7, 11};
+int g_test_data_preorder[] = {5, 3, 2, 1, 4, 8, 6, 7, 10, 9, 11};//{ 20, 5, 12, 7, 10, 36, 27, 94, 44 };
+int g_test_data_postorder[] = {1, 2, 4, 3, 7, 6, 9, 11, 10, 8, 5};//{ 10, 7, 12, 5, 27, 44, 94, 36, 20 };
+int g_test_data_breadthfirst[] = {5, 3, 8, 2, 4, 6, 10, 1, 7, 9, 11};//{ 20, 5, 36, 12, 27, 94, 7, 44, 10 };
+int g_num_elements = 11;
+int g_height = 4;
+int g_test_insert_heights[] = {1, 2, 2, 3, 3, 3, 4, 4, 4, 4, 4}; //after each insert of g_test_data
+int g_test_delete_heights[] = {4, 4, 4, 4, 3, 3, 3, 2, 2, 1}; //after each delete of g_test_delete_order
+int g_tracked_copies = 0;
+
+//item that counts its copies, so the move tests can tell a copy from a move
+struct Tracked
+{
+	Tracked(int key = 0) : m_key(key) {}
+	Tracked(int key, int offset) : m_key(key + offset) {}
+	Tracked(const Tracked& copy) : m_key(copy.m_key) { ++g_tracked_copies; }
+	Tracked(Tracked&& other) : m_key(other.m_key) {}
+	Tracked& operator=(const Tracked& rhs) { m_key = rhs.m_key; ++g_tracked_copies; return *this; }
+	Tracked& operator=(Tracked&& rhs) { m_key = rhs.m_key; return *this; }
+
+	bool operator<(const Tracked& rhs) const { return m_key < rhs.m_key; }
+	bool operator>(const Tracked& rhs) const { return m_key > rhs.m_key; }
+	bool operator>=(const Tracked& rhs) const { return m_key >= rhs.m_key; }
+
+	int m_key;
+};
+
+//traverse functions
+void PrintInt(int& i);
+void CheckInOrder(int& i);
+void CheckPreOrder(int& i);
+void CheckPostOrder(int& i);
+void CheckBreadthFirst(int& i);
+
+//shared test helpers
+template <typename T, typename Tested> std::vector<T> ItemsOf(Tested& tested);
+template <typename Tested, typename Key> bool DeleteIfThere(Tested& tested, const Key& key);
+template <typename Insert, typename Erase, typename Check, typename Items>
+bool MatchesAVLTree(AVLTree<std::string>& reference, int rounds, int keys, Insert insert, Erase erase, Check check, Items items);
+template <typename Tested, typename Same> bool CopiesAndMovesKeepItems(Tested& tested, Same same);
+template <typename Tested> bool InsertsOwnItem(Tested& grow, int count);
+
+// Test function declaration
+bool test_default_ctor();
+bool test_copy_ctor();
+bool test_op_eql();
+
+bool test_insert();
+bool test_delete();
+bool test_delete_empty();
+bool test_purge();
+bool test_height();
+bool test_height_empty();
+bool test_height_tracking();
+
+bool test_iterators();
+bool test_iterators_empty();
+bool test_iterator_range();
+
+bool test_visitor_capture();
+bool test_visitor_early_exit();
+bool test_visitor_orders();
+
+bool test_build_from_sorted();
+bool test_build_from_unsorted();
+bool test_union();
+bool test_intersection_difference();
+bool test_join();
+bool test_move();
+bool test_emplace();
+bool test_map_upsert();
+bool test_map_delete();
+bool test_counted();
+bool test_counted_order_statistics();
+bool test_persistent_snapshot();
+bool test_persistent_delete();
+bool test_persistent_copy();
+bool test_persistent_iterators();
+bool test_read_mostly_versions();
+bool test_read_mostly_threads();
+bool test_concurrent_basic();
+bool test_concurrent_writers();
+bool test_sharded_scans();
+bool test_sharded_rebalance();
+bool test_combining_basic();
+bool test_combining_threads();
+bool test_combining_throwing();
+bool test_freeze_layouts();
+bool test_freeze_duplicates();
+bool test_block_lookups();
+bool test_block_extremes();
+bool test_compact_basic();
+bool test_compact_random();
+bool test_split_map_upsert();
+bool test_split_map_records();
+bool test_bucket_basic();
+bool test_bucket_random();
+bool test_bucket_edges();
+bool test_small_basic();
+bool test_small_hysteresis();
+bool test_fixed_inline();
+bool test_fixed_buffer();
+bool test_join_reused_arena();
+bool test_copy_on_write();
+bool test_copy_on_write_versions();
+
+bool test_find();
+bool test_bounds();
+bool test_bounds_empty();
+
+bool test_heap_allocator();
+bool test_purge_reuse();
+
+bool test_size();
+bool test_select_rank();
+bool test_select_empty();
+
+bool test_in_order();
+bool test_in_order_empty();
+bool test_pre_order();
+bool test_pre_order_empty();
+bool test_post_order();
+bool test_post_order_empty();
+bool test_breadth_first();
+bool test_breadth_first_empty();
+
+
+// Array of test functions
+FunctionPointer test_functions[] = { test_default_ctor, test_copy_ctor, test_op_eql,
+									test_insert, test_delete, test_delete_empty, test_purge, test_height, 
+									test_height_empty, test_in_order, test_in_order_empty, test_pre_order,
+									test_pre_order_empty, test_post_order, test_post_order_empty, 
+									test_breadth_first, test_breadth_first_empty, test_find, test_bounds,
+									test_bounds_empty, test_heap_allocator, test_purge_reuse,
+									test_size, test_select_rank, test_select_empty,
+									test_height_tracking, test_iterators, test_iterators_empty,
+									test_iterator_range, test_visitor_capture, test_visitor_early_exit,
+									test_visitor_orders, test_build_from_sorted, test_build_from_unsorted,
+									test_union, test_intersection_difference, test_join,
+									test_move, test_emplace, test_map_upsert, test_map_delete,
+									test_counted, test_counted_order_statistics,
+									test_persistent_snapshot, test_persistent_delete,
+									test_persistent_copy, test_persistent_iterators,
+									test_read_mostly_versions, test_read_mostly_threads,
+									test_concurrent_basic, test_concurrent_writers,
+									test_sharded_scans, test_sharded_rebalance,
+									test_combining_basic, test_combining_threads, test_combining_throwing,
+									test_freeze_layouts, test_freeze_duplicates, test_block_lookups,
+									test_block_extremes, test_compact_basic, test_compact_random,
+									test_split_map_upsert, test_split_map_records, test_bucket_basic,
+									test_bucket_random, test_bucket_edges, test_small_basic, test_small_hysteresis, test_fixed_inline,
+									test_fixed_buffer, test_join_reused_arena, test_copy_on_write,
+									test_copy_on_write_versions };
+
+int main(int argc, char * argv[])
+{
+	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+	
+	///-----------------------------LARGE-SCALE-TIMING-TEST-----------------------------///
+	Random::Init();
+
+	int n = 0;
+	if (argc != 2)
+	{
+		cout << "Please enter an integer number of how many elements to add to the tree..." << endl;
+		cin >> n;
+	}
+	else
+	{
+		n = atoi(argv[1]);
+	}
+
+	if (n <= 1)
+	{
+		cout << "Incorrect input (n was <= 1), terminating program" << endl;
+		exit(1);
+	}
+
+	cout << "Inserting " << n << " elements..." << endl;
+
+	AVLTree<int> tree;
+
+	clock_t startTime;
+	clock_t endTime;
+	startTime = clock(); //set timer to current time
+	//create and insert random data
+	for (int i = 0; i < n; ++i)
+	//for (int i = 0; i < 100; ++i)
+	{
+		int r = Random::GetRand();
+		//cout << r << ", ";
+		tree.Insert(r);
+
+		//if (!tree.IsHeightBalanced())
+		//	cout << "The tree is ***NOT*** balanced!" << endl;
+	}
+	endTime = clock(); //set timer to current time
+	double milliSeconds = (endTime - startTime) / (CLOCKS_PER_SEC / 1000); //difference between now and before
+	cout << "It took " << milliSeconds << "ms" << endl;
+
+	//Check in order
+	g_int = -1;
+	g_testVal = true;
+	tree.InOrder(CheckInOrder);
+
+	if (!g_testVal)
+		cout << "The tree is ***NOT*** in order!" << endl;
+	else
+		cout << "The tree is in order!" << endl;
+
+	//Check balanced
+	if (!tree.IsBalanced())
+		cout << "The tree is ***NOT*** balanced!" << endl;
+	else
+		cout << "The tree is balanced!" << endl;
+	///-------------------------------------------------------------------------------///
+
+	///-------------------------------------TESTS-------------------------------------///
+	bool tests_passed = true;
+
+	// Run the test functions
+	for (FunctionPointer func : test_functions)
+	{
+		if (func())
+		{
+			cout << "passed\n";
+		}
+		else
+		{
+			cout << "***** failed *****\n";
+			tests_passed = false;
+		}
+	}
+
+	if (tests_passed) cout << "All tests passed";
+
+	cout << "\nPress Any Key to Exit";
+
+	cin.get();
+}
+
+//-----------------//
+///Test functions ///
+//-----------------//
+
+void PrintInt(int & i)
+{
+	cout << i << " ";
+}
+
+void CheckInOrder(int & i)
+{
+	if (i < g_int)
+		g_testVal = false;
+}
+
+void CheckPreOrder(int & i)
+{
+	if (g_test_data_preorder[g_int] != i)
+		g_testVal = false;
+
+	++g_int;
+}
+
+void CheckPostOrder(int & i)
+{
+	if (g_test_data_postorder[g_int] != i)
+		g_testVal = false;
+
+	++g_int;
+}
+
+void CheckBreadthFirst(int & i)
+{
+	if (g_test_data_breadthfirst[g_int] != i)
+		g_testVal = false;
+
+	++g_int;
+}
+
+bool test_default_ctor()
+{
+	bool pass = true;
+	int default_size = 0;
+
+	AVLTree<int> tree;
+
+	if (!tree.IsEmpty())
+		pass = false;
+
+	cout << "Default ctor test ";
+
+	return pass;
+}
+
+bool test_copy_ctor()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	AVLTree<int> treeCpy(tree);
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		treeCpy.Delete(g_test_data[i]);
+
+		g_int = -1;
+		g_testVal = true;
+		treeCpy.InOrder(CheckInOrder);
+
+		if (!g_testVal)
+			pass = false;
+	}
+
+	cout << "Copy ctor test ";
+
+	return pass;
+}
+
+bool test_op_eql()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	AVLTree<int> treeCpy;
+	treeCpy = tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		treeCpy.Delete(g_test_data[i]);
+
+		g_int = -1;
+		g_testVal = true;
+		treeCpy.InOrder(CheckInOrder);
+
+		if (!g_testVal)
+			pass = false;
+	}
+
+	cout << "Op equals test ";
+
+	return pass;
+}
+
+bool test_insert()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+
+		//Check in order
+		g_int = -1;
+		g_testVal = true;
+		tree.InOrder(CheckInOrder);
+
+		if (!g_testVal)
+			pass = false;
+
+		//Check balanced
+		if (!tree.IsBalanced())
+			pass = false;
+	}
+
+	cout << "Insert test ";
+
+	return pass;
+}
+
+bool test_delete()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Delete(g_test_delete_order[i]);
+
+		g_int = -1;
+		g_testVal = true;
+		tree.InOrder(CheckInOrder);
+
+		if (!g_testVal)
+			pass = false;
+
+		//Check balanced
+		if (!tree.IsBalanced())
+			pass = false;
+	}
+
+	if (!tree.IsEmpty())
+		pass = false;
+
+	cout << "Delete test ";
+
+	return pass;
+}
+
+bool test_delete_empty()
+{
+	bool pass = false;
+	bool pass2 = false;
+
+	AVLTree<int> tree;
+
+	try
+	{
+		tree.Delete(42);
+	}
+	catch (Exception c)
+	{
+		pass = true;
+	}
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	try
+	{
+		for (int i = 0; i < g_num_elements + 1 && pass; ++i) //one extra
+		{
+			tree.Delete(g_test_data[i]);
+		}
+	}
+	catch (Exception c)
+	{
+		pass2 = true;
+	}
+
+	cout << "Delete empty test ";
+
+	return pass && pass2;
+}
+
+bool test_purge()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	tree.Purge();
+
+	pass = tree.IsEmpty();
+
+	cout << "Purge test ";
+
+	return pass;
+}
+
+bool test_height()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	pass = tree.Height() == g_height;
+
+	cout << "Height test ";
+
+	return pass;
+}
+
+bool test_height_empty()
+{
+	bool pass = false;
+
+	AVLTree<int> tree;
+
+	try
+	{
+		tree.Height();
+	}
+	catch (Exception e)
+	{
+		pass = true;
+	}
+
+	cout << "Height empty test ";
+
+	return pass;
+}
+
+bool test_in_order()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+
+		g_int = -1;
+		g_testVal = true;
+		tree.InOrder(CheckInOrder);
+
+		if (!g_testVal)
+			pass = false;
+	}
+
+	cout << "In order test ";
+
+	return pass;
+}
+
+bool test_in_order_empty()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	g_int = -1;
+	g_testVal = true;
+	tree.InOrder(CheckInOrder);
+
+	if (!g_testVal)
+		pass = false;
+
+	cout << "In order empty test ";
+
+	return pass;
+}
+
+bool test_pre_order()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	g_int = 0;
+	g_testVal = true;
+	//tree.PreOrder(PrintInt);
+	tree.PreOrder(CheckPreOrder);
+
+	if (!g_testVal)
+		pass = false;
+
+	cout << "Pre-order test ";
+
+	return pass;
+}
+
+bool test_pre_order_empty()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	g_int = 0;
+	g_testVal = true;
+	tree.PreOrder(CheckPreOrder);
+
+	if (!g_testVal)
+		pass = false;
+
+	cout << "Pre-order empty test ";
+
+	return pass;
+}
+
+bool test_post_order()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	g_int = 0;
+	g_testVal = true;
+	//tree.PostOrder(PrintInt);
+	tree.PostOrder(CheckPostOrder);
+
+	if (!g_testVal)
+		pass = false;
+
+	cout << "Post-order test ";
+
+	return pass;
+}
+
+bool test_post_order_empty()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	g_int = 0;
+	g_testVal = true;
+	tree.PostOrder(CheckPostOrder);
+
+	if (!g_testVal)
+		pass = false;
+
+	cout << "Post-order empty test ";
+
+	return pass;
+}
+
+bool test_breadth_first()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	g_int = 0;
+	g_testVal = true;
+	tree.BreadthFirst(CheckBreadthFirst);
+
+	if (!g_testVal)
+		pass = false;
+
+	cout << "Breadth-first test ";
+
+	return pass;
+}
+
+bool test_breadth_first_empty()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	g_int = 0;
+	g_testVal = true;
+	tree.BreadthFirst(CheckBreadthFirst);
+
+	if (!g_testVal)
+		pass = false;
+
+	cout << "Breadth-first empty test ";
+
+	return pass;
+}
+
+bool test_find()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		const int* found = tree.Find(g_test_data[i]);
+
+		if (!tree.Contains(g_test_data[i]) || found == nullptr || *found != g_test_data[i])
+			pass = false;
+	}
+
+	if (tree.Contains(0) || tree.Contains(12) || tree.Find(42) != nullptr)
+		pass = false;
+
+	cout << "Find test ";
+
+	return pass;
+}
+
+bool test_bounds()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	//even numbers only so every odd key falls between two items
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i] * 2);
+	}
+
+	if (*tree.LowerBound(6) != 6 || *tree.LowerBound(7) != 8 || tree.LowerBound(23) != tree.end())
+		pass = false;
+
+	if (*tree.UpperBound(6) != 8 || *tree.UpperBound(1) != 2 || tree.UpperBound(22) != tree.end())
+		pass = false;
+
+	if (*tree.Floor(6) != 6 || *tree.Floor(7) != 6 || tree.Floor(1) != nullptr)
+		pass = false;
+
+	if (*tree.Ceiling(7) != 8 || tree.Ceiling(23) != nullptr)
+		pass = false;
+
+	if (*tree.Predecessor(6) != 4 || *tree.Predecessor(100) != 22 || tree.Predecessor(2) != nullptr)
+		pass = false;
+
+	if (*tree.Successor(6) != 8 || *tree.Successor(-5) != 2 || tree.Successor(22) != nullptr)
+		pass = false;
+
+	cout << "Bounds test ";
+
+	return pass;
+}
+
+bool test_bounds_empty()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	if (tree.Contains(1) || tree.Find(1) != nullptr || tree.LowerBound(1) != tree.end() ||
+		tree.UpperBound(1) != tree.end() || tree.Floor(1) != nullptr || tree.Predecessor(1) != nullptr)
+		pass = false;
+
+	cout << "Bounds empty test ";
+
+	return pass;
+}
+
+bool test_heap_allocator()
+{
+	bool pass = true;
+
+	AVLTree<int, HeapAllocator> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	AVLTree<int, HeapAllocator> treeCpy(tree);
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Delete(g_test_delete_order[i]);
+
+		if (tree.Contains(g_test_delete_order[i]) || !tree.IsBalanced())
+			pass = false;
+	}
+
+	if (!tree.IsEmpty() || treeCpy.Height() != g_height)
+		pass = false;
+
+	cout << "Heap allocator test ";
+
+	return pass;
+}
+
+bool test_purge_reuse()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	tree.Purge();
+
+	//the arena was released, make sure it can be filled again
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		if (!tree.Contains(g_test_data[i]))
+			pass = false;
+	}
+
+	if (tree.Height() != g_height)
+		pass = false;
+
+	//emptied by Delete, the tree still holds its chunks until Purge gives them back
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Delete(g_test_delete_order[i]);
+
+	tree.Purge();
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	if (tree.Size() != g_num_elements || tree.Height() != g_height || !tree.IsBalanced())
+		pass = false;
+
+	cout << "Purge reuse test ";
+
+	return pass;
+}
+
+bool test_size()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+
+		if (tree.Size() != i + 1)
+			pass = false;
+	}
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Delete(g_test_delete_order[i]);
+
+		if (tree.Size() != g_num_elements - i - 1)
+			pass = false;
+	}
+
+	cout << "Size test ";
+
+	return pass;
+}
+
+bool test_select_rank()
+{
+	bool pass = true;
+
+	AVLTree<int, ArenaAllocator, AVL_ORDER_STATISTICS> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	//the test data is 1 to g_num_elements, so the k-th smallest is k + 1
+	for (int k = 0; k < g_num_elements && pass; ++k)
+	{
+		if (tree.Select(k) != k + 1 || tree.At(k) != k + 1 || tree.Rank(k + 1) != k)
+			pass = false;
+	}
+
+	if (tree.CountRange(3, 7) != 5 || tree.CountRange(-5, 100) != g_num_elements || tree.CountRange(7, 3) != 0)
+		pass = false;
+
+	//sizes have to survive the rotations done by deletes
+	for (int i = 0; i < 5 && pass; ++i)
+	{
+		tree.Delete(g_test_delete_order[i]);
+	}
+
+	//left: 1, 2, 3, 6, 7, 11
+	if (tree.Select(0) != 1 || tree.Select(3) != 6 || tree.Select(5) != 11 || tree.Rank(7) != 4)
+		pass = false;
+
+	cout << "Select and rank test ";
+
+	return pass;
+}
+
+bool test_select_empty()
+{
+	bool pass = false;
+
+	AVLTree<int, ArenaAllocator, AVL_ORDER_STATISTICS> tree;
+
+	try
+	{
+		tree.Select(0);
+	}
+	catch (Exception e)
+	{
+		pass = true;
+	}
+
+	if (tree.Rank(5) != 0 || tree.CountRange(0, 10) != 0)
+		pass = false;
+
+	cout << "Select empty test ";
+
+	return pass;
+}
+
+bool test_height_tracking()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+
+		if (tree.Height() != g_test_insert_heights[i])
+			pass = false;
+	}
+
+	for (int i = 0; i < g_num_elements - 1 && pass; ++i)
+	{
+		tree.Delete(g_test_delete_order[i]);
+
+		if (tree.Height() != g_test_delete_heights[i])
+			pass = false;
+	}
+
+	AVLTree<int> treeCpy(tree);
+
+	if (treeCpy.Height() != tree.Height())
+		pass = false;
+
+	cout << "Height tracking test ";
+
+	return pass;
+}
+
+bool test_iterators()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	//the test data is 1 to g_num_elements
+	int expected = 1;
+	for (int item : tree)
+	{
+		if (item != expected)
+			pass = false;
+
+		++expected;
+	}
+
+	if (expected != g_num_elements + 1)
+		pass = false;
+
+	expected = g_num_elements;
+	for (AVLTree<int>::const_reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it)
+	{
+		if (*it != expected)
+			pass = false;
+
+		--expected;
+	}
+
+	if (expected != 0)
+		pass = false;
+
+	//the reverse end steps back onto the first item, and base is one past it like std::reverse_iterator
+	AVLTree<int>::const_reverse_iterator last = tree.rend();
+	--last;
+	if (*last != 1 || last.base() != ++tree.begin() || tree.rbegin().base() != tree.end() || tree.rend().base() != tree.begin())
+		pass = false;
+
+	//walk back from the end
+	AVLTree<int>::const_iterator it = tree.end();
+	--it;
+	if (*it != g_num_elements || *(--it) != g_num_elements - 1 || *(it++) != g_num_elements - 1 || *it != g_num_elements)
+		pass = false;
+
+	if (std::distance(tree.begin(), tree.end()) != g_num_elements)
+		pass = false;
+
+	cout << "Iterators test ";
+
+	return pass;
+}
+
+bool test_iterators_empty()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	if (tree.begin() != tree.end() || tree.rbegin() != tree.rend())
+		pass = false;
+
+	for (int item : tree)
+	{
+		(void)item;
+		pass = false;
+	}
+
+	cout << "Iterators empty test ";
+
+	return pass;
+}
+
+bool test_iterator_range()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i] * 2);
+	}
+
+	//everything in [5, 13], stopping early at the upper bound
+	int expected = 6;
+	for (AVLTree<int>::const_iterator it = tree.LowerBound(5); it != tree.UpperBound(13); ++it)
+	{
+		if (*it != expected)
+			pass = false;
+
+		expected += 2;
+	}
+
+	if (expected != 14)
+		pass = false;
+
+	cout << "Iterator range test ";
+
+	return pass;
+}
+
+bool test_visitor_capture()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	int previous = 0;
+	int count = 0;
+	bool finished = tree.InOrder([&](int& i)
+	{
+		if (i <= previous)
+			pass = false;
+
+		previous = i;
+		++count;
+	});
+
+	if (!finished || count != g_num_elements)
+		pass = false;
+
+	cout << "Visitor capture test ";
+
+	return pass;
+}
+
+bool test_visitor_early_exit()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	//first 3 keys only
+	int found[3] = { 0 };
+	int count = 0;
+	bool finished = tree.InOrder([&](int& i)
+	{
+		found[count++] = i;
+		return count < 3;
+	});
+
+	if (finished || count != 3 || found[0] != 1 || found[1] != 2 || found[2] != 3)
+		pass = false;
+
+	//stopping on the very first item
+	count = 0;
+	tree.PostOrder([&](int&) { ++count; return false; });
+	tree.BreadthFirst([&](int&) { ++count; return false; });
+
+	if (count != 2)
+		pass = false;
+
+	cout << "Visitor early exit test ";
+
+	return pass;
+}
+
+bool test_visitor_orders()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	int index = 0;
+	tree.PreOrder([&](int& i)
+	{
+		if (g_test_data_preorder[index++] != i)
+			pass = false;
+	});
+
+	index = 0;
+	tree.PostOrder([&](int& i)
+	{
+		if (g_test_data_postorder[index++] != i)
+			pass = false;
+	});
+
+	index = 0;
+	tree.BreadthFirst([&](int& i)
+	{
+		if (g_test_data_breadthfirst[index++] != i)
+			pass = false;
+	});
+
+	if (index != g_num_elements)
+		pass = false;
+
+	cout << "Visitor orders test ";
+
+	return pass;
+}
+
+bool test_build_from_sorted()
+{
+	bool pass = true;
+
+	int sorted[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+	AVLTree<int> tree(sorted, sorted + g_num_elements);
+
+	int expected = 1;
+	for (int item : tree)
+	{
+		if (item != expected++)
+			pass = false;
+	}
+
+	if (tree.Size() != g_num_elements || tree.Height() != g_height || !tree.IsBalanced())
+		pass = false;
+
+	//a built tree has to keep working as a normal tree
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		tree.Delete(g_test_delete_order[i]);
+
+		if (!tree.IsBalanced())
+			pass = false;
+	}
+
+	if (!tree.IsEmpty())
+		pass = false;
+
+	//rebuilding replaces the old contents
+	AVLTree<int, ArenaAllocator, AVL_ORDER_STATISTICS> ranked;
+	ranked.Insert(42);
+	ranked.BuildFromSorted(sorted, sorted + 7);
+
+	if (ranked.Size() != 7 || ranked.Height() != 3 || ranked.Contains(42) || ranked.Select(3) != 4)
+		pass = false;
+
+	cout << "Build from sorted test ";
+
+	return pass;
+}
+
+bool test_build_from_unsorted()
+{
+	bool pass = false;
+
+	AVLTree<int> tree;
+	tree.Insert(42);
+
+	try
+	{
+		tree.BuildFromSorted(g_test_data, g_test_data + g_num_elements);
+	}
+	catch (Exception e)
+	{
+		pass = true;
+	}
+
+	//the old contents are untouched
+	if (tree.Size() != 1 || !tree.Contains(42))
+		pass = false;
+
+	cout << "Build from unsorted test ";
+
+	return pass;
+}
+
+bool test_union()
+{
+	bool pass = true;
+
+	AVLTree<int, ArenaAllocator, AVL_ORDER_STATISTICS> evens;
+	AVLTree<int, ArenaAllocator, AVL_ORDER_STATISTICS> threes;
+
+	for (int i = 0; i < 100; i += 2)
+		evens.Insert(i);
+	for (int i = 0; i < 100; i += 3)
+		threes.Insert(i);
+
+	evens.Union(threes);
+
+	//every number divisible by 2 or 3 once, the 17 shared ones are not doubled
+	int expected = 0;
+	for (int item : evens)
+	{
+		while (expected % 2 != 0 && expected % 3 != 0)
+			++expected;
+
+		if (item != expected++)
+			pass = false;
+	}
+
+	if (evens.Size() != 67 || !threes.IsEmpty() || !evens.IsBalanced())
+		pass = false;
+
+	if (evens.Select(5) != 8 || evens.Rank(99) != 66)
+		pass = false;
+
+	//the emptied tree has to be usable again
+	threes.Insert(7);
+	if (threes.Size() != 1 || !threes.Contains(7))
+		pass = false;
+
+	//union with itself changes nothing
+	evens.Union(evens);
+	if (evens.Size() != 67)
+		pass = false;
+
+	cout << "Union test ";
+
+	return pass;
+}
+
+bool test_intersection_difference()
+{
+	bool pass = true;
+
+	AVLTree<int> evens;
+	AVLTree<int> threes;
+	AVLTree<int> evens2;
+	AVLTree<int> threes2;
+
+	for (int i = 0; i < 100; i += 2)
+	{
+		evens.Insert(i);
+		evens2.Insert(i);
+	}
+	for (int i = 0; i < 100; i += 3)
+	{
+		threes.Insert(i);
+		threes2.Insert(i);
+	}
+
+	evens.Intersection(threes);
+
+	int expected = 0;
+	for (int item : evens)
+	{
+		if (item != expected)
+			pass = false;
+
+		expected += 6;
+	}
+
+	if (evens.Size() != 17 || !threes.IsEmpty() || !evens.IsBalanced())
+		pass = false;
+
+	evens2.Difference(threes2);
+
+	for (int item : evens2)
+	{
+		if (item % 2 != 0 || item % 3 == 0)
+			pass = false;
+	}
+
+	if (evens2.Size() != 33 || !threes2.IsEmpty() || !evens2.IsBalanced())
+		pass = false;
+
+	//intersecting with an empty tree empties this one
+	evens.Intersection(threes);
+	if (!evens.IsEmpty() || evens.Size() != 0)
+		pass = false;
+
+	//taking a tree away from itself leaves nothing
+	evens2.Difference(evens2);
+	if (!evens2.IsEmpty())
+		pass = false;
+
+	cout << "Intersection and difference test ";
+
+	return pass;
+}
+
+bool test_join()
+{
+	bool pass = true;
+
+	AVLTree<int, HeapAllocator> small;
+	AVLTree<int, HeapAllocator> large;
+
+	for (int i = 0; i < 3; ++i)
+		small.Insert(i);
+	for (int i = 4; i < 200; ++i)
+		large.Insert(i);
+
+	small.Join(3, large);
+
+	int expected = 0;
+	for (int item : small)
+	{
+		if (item != expected++)
+			pass = false;
+	}
+
+	if (expected != 200 || small.Size() != 200 || !large.IsEmpty() || !small.IsBalanced())
+		pass = false;
+
+	//out of order joins are refused and leave both trees alone
+	large.Insert(100);
+	try
+	{
+		small.Join(500, large);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	if (small.Size() != 200 || large.Size() != 1)
+		pass = false;
+
+	//joining onto an empty tree
+	AVLTree<int, HeapAllocator> empty;
+	empty.Join(-1, small);
+
+	if (empty.Size() != 201 || *empty.begin() != -1 || !small.IsEmpty() || !empty.IsBalanced())
+		pass = false;
+
+	cout << "Join test ";
+
+	return pass;
+}
+
+bool test_move()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	AVLTree<int> moved(std::move(tree));
+
+	if (moved.Size() != g_num_elements || moved.Height() != g_height || !tree.IsEmpty() || tree.Size() != 0)
+		pass = false;
+
+	int expected = 1;
+	for (int item : moved)
+	{
+		if (item != expected++)
+			pass = false;
+	}
+
+	//the moved-from tree is still a working tree
+	tree.Insert(42);
+	tree = std::move(moved);
+
+	if (tree.Size() != g_num_elements || tree.Contains(42) || !moved.IsEmpty() || !tree.IsBalanced())
+		pass = false;
+
+	//moving into itself keeps the items
+	AVLTree<int>& self = tree;
+	tree = std::move(self);
+	if (tree.Size() != g_num_elements)
+		pass = false;
+
+	//the whole arena moves, free blocks included, and both trees keep allocating from their own
+	AVLTree<int> drained;
+	for (int i = 0; i < 1000; ++i)
+		drained.Insert(i);
+	for (int i = 10; i < 1000; ++i)
+		drained.Delete(i);
+
+	tree = std::move(drained);
+	for (int i = 10; i < 2000; ++i)
+	{
+		tree.Insert(i);
+		drained.Insert(-i);
+	}
+
+	if (tree.Size() != 2000 || drained.Size() != 1990 || !tree.IsBalanced() || !drained.Contains(-1999) ||
+		*tree.begin() != 0 || *drained.begin() != -1999)
+		pass = false;
+
+	cout << "Move test ";
+
+	return pass;
+}
+
+bool test_emplace()
+{
+	bool pass = true;
+
+	AVLTree<Tracked, HeapAllocator> tree;
+	g_tracked_copies = 0;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(Tracked(g_test_data[i]));
+		tree.Emplace(g_test_data[i], 100);
+	}
+
+	//moved and emplaced items are never copied, not even by the node
+	if (g_tracked_copies != 0 || tree.Size() != 2 * g_num_elements || !tree.IsBalanced())
+		pass = false;
+
+	int expected = 1;
+	for (const Tracked& item : tree)
+	{
+		if (item.m_key != expected)
+			pass = false;
+
+		expected = (expected == g_num_elements) ? 101 : expected + 1;
+	}
+
+	AVLTree<std::string> words;
+	std::string word("balanced");
+	words.Insert(std::move(word));
+	words.Emplace(3, 'a');
+	words.Insert(std::string("tree"));
+
+	if (words.Size() != 3 || !words.Contains("aaa") || !words.Contains("balanced") || *words.rbegin() != "tree")
+		pass = false;
+
+	cout << "Emplace test ";
+
+	return pass;
+}
+
+bool test_map_upsert()
+{
+	bool pass = true;
+
+	AVLMap<std::string, int> counts;
+	const char* words[] = { "tree", "node", "tree", "root", "leaf", "tree", "node" };
+
+	for (const char* word : words)
+		++counts[word];
+
+	if (counts.Size() != 4 || counts["tree"] != 3 || counts["node"] != 2 || counts["root"] != 1)
+		pass = false;
+
+	//Insert never overwrites, InsertOrAssign does
+	if (counts.Insert("leaf", 10) || *counts.Find("leaf") != 1 || !counts.Insert("stem", 10))
+		pass = false;
+
+	if (counts.InsertOrAssign("leaf", 20) || *counts.Find("leaf") != 20 || !counts.InsertOrAssign("bark", 5))
+		pass = false;
+
+	//TryEmplace builds the value in place and leaves existing keys alone
+	AVLMap<int, std::string, HeapAllocator> names;
+	if (!names.TryEmplace(3, 3, 'c') || names.TryEmplace(3, 5, 'x') || *names.Find(3) != "ccc")
+		pass = false;
+
+	//entries come out ordered by key
+	const char* expected[] = { "bark", "leaf", "node", "root", "stem", "tree" };
+	int i = 0;
+	for (const AVLMapEntry<std::string, int>& entry : counts)
+	{
+		if (i >= 6 || entry.GetKey() != expected[i++])
+			pass = false;
+	}
+
+	if (i != 6 || counts.Find("trunk") != nullptr || counts.Contains("trunk") || counts.Size() != 6)
+		pass = false;
+
+	cout << "Map upsert test ";
+
+	return pass;
+}
+
+bool test_map_delete()
+{
+	bool pass = true;
+
+	AVLMap<int, int, ArenaAllocator, AVL_ORDER_STATISTICS> squares;
+	for (int i = 0; i < g_num_elements; ++i)
+		squares[g_test_data[i]] = g_test_data[i] * g_test_data[i];
+
+	for (int i = 0; i < g_num_elements - 1; ++i)
+		squares.Delete(g_test_delete_order[i]);
+
+	if (squares.Size() != 1 || squares[11] != 121)
+		pass = false;
+
+	try
+	{
+		squares.Delete(4);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	//a copy keeps its own entries
+	AVLMap<int, int, ArenaAllocator, AVL_ORDER_STATISTICS> copy(squares);
+	copy[11] = 0;
+	squares.Purge();
+
+	if (!squares.IsEmpty() || copy.Size() != 1 || copy[11] != 0)
+		pass = false;
+
+	cout << "Map delete test ";
+
+	return pass;
+}
+
+bool test_counted()
+{
+	bool pass = true;
+
+	AVLTree<int, ArenaAllocator, AVL_COUNTED> tree;
+
+	//three rounds of the same items only add to the counts
+	for (int round = 0; round < 3; ++round)
+	{
+		for (int i = 0; i < g_num_elements; ++i)
+			tree.Insert(g_test_data[i]);
+	}
+
+	if (tree.Size() != 3 * g_num_elements || tree.Height() != g_height || tree.Count(5) != 3 || tree.Count(42) != 0)
+		pass = false;
+
+	//iterators see each distinct item once
+	int expected = 1;
+	for (int item : tree)
+	{
+		if (item != expected++)
+			pass = false;
+	}
+
+	//a delete takes one copy, the node goes with the last one
+	tree.Delete(5);
+	tree.Delete(5);
+	if (tree.Count(5) != 1 || !tree.Contains(5) || tree.Size() != 3 * g_num_elements - 2)
+		pass = false;
+
+	tree.Delete(5);
+	if (tree.Count(5) != 0 || tree.Contains(5) || !tree.IsBalanced())
+		pass = false;
+
+	//plain trees count their equal nodes instead
+	AVLTree<int> plain;
+	plain.Insert(7);
+	plain.Insert(7);
+	plain.Insert(3);
+	if (plain.Count(7) != 2 || plain.Count(3) != 1 || plain.Count(4) != 0)
+		pass = false;
+
+	cout << "Counted test ";
+
+	return pass;
+}
+
+bool test_counted_order_statistics()
+{
+	bool pass = true;
+
+	int sorted[] = { 1, 1, 1, 2, 4, 4, 9 };
+
+	AVLTree<int, HeapAllocator, AVL_COUNTED | AVL_ORDER_STATISTICS> tree(sorted, sorted + 7);
+
+	if (tree.Size() != 7 || tree.Height() != 3 || tree.Count(1) != 3 || tree.Count(4) != 2)
+		pass = false;
+
+	for (int k = 0; k < 7; ++k)
+	{
+		if (tree.Select(k) != sorted[k])
+			pass = false;
+	}
+
+	if (tree.Rank(2) != 3 || tree.Rank(5) != 6 || tree.CountRange(1, 4) != 6)
+		pass = false;
+
+	tree.Insert(4);
+	tree.Delete(1);
+	if (tree.Select(2) != 2 || tree.Rank(9) != 6 || tree.CountRange(4, 4) != 3)
+		pass = false;
+
+	cout << "Counted order statistics test ";
+
+	return pass;
+}
+
+bool test_persistent_snapshot()
+{
+	bool pass = true;
+
+	PersistentAVLTree<int> tree;
+	PersistentAVLTree<int> versions[12];
+
+	//keep every version on the way up
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		versions[i] = tree.Snapshot();
+		tree.Insert(g_test_data[i]);
+	}
+	versions[g_num_elements] = tree.Snapshot();
+
+	//version i holds exactly the first i items
+	for (int i = 0; i <= g_num_elements && pass; ++i)
+	{
+		if (versions[i].Size() != i || !versions[i].IsBalanced())
+			pass = false;
+
+		for (int j = 0; j < g_num_elements; ++j)
+		{
+			if (versions[i].Contains(g_test_data[j]) != (j < i))
+				pass = false;
+		}
+
+		if (i > 0 && versions[i].Height() != g_test_insert_heights[i - 1])
+			pass = false;
+	}
+
+	//writing to a snapshot does not reach the tree it came from
+	PersistentAVLTree<int> branch = versions[3];
+	branch.Insert(100);
+	if (versions[3].Contains(100) || !branch.Contains(100) || branch.Size() != 4)
+		pass = false;
+
+	g_int = -1;
+	g_testVal = true;
+	tree.InOrder([](const int& item) { if (item <= g_int) g_testVal = false; g_int = item; });
+	if (!g_testVal || g_int != 11)
+		pass = false;
+
+	cout << "Persistent snapshot test ";
+
+	return pass;
+}
+
+bool test_persistent_delete()
+{
+	bool pass = true;
+
+	PersistentAVLTree<int> tree;
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	PersistentAVLTree<int> before = tree.Snapshot();
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Delete(g_test_delete_order[i]);
+
+		if (!tree.IsBalanced() || (i < g_num_elements - 1 && tree.Height() != g_test_delete_heights[i]))
+			pass = false;
+	}
+
+	//the snapshot still has every item
+	int count = 0;
+	before.InOrder([&count](const int& item) { if (item != ++count) return false; return true; });
+	if (!tree.IsEmpty() || before.Size() != g_num_elements || count != g_num_elements || !before.IsBalanced())
+		pass = false;
+
+	try
+	{
+		before.Delete(42);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	cout << "Persistent delete test ";
+
+	return pass;
+}
+
+PersistentAVLTree<int> PassByValue(PersistentAVLTree<int> tree)
+{
+	//a pipeline stage that changes its own copy
+	tree.Delete(5);
+	tree.Insert(12);
+
+	return tree;
+}
+
+bool test_persistent_copy()
+{
+	bool pass = true;
+
+	PersistentAVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+	}
+
+	PersistentAVLTree<int> treeCpy(tree);
+	PersistentAVLTree<int> treeEql;
+	treeEql = tree;
+
+	//copies are independent once either side changes
+	for (int i = 0; i < g_num_elements && pass; ++i)
+	{
+		treeCpy.Delete(g_test_data[i]);
+
+		g_int = -1;
+		g_testVal = true;
+		treeCpy.InOrder([](const int& item) { int copy = item; CheckInOrder(copy); });
+
+		if (!g_testVal || treeCpy.Size() != g_num_elements - 1 - i)
+			pass = false;
+	}
+
+	PersistentAVLTree<int> stage = PassByValue(treeEql);
+
+	if (tree.Size() != g_num_elements || treeEql.Size() != g_num_elements || !treeEql.Contains(5) || treeEql.Contains(12))
+		pass = false;
+
+	if (stage.Size() != g_num_elements || stage.Contains(5) || !stage.Contains(12) || !stage.IsBalanced())
+		pass = false;
+
+	cout << "Persistent copy test ";
+
+	return pass;
+}
+
+bool test_persistent_iterators()
+{
+	bool pass = true;
+
+	PersistentAVLTree<int> tree;
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	PersistentAVLTree<int> before = tree;
+	tree.Delete(6);
+
+	int expected = 1;
+	for (int item : before)
+	{
+		if (item != expected++)
+			pass = false;
+	}
+
+	if (expected != g_num_elements + 1 || *tree.LowerBound(6) != 7 || *tree.UpperBound(7) != 8 || tree.UpperBound(11) != tree.end())
+		pass = false;
+
+	expected = g_num_elements;
+	for (PersistentAVLTree<int>::const_reverse_iterator current = tree.rbegin(); current != tree.rend(); ++current)
+	{
+		if (expected == 6)
+			--expected;
+
+		if (*current != expected--)
+			pass = false;
+	}
+
+	PersistentAVLTree<int> empty;
+	if (empty.begin() != empty.end() || empty.LowerBound(1) != empty.end())
+		pass = false;
+
+	cout << "Persistent iterators test ";
+
+	return pass;
+}
+
+bool test_read_mostly_versions()
+{
+	bool pass = true;
+
+	ReadMostlyAVLTree<int> tree;
+	ReadMostlyAVLTree<int>::Reader reader(tree);
+
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	//nothing was pinned, so every replaced version is gone already
+	if (tree.Retired() != 0 || reader.Size() != g_num_elements || !reader.Contains(6))
+		pass = false;
+
+	//a pinned version does not change and outlives the writes after it
+	const PersistentAVLTree<int>& pinned = reader.Enter();
+	const int* six = pinned.Find(6);
+
+	tree.Delete(6);
+	tree.Insert(12);
+
+	if (six == nullptr || *six != 6 || pinned.Contains(12) || pinned.Size() != g_num_elements || tree.Retired() != 2)
+		pass = false;
+
+	reader.Leave();
+	tree.Reclaim();
+
+	int found = 0;
+	if (tree.Retired() != 0 || reader.Contains(6) || !reader.Find(12, found) || found != 12)
+		pass = false;
+
+	PersistentAVLTree<int> snapshot = reader.Snapshot();
+	tree.Purge();
+
+	if (snapshot.Size() != g_num_elements || !snapshot.IsBalanced() || reader.Size() != 0)
+		pass = false;
+
+	try
+	{
+		tree.Delete(1);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	cout << "Read mostly versions test ";
+
+	return pass;
+}
+
+bool test_read_mostly_threads()
+{
+	const int READERS = 4;
+	const int ITEMS = 2000;
+
+	ReadMostlyAVLTree<int> tree;
+	std::atomic<bool> done(false);
+	std::atomic<bool> pass(true);
+
+	//the odd numbers stay in the tree the whole time
+	for (int i = 1; i < ITEMS; i += 2)
+		tree.Insert(i);
+
+	std::thread readers[READERS];
+	for (int r = 0; r < READERS; ++r)
+	{
+		readers[r] = std::thread([&tree, &done, &pass]()
+		{
+			ReadMostlyAVLTree<int>::Reader reader(tree);
+
+			while (!done.load())
+			{
+				//every version a reader sees is a whole, sorted and balanced tree
+				const PersistentAVLTree<int>& version = reader.Enter();
+				int count = 0;
+				int last = -1;
+
+				for (int item : version)
+				{
+					if (item <= last)
+						pass = false;
+					last = item;
+					++count;
+				}
+
+				if (count != version.Size() || !version.IsBalanced() || !version.Contains(ITEMS - 1))
+					pass = false;
+
+				reader.Leave();
+			}
+		});
+	}
+
+	for (int i = 0; i < ITEMS; i += 2)
+		tree.Insert(i);
+	for (int i = 0; i < ITEMS; i += 2)
+		tree.Delete(i);
+
+	done = true;
+	for (int r = 0; r < READERS; ++r)
+		readers[r].join();
+
+	tree.Reclaim();
+
+	ReadMostlyAVLTree<int>::Reader reader(tree);
+	if (tree.Retired() != 0 || reader.Size() != ITEMS / 2 || reader.Contains(0))
+		pass = false;
+
+	cout << "Read mostly threads test ";
+
+	return pass;
+}
+
+bool test_concurrent_basic()
+{
+	bool pass = true;
+
+	ConcurrentAVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	g_int = -1;
+	g_testVal = true;
+	tree.InOrder([](const int& item) { int copy = item; CheckInOrder(copy); });
+
+	if (!g_testVal || tree.Size() != g_num_elements || !tree.IsBalanced() || tree.Height() != 4)
+		pass = false;
+
+	//every shape of delete: a leaf, a node with one child and the root with two
+	tree.Delete(1);
+	tree.Delete(2);
+	tree.Delete(g_test_data[0]);
+
+	int found = 0;
+	if (tree.Contains(1) || tree.Contains(2) || tree.Contains(g_test_data[0]) || !tree.Find(11, found) || found != 11 ||
+		tree.Size() != g_num_elements - 3 || !tree.IsBalanced())
+		pass = false;
+
+	try
+	{
+		tree.Delete(42);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	tree.Purge();
+
+	try
+	{
+		tree.Delete(3);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	if (!tree.IsEmpty() || tree.Contains(3))
+		pass = false;
+
+	cout << "Concurrent basic test ";
+
+	return pass;
+}
+
+bool test_concurrent_writers()
+{
+	const int WRITERS = 4;
+	const int ITEMS = 4000;
+
+	ConcurrentAVLTree<int> tree;
+	std::atomic<bool> pass(true);
+	std::thread writers[WRITERS];
+
+	//each writer owns the keys that leave its number as remainder, so they meet all over the tree
+	for (int w = 0; w < WRITERS; ++w)
+	{
+		writers[w] = std::thread([&tree, &pass, w]()
+		{
+			for (int i = w; i < ITEMS; i += WRITERS)
+				tree.Insert(i);
+
+			for (int i = w; i < ITEMS; i += 2 * WRITERS)
+				tree.Delete(i);
+
+			for (int i = w; i < ITEMS; i += WRITERS)
+			{
+				if (tree.Contains(i) != ((i / WRITERS) % 2 == 1))
+					pass = false;
+			}
+		});
+	}
+
+	for (int w = 0; w < WRITERS; ++w)
+		writers[w].join();
+
+	int last = -1;
+	int count = 0;
+	tree.InOrder([&](const int& item)
+	{
+		if (item <= last || (item / WRITERS) % 2 == 0)
+			pass = false;
+		last = item;
+		++count;
+	});
+
+	if (count != ITEMS / 2 || tree.Size() != ITEMS / 2 || !tree.IsBalanced())
+		pass = false;
+
+	cout << "Concurrent writers test ";
+
+	return pass;
+}
+
+bool test_sharded_scans()
+{
+	bool pass = true;
+
+	ShardedAVLTree<int> tree(3);
+
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	//spread the items over the shards, the scans have to stitch them back together
+	tree.Rebalance();
+
+	for (int i = 0; i < tree.ShardCount(); ++i)
+	{
+		if (tree.ShardSize(i) == 0)
+			pass = false;
+	}
+
+	g_int = -1;
+	g_testVal = true;
+	tree.InOrder([](const int& item) { int copy = item; CheckInOrder(copy); });
+
+	int expected = 3;
+	bool finished = tree.Range(3, 9, [&](const int& item) { if (item != expected++) pass = false; });
+
+	if (!g_testVal || !finished || expected != 10 || tree.Size() != g_num_elements)
+		pass = false;
+
+	int visited = 0;
+	if (tree.Range(2, 11, [&](const int&) { return ++visited < 4; }) || visited != 4)
+		pass = false;
+
+	tree.Delete(5);
+
+	int found = 0;
+	if (tree.Contains(5) || !tree.Find(11, found) || found != 11 || tree.Size() != g_num_elements - 1)
+		pass = false;
+
+	try
+	{
+		tree.Delete(5);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	tree.Purge();
+	if (!tree.IsEmpty() || tree.Contains(1))
+		pass = false;
+
+	cout << "Sharded scans test ";
+
+	return pass;
+}
+
+bool test_sharded_rebalance()
+{
+	const int SHARDS = 4;
+	const int WINDOW = ShardedAVLTree<int>::CHECK_INTERVAL * SHARDS;
+
+	bool pass = true;
+
+	ShardedAVLTree<int> tree(SHARDS);
+
+	//increasing keys land in the last shard in use, each window splits it into the next one,
+	//then the last shard hands half its items to the one before it
+	int next = 0;
+	for (; next < 4 * WINDOW; ++next)
+		tree.Insert(next);
+
+	//only the items past each bound moved, the first shard kept its half of the first window
+	int sizes[SHARDS];
+	for (int i = 0; i < SHARDS; ++i)
+		sizes[i] = tree.ShardSize(i);
+
+	if (sizes[0] != WINDOW / 2 || sizes[1] != 3 * WINDOW / 4 || sizes[SHARDS - 1] == 0)
+		pass = false;
+
+	//the last shard stays hot, so the checks back off instead of moving items every window
+	for (; next < 7 * WINDOW; ++next)
+		tree.Insert(next);
+
+	for (int i = 0; i < SHARDS - 1; ++i)
+	{
+		if (tree.ShardSize(i) != sizes[i])
+			pass = false;
+	}
+
+	if (tree.ShardSize(SHARDS - 1) != sizes[SHARDS - 1] + 3 * WINDOW)
+		pass = false;
+
+	tree.Rebalance();
+
+	for (int i = 0; i < SHARDS; ++i)
+	{
+		if (tree.ShardSize(i) != 7 * WINDOW / SHARDS)
+			pass = false;
+	}
+
+	//writers spread over the key space delete the even keys while one more keeps appending
+	//odd ones past the end, which moves bounds under the others and under the scans
+	const int TAIL = 7 * WINDOW;
+	std::thread writers[SHARDS + 1];
+	for (int w = 0; w < SHARDS; ++w)
+	{
+		writers[w] = std::thread([&tree, w]()
+		{
+			for (int i = w * TAIL / SHARDS; i < (w + 1) * TAIL / SHARDS; i += 2)
+				tree.Delete(i);
+		});
+	}
+
+	writers[SHARDS] = std::thread([&tree]()
+	{
+		for (int i = TAIL + 1; i < TAIL + 2 * WINDOW; i += 2)
+			tree.Insert(i);
+	});
+
+	for (int scan = 0; scan < 8; ++scan)
+	{
+		int last = -1;
+		tree.InOrder([&](const int& item)
+		{
+			if (item <= last)
+				pass = false;
+			last = item;
+		});
+	}
+
+	for (int w = 0; w <= SHARDS; ++w)
+		writers[w].join();
+
+	int last = -1;
+	int count = 0;
+	tree.InOrder([&](const int& item)
+	{
+		if (item <= last || item % 2 == 0)
+			pass = false;
+		last = item;
+		++count;
+	});
+
+	if (count != TAIL / 2 + WINDOW || tree.Size() != count || !tree.Contains(TAIL + 1) || tree.Contains(TAIL - 2))
+		pass = false;
+
+	cout << "Sharded rebalance test ";
+
+	return pass;
+}
+
+bool test_combining_basic()
+{
+	bool pass = true;
+
+	CombiningAVLTree<int> tree;
+
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	g_int = -1;
+	g_testVal = true;
+	tree.InOrder([](const int& item) { int copy = item; CheckInOrder(copy); });
+
+	if (!g_testVal || tree.Size() != g_num_elements || !tree.Contains(6) || !tree.IsBalanced())
+		pass = false;
+
+	tree.Delete(6);
+
+	//the combiner's exception comes back on the posting thread
+	try
+	{
+		tree.Delete(6);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	if (tree.Contains(6) || tree.Size() != g_num_elements - 1)
+		pass = false;
+
+	cout << "Combining basic test ";
+
+	return pass;
+}
+
+bool test_combining_threads()
+{
+	const int THREADS = 4;
+	const int ITEMS = 4000;
+
+	CombiningAVLTree<int> tree;
+	std::atomic<bool> pass(true);
+	std::thread threads[THREADS];
+
+	for (int t = 0; t < THREADS; ++t)
+	{
+		threads[t] = std::thread([&tree, &pass, t]()
+		{
+			for (int i = t; i < ITEMS; i += THREADS)
+				tree.Insert(i);
+
+			for (int i = t; i < ITEMS; i += 2 * THREADS)
+				tree.Delete(i);
+
+			for (int i = t; i < ITEMS; i += THREADS)
+			{
+				if (tree.Contains(i) != ((i / THREADS) % 2 == 1))
+					pass = false;
+			}
+		});
+	}
+
+	for (int t = 0; t < THREADS; ++t)
+		threads[t].join();
+
+	int count = 0;
+	tree.InOrder([&](const int& item)
+	{
+		if ((item / THREADS) % 2 == 0)
+			pass = false;
+		++count;
+	});
+
+	if (count != ITEMS / 2 || tree.Size() != ITEMS / 2 || !tree.IsBalanced())
+		pass = false;
+
+	cout << "Combining threads test ";
+
+	return pass;
+}
+
+bool test_combining_throwing()
+{
+	const int THREADS = 4;
+	const int ITEMS = 2000;
+
+	//every 37th comparison throws, in the combiner's sort as well as in the tree
+	static std::atomic<int> compares(0);
+	static std::atomic<bool> throwing(true);
+
+	struct Touchy
+	{
+		bool operator<(const Touchy& rhs) const
+		{
+			if (throwing && compares.fetch_add(1) % 37 == 0)
+				throw Exception("Comparison failed");
+
+			return m_key < rhs.m_key;
+		}
+
+		int m_key;
+	};
+
+	CombiningAVLTree<Touchy> tree;
+	std::atomic<bool> pass(true);
+	std::atomic<int> inserted(0);
+	std::thread threads[THREADS];
+
+	//a request lost by the sort would never be answered, one sorted in twice would be inserted twice
+	for (int t = 0; t < THREADS; ++t)
+	{
+		threads[t] = std::thread([&tree, &inserted, t]()
+		{
+			for (int i = t; i < ITEMS; i += THREADS)
+			{
+				try
+				{
+					tree.Insert(Touchy{ i });
+					++inserted;
+				}
+				catch (Exception)
+				{
+				}
+			}
+		});
+	}
+
+	for (int t = 0; t < THREADS; ++t)
+		threads[t].join();
+
+	throwing = false;
+
+	int count = 0;
+	int last = -1;
+	tree.InOrder([&](const Touchy& item)
+	{
+		if (item.m_key <= last)
+			pass = false;
+		last = item.m_key;
+		++count;
+	});
+
+	if (count != inserted || tree.Size() != inserted || inserted == 0 || !tree.IsBalanced())
+		pass = false;
+
+	cout << "Combining throwing test ";
+
+	return pass;
+}
+
+bool test_freeze_layouts()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i] * 2); //even keys, so every gap can be searched too
+
+	FROZEN_LAYOUT layouts[] = { FROZEN_EYTZINGER, FROZEN_VEB };
+
+	for (FROZEN_LAYOUT layout : layouts)
+	{
+		FrozenAVLTree<int> frozen = tree.Freeze(layout);
+
+		g_int = -1;
+		g_testVal = true;
+		frozen.InOrder([](const int& item) { int copy = item; CheckInOrder(copy); });
+
+		if (!g_testVal || frozen.Size() != g_num_elements || frozen.Layout() != layout)
+			pass = false;
+
+		for (int key = 0; key <= 2 * g_num_elements + 1; ++key)
+		{
+			const int* bound = frozen.LowerBound(key);
+			AVLTree<int>::const_iterator expected = tree.LowerBound(key);
+
+			if ((bound == nullptr) != (expected == tree.end()) || (bound != nullptr && *bound != *expected))
+				pass = false;
+
+			if (frozen.Contains(key) != tree.Contains(key))
+				pass = false;
+		}
+	}
+
+	FrozenAVLTree<int> empty = AVLTree<int>().Freeze(FROZEN_VEB);
+	if (!empty.IsEmpty() || empty.Contains(1) || empty.LowerBound(1) != nullptr)
+		pass = false;
+
+	int unsorted[] = { 3, 1, 2 };
+	try
+	{
+		FrozenAVLTree<int> bad(unsorted, unsorted + 3);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	cout << "Freeze layouts test ";
+
+	return pass;
+}
+
+bool test_freeze_duplicates()
+{
+	bool pass = true;
+
+	//sizes around full levels make the van Emde Boas cuts land everywhere
+	for (int count = 1; count <= 70 && pass; ++count)
+	{
+		AVLTree<int> tree;
+		for (int i = 0; i < count; ++i)
+			tree.Insert(i / 2);
+
+		FrozenAVLTree<int> eytzinger = tree.Freeze(FROZEN_EYTZINGER);
+		FrozenAVLTree<int> veb = tree.Freeze(FROZEN_VEB);
+
+		int seen = 0;
+		veb.InOrder([&](const int& item) { if (item != seen++ / 2) pass = false; });
+
+		for (int key = -1; key <= count / 2 + 1; ++key)
+		{
+			AVLTree<int>::const_iterator expected = tree.LowerBound(key);
+			const int* first = eytzinger.LowerBound(key);
+			const int* second = veb.LowerBound(key);
+
+			if (expected == tree.end())
+			{
+				if (first != nullptr || second != nullptr)
+					pass = false;
+			}
+			else if (first == nullptr || second == nullptr || *first != *expected || *second != *expected)
+			{
+				pass = false;
+			}
+		}
+
+		if (seen != count)
+			pass = false;
+	}
+
+	cout << "Freeze duplicates test ";
+
+	return pass;
+}
+
+bool test_block_lookups()
+{
+	bool pass = true;
+
+	//past one block, past one full level of 16 + 1 children and into a third level
+	for (int count = 0; count <= 320 && pass; count += (count < 40 ? 1 : 7))
+	{
+		AVLTree<int> tree;
+		for (int i = 0; i < count; ++i)
+			tree.Insert(i * 2 - count); //even keys around zero, so negatives and gaps are searched too
+
+		FrozenBlockTree<int> blocks(tree.begin(), tree.end());
+		FrozenBlockTree<int, 64> wide(tree.begin(), tree.end());
+
+		if (blocks.Size() != count || wide.Size() != count || blocks.IsEmpty() != (count == 0))
+			pass = false;
+
+		for (int key = -count - 2; key <= count + 2; ++key)
+		{
+			AVLTree<int>::const_iterator expected = tree.LowerBound(key);
+			const int* first = blocks.LowerBound(key);
+			const int* second = wide.LowerBound(key);
+
+			if (expected == tree.end())
+			{
+				if (first != nullptr || second != nullptr)
+					pass = false;
+			}
+			else if (first == nullptr || second == nullptr || *first != *expected || *second != *expected)
+			{
+				pass = false;
+			}
+
+			if (blocks.Contains(key) != tree.Contains(key) || wide.Contains(key) != tree.Contains(key))
+				pass = false;
+		}
+	}
+
+	int unsorted[] = { 3, 1, 2 };
+	try
+	{
+		FrozenBlockTree<int> bad(unsorted, unsorted + 3);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	cout << "Block lookups test ";
+
+	return pass;
+}
+
+bool test_block_extremes()
+{
+	bool pass = true;
+
+	//the padding is the largest value, so a real largest value has to be told apart from it
+	unsigned int high[] = { 0u, 1u, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFEu, 0xFFFFFFFFu };
+	FrozenBlockTree<unsigned int> unsignedKeys(high, high + 6);
+	FrozenBlockTree<unsigned int> noLargest(high, high + 5);
+
+	for (int i = 0; i < 6; ++i)
+	{
+		if (!unsignedKeys.Contains(high[i]) || (i < 5) != noLargest.Contains(high[i]))
+			pass = false;
+	}
+
+	const unsigned int* bound = unsignedKeys.LowerBound(0x80000001u);
+	if (bound == nullptr || *bound != 0xFFFFFFFEu || noLargest.LowerBound(0xFFFFFFFFu) != nullptr)
+		pass = false;
+
+	//keys of other sizes take the scalar compare
+	short small[] = { -32768, -5, 0, 7, 7, 32767 };
+	FrozenBlockTree<short> shortKeys(small, small + 6);
+	long long wide[] = { -9000000000LL, 0LL, 9000000000LL };
+	FrozenBlockTree<long long> longKeys(wide, wide + 3);
+
+	if (!shortKeys.Contains(-32768) || !shortKeys.Contains(32767) || shortKeys.Contains(8) ||
+		*shortKeys.LowerBound(1) != 7 || !longKeys.Contains(9000000000LL) || longKeys.Contains(1LL))
+		pass = false;
+
+	FrozenBlockTree<int> empty;
+	if (!empty.IsEmpty() || empty.Contains(0) || empty.LowerBound(-1) != nullptr)
+		pass = false;
+
+	cout << "Block extremes test ";
+
+	return pass;
+}
+
+bool test_compact_basic()
+{
+	bool pass = true;
+
+	AVLTree<int> tree;
+	CompactAVLTree<int> compact;
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		tree.Insert(g_test_data[i]);
+		compact.Insert(g_test_data[i]);
+	}
+
+	//same rotations, so the same shape: every traversal has to visit in the same order
+	std::vector<int> expected;
+	std::vector<int> seen;
+	tree.PreOrder([&](int& item) { expected.push_back(item); });
+	compact.PreOrder([&](int& item) { seen.push_back(item); });
+	tree.PostOrder([&](int& item) { expected.push_back(item); });
+	compact.PostOrder([&](int& item) { seen.push_back(item); });
+	tree.BreadthFirst([&](int& item) { expected.push_back(item); });
+	compact.BreadthFirst([&](int& item) { seen.push_back(item); });
+
+	if (seen != expected || compact.Height() != tree.Height() || compact.Size() != g_num_elements || !compact.IsBalanced())
+		pass = false;
+
+	g_int = -1;
+	g_testVal = true;
+	compact.InOrder(CheckInOrder);
+	if (!g_testVal)
+		pass = false;
+
+	if (!compact.Contains(7) || compact.Contains(12) || *compact.Find(3) != 3 || *compact.Floor(0 + 12) != 11 ||
+		compact.Floor(0) != nullptr || *compact.Ceiling(-5) != 1 || compact.Ceiling(12) != nullptr)
+		pass = false;
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		compact.Delete(g_test_data[i]);
+		tree.Delete(g_test_data[i]);
+
+		if (compact.Contains(g_test_data[i]) || !compact.IsBalanced() || (!tree.IsEmpty() && compact.Height() != tree.Height()))
+			pass = false;
+	}
+
+	try
+	{
+		compact.Delete(1);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	//deleted slots are reused before the pool grows
+	int capacity = compact.Capacity();
+	for (int i = 0; i < g_num_elements; ++i)
+		compact.Insert(g_test_data[i]);
+
+	if (compact.Capacity() != capacity || compact.Size() != g_num_elements)
+		pass = false;
+
+	compact.Purge();
+	if (!compact.IsEmpty() || compact.Capacity() != 0 || compact.Size() != 0)
+		pass = false;
+
+	cout << "Compact basic test ";
+
+	return pass;
+}
+
+template <typename T, typename Tested>
+std::vector<T> ItemsOf(Tested& tested)
+{
+	std::vector<T> items;
+	tested.InOrder([&](T& item) { items.push_back(item); });
+
+	return items;
+}
+
+template <typename Tested, typename Key>
+bool DeleteIfThere(Tested& tested, const Key& key)
+{
+	if (!tested.Contains(key))
+		return false;
+
+	tested.Delete(key);
+
+	return true;
+}
+
+//random inserts and deletes of keys below keys, applied to the tested structure by insert and erase
+//and to reference alike. insert returns false when the tested structure did not gain an item (it was
+//full, or assigned an existing key) and erase whether it found the key, the reference follows suit.
+//check runs after every round, items returns the tested structure's items in order for the final check
+template <typename Insert, typename Erase, typename Check, typename Items>
+bool MatchesAVLTree(AVLTree<std::string>& reference, int rounds, int keys, Insert insert, Erase erase, Check check, Items items)
+{
+	bool pass = true;
+
+	for (int i = 0; i < rounds; ++i)
+	{
+		std::string key = std::to_string(Random::GetRand(keys));
+
+		if (Random::GetRand(3) == 0)
+		{
+			if (erase(key) != reference.Contains(key))
+				pass = false;
+			else if (reference.Contains(key))
+				reference.Delete(key);
+		}
+		else if (insert(key))
+		{
+			reference.Insert(key); //duplicates included
+		}
+
+		if (!check())
+			pass = false;
+	}
+
+	if (items() != ItemsOf<std::string>(reference))
+		pass = false;
+
+	return pass;
+}
+
+//a copy of tested, moved into another, has to keep every item and leave the copy empty.
+//same checks anything else the moved one has to share with tested
+template <typename Tested, typename Same>
+bool CopiesAndMovesKeepItems(Tested& tested, Same same)
+{
+	Tested copy(tested);
+	Tested moved(std::move(copy));
+
+	return ItemsOf<std::string>(moved) == ItemsOf<std::string>(tested) && copy.IsEmpty() && same(moved);
+}
+
+//inserts count copies of one item, each read from the structure itself while it grows
+template <typename Tested>
+bool InsertsOwnItem(Tested& grow, int count)
+{
+	const std::string item(40, 'x');
+	grow.Insert(item);
+	for (int i = 1; i < count; ++i)
+		grow.Insert(*grow.Find(item));
+
+	int copies = 0;
+	grow.InOrder([&](std::string& stored) { copies += (stored == item) ? 1 : 0; });
+
+	return copies == count;
+}
+
+bool test_compact_random()
+{
+	bool pass = true;
+
+	//strings have destructors, so moving the pool and reusing slots have to run them right
+	AVLTree<std::string> tree;
+	CompactAVLTree<std::string> compact;
+
+	if (!MatchesAVLTree(tree, 4000, 500,
+		[&](const std::string& key) { compact.Emplace(key); return true; },
+		[&](const std::string& key) { return DeleteIfThere(compact, key); },
+		[&]() { return compact.IsBalanced() && (tree.IsEmpty() || compact.Height() == tree.Height()); },
+		[&]() { return ItemsOf<std::string>(compact); }))
+		pass = false;
+
+	//same rotations, so the same shape
+	std::vector<std::string> expected;
+	std::vector<std::string> seen;
+	tree.PreOrder([&](std::string& item) { expected.push_back(item); });
+	compact.PreOrder([&](std::string& item) { seen.push_back(item); });
+
+	if (seen != expected)
+		pass = false;
+
+	//copies keep the same slots, moves hand the pool over
+	if (!CopiesAndMovesKeepItems(compact, [&](CompactAVLTree<std::string>& moved) { return moved.Size() == compact.Size(); }))
+		pass = false;
+
+	//an item from the tree itself, inserted while the pool grows
+	CompactAVLTree<std::string> grow;
+	if (!InsertsOwnItem(grow, 200))
+		pass = false;
+
+	cout << "Compact random test ";
+
+	return pass;
+}
+
+bool test_split_map_upsert()
+{
+	bool pass = true;
+
+	SplitAVLMap<std::string, int> counts;
+	const char* words[] = { "tree", "node", "tree", "root", "leaf", "tree", "node" };
+
+	for (const char* word : words)
+		++counts[word];
+
+	if (counts.Size() != 4 || counts["tree"] != 3 || counts["node"] != 2 || counts["root"] != 1)
+		pass = false;
+
+	//Insert never overwrites, InsertOrAssign does
+	if (counts.Insert("leaf", 10) || *counts.Find("leaf") != 1 || !counts.Insert("stem", 10))
+		pass = false;
+
+	if (counts.InsertOrAssign("leaf", 20) || *counts.Find("leaf") != 20 || !counts.InsertOrAssign("bark", 5))
+		pass = false;
+
+	SplitAVLMap<int, std::string> names;
+	if (!names.TryEmplace(3, 3, 'c') || names.TryEmplace(3, 5, 'x') || *names.Find(3) != "ccc")
+		pass = false;
+
+	//the key goes in before its value is built, a throwing value takes it out again
+	struct Picky
+	{
+		explicit Picky(int n) : m_n(n) { if (n < 0) throw Exception("Negative value"); }
+
+		int m_n;
+	};
+
+	SplitAVLMap<int, Picky> picky;
+	try
+	{
+		picky.TryEmplace(1, -1);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	if (picky.Contains(1) || !picky.IsEmpty() || !picky.TryEmplace(1, 1) || picky.Find(1)->m_n != 1)
+		pass = false;
+
+	//entries come out ordered by key, each with its own value
+	const char* expected[] = { "bark", "leaf", "node", "root", "stem", "tree" };
+	int values[] = { 5, 20, 2, 1, 10, 3 };
+	int i = 0;
+	counts.InOrder([&](const std::string& key, int& value) { if (i >= 6 || key != expected[i] || value != values[i]) pass = false; ++i; });
+
+	if (i != 6 || counts.Find("trunk") != nullptr || counts.Contains("trunk") || counts.Size() != 6)
+		pass = false;
+
+	for (int j = 0; j < 6; ++j)
+		counts.Delete(expected[j]);
+
+	try
+	{
+		counts.Delete("tree");
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	if (!counts.IsEmpty())
+		pass = false;
+
+	cout << "Split map upsert test ";
+
+	return pass;
+}
+
+bool test_split_map_records()
+{
+	bool pass = true;
+
+	//a record as big as four cache lines, only touched after the key is found
+	struct Record
+	{
+		Record() : m_id(0) {}
+		explicit Record(int id) : m_id(id), m_name(std::to_string(id)) {}
+
+		int m_id;
+		std::string m_name;
+		char m_pad[256 - sizeof(int) - sizeof(std::string)];
+	};
+
+	//the reference holds the keys, every assignment gets a new id the record has to keep
+	AVLTree<std::string> keys;
+	SplitAVLMap<int, Record> records;
+	int id = 0;
+	auto keysOf = [&](SplitAVLMap<int, Record>& map)
+	{
+		std::vector<std::string> found;
+		map.InOrder([&](const int& key, Record& record)
+		{
+			found.push_back(std::to_string(key));
+			if (record.m_name != std::to_string(record.m_id))
+				pass = false;
+		});
+
+		//the reference orders the keys as strings
+		std::sort(found.begin(), found.end());
+
+		return found;
+	};
+
+	if (!MatchesAVLTree(keys, 3000, 400,
+		[&](const std::string& key)
+		{
+			bool added = records.InsertOrAssign(std::stoi(key), Record(++id));
+			if (records.Find(std::stoi(key))->m_id != id)
+				pass = false;
+
+			return added;
+		},
+		[&](const std::string& key) { return DeleteIfThere(records, std::stoi(key)); },
+		[&]() { return records.Size() == keys.Size(); },
+		[&]() { return keysOf(records); }))
+		pass = false;
+
+	//a copy and a move keep every record with its key
+	SplitAVLMap<int, Record> copy(records);
+	std::vector<std::string> expected = keysOf(records);
+	std::vector<int> ids;
+	records.InOrder([&](const int&, Record& record) { ids.push_back(record.m_id); });
+
+	SplitAVLMap<int, Record> moved(std::move(records));
+	std::vector<int> movedIds;
+	std::vector<int> copiedIds;
+	moved.InOrder([&](const int&, Record& record) { movedIds.push_back(record.m_id); });
+	copy.InOrder([&](const int&, Record& record) { copiedIds.push_back(record.m_id); });
+
+	if (keysOf(moved) != expected || keysOf(copy) != expected || movedIds != ids || copiedIds != ids || !records.IsEmpty())
+		pass = false;
+
+	//a value from the map itself, inserted while the values move to a bigger array
+	SplitAVLMap<int, std::string> grow;
+	grow[0] = std::string(40, 'y');
+	for (int i = 1; i < 200; ++i)
+		grow.Insert(i, *grow.Find(0));
+
+	int copies = 0;
+	grow.InOrder([&](const int&, std::string& value) { copies += (value == std::string(40, 'y')) ? 1 : 0; });
+	if (copies != 200)
+		pass = false;
+
+	cout << "Split map records test ";
+
+	return pass;
+}
+
+bool test_bucket_basic()
+{
+	bool pass = true;
+
+	//ascending inserts fill every bucket before splitting off the next one
+	BucketAVLTree<int, 16> bucket;
+	for (int i = 0; i < 1000; ++i)
+		bucket.Insert(i);
+
+	if (bucket.Size() != 1000 || bucket.BucketCount() > 1000 / 16 + 1 || !bucket.IsBalanced())
+		pass = false;
+
+	g_int = -1;
+	g_testVal = true;
+	bucket.InOrder(CheckInOrder);
+	if (!g_testVal)
+		pass = false;
+
+	if (!bucket.Contains(500) || bucket.Contains(1000) || *bucket.Find(999) != 999 || *bucket.Floor(5000) != 999 ||
+		bucket.Floor(-1) != nullptr || *bucket.Ceiling(-5) != 0 || bucket.Ceiling(1000) != nullptr)
+		pass = false;
+
+	//every other item gone leaves half full buckets, which merge when they drain further
+	for (int i = 0; i < 1000; i += 2)
+		bucket.Delete(i);
+
+	int buckets = bucket.BucketCount();
+	for (int i = 1; i < 1000; i += 4)
+		bucket.Delete(i);
+
+	if (bucket.Size() != 250 || bucket.BucketCount() >= buckets || !bucket.IsBalanced() ||
+		bucket.Contains(1) || !bucket.Contains(3) || *bucket.Floor(6) != 3 || *bucket.Ceiling(4) != 7)
+		pass = false;
+
+	try
+	{
+		bucket.Delete(1);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	for (int i = 3; i < 1000; i += 4)
+		bucket.Delete(i);
+
+	if (!bucket.IsEmpty() || bucket.BucketCount() != 0)
+		pass = false;
+
+	try
+	{
+		bucket.Delete(3);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	cout << "Bucket basic test ";
+
+	return pass;
+}
+
+bool test_bucket_random()
+{
+	bool pass = true;
+
+	//strings have destructors, so shifting, splitting and merging buckets have to run them right
+	AVLTree<std::string> tree;
+	BucketAVLTree<std::string, 8> bucket;
+
+	if (!MatchesAVLTree(tree, 4000, 500,
+		[&](const std::string& key) { bucket.Insert(key); return true; },
+		[&](const std::string& key) { return DeleteIfThere(bucket, key); },
+		[&]() { return bucket.IsBalanced() && bucket.Size() == tree.Size() && bucket.BucketCount() <= bucket.Size(); },
+		[&]() { return ItemsOf<std::string>(bucket); }))
+		pass = false;
+
+	//copies and moves keep every bucket
+	if (!CopiesAndMovesKeepItems(bucket, [&](BucketAVLTree<std::string, 8>& moved) { return moved.BucketCount() == bucket.BucketCount(); }))
+		pass = false;
+
+	//an item from the tree itself, inserted while its bucket splits
+	BucketAVLTree<std::string, 8> grow;
+	if (!InsertsOwnItem(grow, 200))
+		pass = false;
+
+	for (int i = 0; i < 200; ++i)
+		grow.Delete(std::string(40, 'x'));
+
+	if (!grow.IsEmpty() || grow.BucketCount() != 0)
+		pass = false;
+
+	cout << "Bucket random test ";
+
+	return pass;
+}
+
+bool test_bucket_edges()
+{
+	bool pass = true;
+
+	//a bucket of 8 holds 8 items, the 9th one going into the middle splits it in half
+	BucketAVLTree<int, 8> split;
+	for (int i = 0; i < 16; i += 2)
+		split.Insert(i);
+
+	if (split.BucketCount() != 1 || split.Size() != 8)
+		pass = false;
+
+	split.Insert(5);
+	if (split.BucketCount() != 2 || !split.IsBalanced() ||
+		ItemsOf<int>(split) != std::vector<int>({ 0, 2, 4, 5, 6, 8, 10, 12, 14 }))
+		pass = false;
+
+	//the upper half is a leaf now. Drained to MIN_FILL (2) it stays, below it the bucket above absorbs it
+	split.Delete(8);
+	split.Delete(10);
+	if (split.BucketCount() != 2)
+		pass = false;
+
+	split.Delete(12);
+	if (split.BucketCount() != 1 || !split.IsBalanced() || ItemsOf<int>(split) != std::vector<int>({ 0, 2, 4, 5, 6, 14 }))
+		pass = false;
+
+	//ascending inserts give a full bucket with a full leaf on each side
+	BucketAVLTree<int, 8> merge;
+	for (int i = 0; i < 24; ++i)
+		merge.Insert(i);
+
+	if (merge.BucketCount() != 3)
+		pass = false;
+
+	//the right leaf keeps MIN_FILL items, which is not few enough to be absorbed
+	for (int i = 16; i < 22; ++i)
+		merge.Delete(i);
+
+	//the middle bucket drains to MIN_FILL and keeps its neighbours
+	for (int i = 8; i < 14; ++i)
+		merge.Delete(i);
+
+	if (merge.BucketCount() != 3 || !merge.IsBalanced())
+		pass = false;
+
+	//below MIN_FILL it merges with the neighbour it fits with, the full left leaf is too big
+	merge.Delete(14);
+	if (merge.BucketCount() != 2 || !merge.IsBalanced() || merge.Size() != 11 ||
+		ItemsOf<int>(merge) != std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 15, 22, 23 }))
+		pass = false;
+
+	cout << "Bucket edges test ";
+
+	return pass;
+}
+
+bool test_small_basic()
+{
+	bool pass = true;
+
+	//the 11 item fixture fits inline, so nothing is allocated
+	SmallAVLTree<int> small;
+	for (int i = 0; i < g_num_elements; ++i)
+		small.Insert(g_test_data[i]);
+
+	if (!small.IsInline() || small.Size() != g_num_elements)
+		pass = false;
+
+	g_int = -1;
+	g_testVal = true;
+	small.InOrder(CheckInOrder);
+	if (!g_testVal)
+		pass = false;
+
+	if (!small.Contains(7) || small.Contains(12) || *small.Find(3) != 3 || *small.Floor(0 + 12) != 11 ||
+		small.Floor(0) != nullptr || *small.Ceiling(-5) != 1 || small.Ceiling(12) != nullptr)
+		pass = false;
+
+	//past the limit every item moves into nodes, and back once half of them are gone
+	for (int i = 12; i <= 20; ++i)
+		small.Insert(i);
+
+	if (small.IsInline() || small.Size() != 20 || !small.Contains(1) || !small.Contains(20))
+		pass = false;
+
+	g_int = -1;
+	small.InOrder(CheckInOrder);
+	if (!g_testVal)
+		pass = false;
+
+	for (int i = 20; i > 8; --i)
+		small.Delete(i);
+
+	if (!small.IsInline() || small.Size() != 8 || small.Contains(9) || !small.Contains(8) || *small.Floor(15) != 8)
+		pass = false;
+
+	try
+	{
+		small.Delete(15);
+		pass = false;
+	}
+	catch (Exception)
+	{
+	}
+
+	small.Purge();
+	if (!small.IsEmpty() || !small.IsInline())
+		pass = false;
+
+	cout << "Small basic test ";
+
+	return pass;
+}
+
+bool test_small_hysteresis()
+{
+	bool pass = true;
+
+	//strings have destructors, so shifting the array and converting both ways have to run them right
+	SmallAVLTree<std::string, 8> small;
+	std::vector<std::string> expected;
+	auto matches = [&]()
+	{
+		std::vector<std::string> seen;
+		small.InOrder([&](std::string& item) { seen.push_back(item); });
+		return seen == expected && small.Size() == static_cast<int>(expected.size());
+	};
+	auto insert = [&](int key)
+	{
+		std::string item = "key" + std::to_string(key);
+		small.Insert(item);
+		expected.insert(std::upper_bound(expected.begin(), expected.end(), item), item);
+	};
+	auto remove = [&](int key)
+	{
+		std::string item = "key" + std::to_string(key);
+		small.Delete(item);
+		expected.erase(std::lower_bound(expected.begin(), expected.end(), item));
+	};
+
+	//InlineSize items stay inline, the next one moves every item into nodes
+	for (int i = 0; i < 8; ++i)
+		insert(i * 2);
+
+	if (!small.IsInline() || !matches())
+		pass = false;
+
+	insert(7);
+	if (small.IsInline() || !matches())
+		pass = false;
+
+	//hovering around InlineSize does not convert back, only shrinking to InlineSize / 2 does
+	for (int round = 0; round < 50; ++round)
+	{
+		remove(7);
+		insert(7);
+		if (small.IsInline())
+			pass = false;
+	}
+
+	remove(0);
+	remove(2);
+	remove(4);
+	remove(6);
+	if (small.IsInline() || small.Size() != 5 || !matches())
+		pass = false;
+
+	remove(8);
+	if (!small.IsInline() || small.Size() != 4 || !matches())
+		pass = false;
+
+	//inline again, growing back to InlineSize stays inline and one more converts again
+	for (int i = 0; i < 4; ++i)
+	{
+		insert(i * 2 + 1);
+		if (!small.IsInline())
+			pass = false;
+	}
+
+	if (!matches())
+		pass = false;
+
+	insert(3); //an equal item is kept, like AVLTree
+	if (small.IsInline() || small.Size() != 9 || !matches())
+		pass = false;
+
+	//copies and moves keep the items whichever way they are stored
+	SmallAVLTree<std::string, 8> treeCopy(small);
+	remove(3);
+	remove(7);
+	remove(12);
+	remove(14);
+	remove(10);
+	SmallAVLTree<std::string, 8> inlineCopy(small);
+	SmallAVLTree<std::string, 8> moved(std::move(treeCopy));
+
+	if (!small.IsInline() || !inlineCopy.IsInline() || !matches() || !treeCopy.IsEmpty() ||
+		moved.IsInline() || moved.Size() != 9 || !moved.Contains("key14"))
+		pass = false;
+
+	inlineCopy = std::move(moved);
+	if (inlineCopy.IsInline() || inlineCopy.Size() != 9 || !moved.IsEmpty())
+		pass = false;
+
+	//an item from the array itself, inserted while the array converts
+	SmallAVLTree<std::string, 8> grow;
+	if (!InsertsOwnItem(grow, 20) || grow.IsInline())
+		pass = false;
+
+	cout << "Small hysteresis test ";
+
+	return pass;
+}
+
+bool test_fixed_inline()
+{
+	bool pass = true;
+
+	//room for the fixture and nothing more
+	FixedAVLTree<int, 11> fixed;
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		if (!fixed.Insert(g_test_data[i]))
+			pass = false;
+	}
+
+	if (!fixed.IsFull() || fixed.Size() != g_num_elements || !fixed.IsBalanced())
+		pass = false;
+
+	//a full tree turns the insert down and stays as it was
+	if (fixed.Insert(12) || fixed.Emplace(12) || fixed.Contains(12) || fixed.Size() != g_num_elements)
+		pass = false;
+
+	g_int = -1;
+	g_testVal = true;
+	fixed.InOrder(CheckInOrder);
+	if (!g_testVal)
+		pass = false;
+
+	if (!fixed.Contains(7) || *fixed.Find(3) != 3 || *fixed.Floor(0 + 12) != 11 ||
+		fixed.Floor(0) != nullptr || *fixed.Ceiling(-5) != 1 || fixed.Ceiling(12) != nullptr)
+		pass = false;
+
+	//a missing item is not an error either
+	if (fixed.Delete(12) || !fixed.Delete(7) || fixed.Contains(7) || fixed.Delete(7) ||
+		fixed.Size() != g_num_elements - 1 || !fixed.IsBalanced())
+		pass = false;
+
+	//the freed slot takes the next insert
+	if (!fixed.Insert(12) || !fixed.IsFull() || !fixed.Contains(12) || fixed.Insert(13))
+		pass = false;
+
+	fixed.Purge();
+	if (!fixed.IsEmpty() || fixed.Capacity() != 11 || !fixed.Insert(1))
+		pass = false;
+
+	cout << "Fixed inline test ";
+
+	return pass;
+}
+
+bool test_fixed_buffer()
+{
+	bool pass = true;
+
+	//the caller's buffer holds every node, a plain AVLTree checks the contents
+	const int capacity = 64;
+	FixedAVLTree<std::string>::NodeStorage buffer[capacity];
+	FixedAVLTree<std::string> fixed(buffer, capacity);
+	AVLTree<std::string> tree;
+
+	//an insert is only turned down when the tree is full
+	if (!MatchesAVLTree(tree, 4000, 200,
+		[&](const std::string& key) { return fixed.Insert(key); },
+		[&](const std::string& key) { return fixed.Delete(key); },
+		[&]() { return fixed.IsBalanced() && fixed.Size() == tree.Size() && fixed.IsFull() == (tree.Size() == capacity); },
+		[&]() { return ItemsOf<std::string>(fixed); }))
+		pass = false;
+
+	if (!tree.IsEmpty() && fixed.Height() != tree.Height())
+		pass = false;
+
+	//every node is inside the buffer
+	const char* first = reinterpret_cast<const char*>(buffer);
+	fixed.InOrder([&](std::string& item)
+	{
+		const char* at = reinterpret_cast<const char*>(&item);
+		if (at < first || at >= first + sizeof(buffer))
+			pass = false;
+	});
+
+	cout << "Fixed buffer test ";
+
+	return pass;
+}
+
+bool test_join_reused_arena()
+{
+	bool pass = true;
+
+	//the right tree's arena has a long free list and a part used chunk when it is joined
+	AVLTree<int> left;
+	AVLTree<int> right;
+
+	for (int i = 0; i < 100; ++i)
+		left.Insert(i);
+	for (int i = 200; i < 2200; ++i)
+		right.Insert(i);
+	for (int i = 210; i < 2200; ++i)
+		right.Delete(i);
+
+	left.Join(150, right);
+
+	if (left.Size() != 111 || !right.IsEmpty() || !left.IsBalanced())
+		pass = false;
+
+	//new nodes come out of the adopted free blocks and ranges without clobbering the old ones
+	for (int i = 3000; i < 9000; ++i)
+		left.Insert(i);
+	right.Insert(1);
+
+	int count = 0;
+	g_int = -1;
+	g_testVal = true;
+	left.InOrder([&](int& item) { CheckInOrder(item); ++count; });
+
+	if (!g_testVal || count != 6111 || !left.Contains(209) || !left.Contains(150) || right.Size() != 1)
+		pass = false;
+
+	cout << "Join reused arena test ";
+
+	return pass;
+}
+
+//HeapAllocator that counts the nodes it hands out, so a test can see what a copy costs
+template <typename Node>
+class CountingAllocator : public HeapAllocator<Node>
+{
+public:
+	void* Allocate()
+	{
+		++s_allocated;
+		return HeapAllocator<Node>::Allocate();
+	}
+
+	static int s_allocated;
+};
+
+template <typename Node>
+int CountingAllocator<Node>::s_allocated = 0;
+
+bool test_copy_on_write()
+{
+	typedef AVLTree<int, CountingAllocator, AVL_COPY_ON_WRITE> SharedTree;
+	typedef CountingAllocator<AVLTreeNode<int, AVL_COPY_ON_WRITE>> Counter;
+
+	bool pass = true;
+
+	SharedTree tree;
+	for (int i = 0; i < g_num_elements; ++i)
+		tree.Insert(g_test_data[i]);
+
+	//copies share every node
+	int before = Counter::s_allocated;
+	SharedTree copy(tree);
+	SharedTree assigned;
+	assigned = tree;
+
+	if (Counter::s_allocated != before || copy.Size() != g_num_elements || assigned.Height() != g_height)
+		pass = false;
+
+	//a write copies the shared nodes on its path and nothing else
+	copy.Insert(12);
+	if (Counter::s_allocated - before > copy.Height() + 1)
+		pass = false;
+
+	copy.Delete(8);
+	copy.Delete(1);
+
+	if (!copy.Contains(12) || copy.Contains(8) || copy.Contains(1) || !copy.IsBalanced())
+		pass = false;
+
+	//traversals hand out T&, changing items through them leaves the other trees alone
+	assigned.InOrder([](int& item) { item *= 10; });
+
+	for (int i = 0; i < g_num_elements; ++i)
+	{
+		if (!tree.Contains(g_test_data[i]) || !assigned.Contains(g_test_data[i] * 10))
+			pass = false;
+	}
+
+	if (tree.Contains(12) || tree.Size() != g_num_elements || !tree.IsBalanced())
+		pass = false;
+
+	//const traversals only read, so a copy walked through them keeps sharing every node
+	{
+		const SharedTree reader(tree);
+		int count = 0;
+		before = Counter::s_allocated;
+
+		g_int = -1;
+		g_testVal = true;
+		reader.PreOrder([&](const int&) { ++count; });
+		reader.PostOrder([&](const int&) { ++count; });
+		reader.BreadthFirst([&](const int&) { ++count; });
+		reader.InOrder([](const int& item) { int copy = item; CheckInOrder(copy); });
+
+		if (Counter::s_allocated != before || count != 3 * g_num_elements || !g_testVal)
+			pass = false;
+	}
+
+	//the tree that built the nodes can go first
+	{
+		SharedTree temp(copy);
+		temp.Delete(12);
+	}
+
+	tree.Purge();
+
+	g_int = -1;
+	g_testVal = true;
+	copy.InOrder(CheckInOrder);
+
+	if (!g_testVal || copy.Size() != g_num_elements - 1 || !copy.Contains(12) || !copy.Contains(11) || !tree.IsEmpty())
+		pass = false;
+
+	cout << "Copy on write test ";
+
+	return pass;
+}
+
+bool test_copy_on_write_versions()
+{
+	typedef AVLTree<int, HeapAllocator, AVL_COPY_ON_WRITE | AVL_ORDER_STATISTICS> SharedTree;
+	typedef AVLTree<int, HeapAllocator, AVL_ORDER_STATISTICS> PlainTree;
+
+	const int VERSIONS = 6;
+	const int ROUNDS = 600;
+
+	bool pass = true;
+
+	//each shared tree has a deep copied twin that gets the same writes
+	SharedTree shared[VERSIONS];
+	PlainTree plain[VERSIONS];
+
+	for (int round = 0; round < ROUNDS && pass; ++round)
+	{
+		int v = Random::GetRand(VERSIONS - 1);
+		int w = Random::GetRand(VERSIONS - 1);
+		int key = Random::GetRand(300);
+
+		switch (Random::GetRand(5))
+		{
+		case 0:
+		case 1:
+			if (!plain[v].Contains(key))
+			{
+				shared[v].Insert(key);
+				plain[v].Insert(key);
+			}
+			break;
+		case 2:
+			if (!plain[v].IsEmpty())
+			{
+				key = plain[v].Select(Random::GetRand(plain[v].Size() - 1));
+				shared[v].Delete(key);
+				plain[v].Delete(key);
+			}
+			break;
+		case 3:
+			shared[w] = shared[v];
+			plain[w] = plain[v];
+			break;
+		default:
+			if (v != w)
+			{
+				//set algebra takes other's nodes apart, here they are still shared with w
+				SharedTree other(shared[w]);
+				PlainTree otherPlain(plain[w]);
+
+				if (key % 3 == 0)
+				{
+					shared[v].Union(other);
+					plain[v].Union(otherPlain);
+				}
+				else if (key % 3 == 1)
+				{
+					shared[v].Difference(other);
+					plain[v].Difference(otherPlain);
+				}
+				else
+				{
+					shared[v].Intersection(other);
+					plain[v].Intersection(otherPlain);
+				}
+			}
+			break;
+		}
+
+		for (int i = 0; i < VERSIONS; ++i)
+		{
+			if (shared[i].Size() != plain[i].Size() || !shared[i].IsBalanced() ||
+				!std::equal(shared[i].begin(), shared[i].end(), plain[i].begin()) ||
+				(!shared[i].IsEmpty() && shared[i].Select(shared[i].Size() / 2) != plain[i].Select(plain[i].Size() / 2)))
+				pass = false;
+		}
+	}
+
+	cout << "Copy on write versions test ";
+
+	return pass;
+}
@@ -0,0 +1,249 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: FixedAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - Built on AVLTree and FixedAllocator instead of its own copy of the rebalancing code
+*		- 10/17/2026 - Delete finds and removes the item in one walk with AVLTree::TryDelete
+**************************************************************/
+
+#pragma once
+
+#include <utility>
+#include "AVLTree.h"
+#include "Exception.h"
+#include "FixedAllocator.h"
+
+/************************************************************************
+* Class: FixedAVLTree
+*
+* Purpose: This class is an AVLTree whose nodes live in storage fixed at
+*		construction, either N slots inside the object or a buffer the
+*		caller hands in, so Insert and Delete never allocate or free
+*		memory and take the same time whatever the heap is doing.
+*		It is an AVLTree<T, FixedAllocator> underneath: the FixedAllocator
+*		hands out the slots and keeps a deleted node's slot for the next
+*		insert. Running out of slots is an expected result rather than an
+*		error, so Insert returns false instead of throwing, and so does
+*		Delete when there is no equivalent item. Only T itself (its
+*		constructor or its comparisons) can make them throw.
+*		Equal items are kept, like AVLTree.
+*
+* Manager functions:
+* FixedAVLTree();
+*		Uses the N slots inside the object
+* FixedAVLTree(NodeStorage* storage, int capacity);
+*		Uses capacity slots of storage, which has to outlive the tree. N is normally 0 then
+* ~FixedAVLTree();
+*		Destroys every item, the storage itself is not freed
+*
+* Methods:
+* bool Insert(const T& data); / bool Insert(T&& data);
+*		Inserts data into the tree. Returns false, leaving the tree as it was, if it is full
+* template <typename... Args> bool Emplace(Args&&... args);
+*		Inserts an item constructed in place in a node from args. Returns false if the tree is full
+* bool Delete(const T& data);
+*		Deletes one equivalent item. Returns false if there is none
+* void Purge();
+*		Removes every item, every slot is free again
+* int Height() const;
+*		returns the height of the tree in O(1)
+* int Size() const;
+*		returns the number of items in the tree in O(1)
+* int Capacity() const;
+*		returns how many items the tree can hold
+*
+* Lookups:
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* const T* Find(const T& data) const;
+*		Returns a pointer to the stored equivalent data, or nullptr
+* const T* Floor(const T& data) const;
+*		Returns the largest item that is not greater than data, or nullptr
+* const T* Ceiling(const T& data) const;
+*		Returns the smallest item that is not less than data, or nullptr
+*
+* Testing:
+* bool IsEmpty() const;
+*		Returns true if the tree is empty
+* bool IsFull() const;
+*		Returns true if every slot holds an item
+* bool IsBalanced() const;
+*		Returns true if all balance factors are between -1 and 1
+*
+* Traversals:
+* template <typename Visitor> bool InOrder(Visitor visit);
+*		Calls visit with every item in order. If visit returns a bool, returning false stops
+*		the traversal. Returns false if it was stopped, true if it finished
+*
+* Types:
+* NodeStorage
+*		Storage for one node, sized and aligned for it. A caller supplied buffer is an array of these
+*
+*************************************************************************/
+template <typename T, int N = 0>
+class FixedAVLTree
+{
+public:
+	typedef typename FixedAllocator<AVLTreeNode<T>>::Slot NodeStorage;
+
+	FixedAVLTree();
+	FixedAVLTree(NodeStorage* storage, int capacity);
+	~FixedAVLTree();
+
+	//Methods
+	bool Insert(const T& data); //Inserts data into the tree, false if it is full
+	bool Insert(T&& data); //Inserts data into the tree, moving it into the node
+	template <typename... Args> bool Emplace(Args&&... args); //Inserts an item built from args
+	bool Delete(const T& data); //Deletes one equivalent item, false if there is none
+	void Purge(); //Removes every item
+	int Height() const; //returns the height of the tree
+	int Size() const; //returns the number of items in the tree
+	int Capacity() const; //returns how many items fit
+
+	//Lookups
+	bool Contains(const T& data) const;
+	const T* Find(const T& data) const;
+	const T* Floor(const T& data) const;
+	const T* Ceiling(const T& data) const;
+
+	//Testing
+	bool IsEmpty() const;
+	bool IsFull() const;
+	bool IsBalanced() const;
+
+	//Traversals
+	template <typename Visitor> bool InOrder(Visitor visit);
+
+private:
+	//nodes point into this tree's storage, so there is nothing a copy could share
+	FixedAVLTree(const FixedAVLTree<T, N>& copy);
+	FixedAVLTree<T, N>& operator=(const FixedAVLTree<T, N>& rhs);
+
+	NodeStorage m_inline[N > 0 ? N : 1]; //an array can't be empty, the one slot is unused when N is 0
+	AVLTree<T, FixedAllocator> m_tree; //declared after m_inline so its nodes are destroyed first
+	int m_capacity;
+};
+
+
+/// Function Code ///
+
+template<typename T, int N>
+inline FixedAVLTree<T, N>::FixedAVLTree() : m_capacity(N)
+{
+	m_tree.m_alloc.Assign(m_inline, N);
+}
+
+template<typename T, int N>
+inline FixedAVLTree<T, N>::FixedAVLTree(NodeStorage* storage, int capacity) : m_capacity(capacity)
+{
+	if (capacity < 0 || (storage == nullptr && capacity > 0))
+		throw Exception("Tried to build a fixed tree without storage");
+
+	m_tree.m_alloc.Assign(storage, capacity);
+}
+
+template<typename T, int N>
+inline FixedAVLTree<T, N>::~FixedAVLTree()
+{
+	//m_tree destroys the items, the slots themselves belong to this object or the caller
+}
+
+template<typename T, int N>
+inline bool FixedAVLTree<T, N>::Insert(const T & data)
+{
+	return m_tree.TryInsert(data);
+}
+
+template<typename T, int N>
+inline bool FixedAVLTree<T, N>::Insert(T && data)
+{
+	return m_tree.TryInsert(std::move(data));
+}
+
+template<typename T, int N>
+template<typename... Args>
+inline bool FixedAVLTree<T, N>::Emplace(Args&&... args)
+{
+	return m_tree.TryEmplace(std::forward<Args>(args)...);
+}
+
+template<typename T, int N>
+inline bool FixedAVLTree<T, N>::Delete(const T & data)
+{
+	return m_tree.TryDelete(data);
+}
+
+template<typename T, int N>
+inline void FixedAVLTree<T, N>::Purge()
+{
+	m_tree.Purge();
+}
+
+template<typename T, int N>
+inline int FixedAVLTree<T, N>::Height() const
+{
+	return m_tree.Height();
+}
+
+template<typename T, int N>
+inline int FixedAVLTree<T, N>::Size() const
+{
+	return m_tree.Size();
+}
+
+template<typename T, int N>
+inline int FixedAVLTree<T, N>::Capacity() const
+{
+	return m_capacity;
+}
+
+template<typename T, int N>
+inline bool FixedAVLTree<T, N>::Contains(const T & data) const
+{
+	return m_tree.Contains(data);
+}
+
+template<typename T, int N>
+inline const T* FixedAVLTree<T, N>::Find(const T & data) const
+{
+	return m_tree.Find(data);
+}
+
+template<typename T, int N>
+inline const T* FixedAVLTree<T, N>::Floor(const T & data) const
+{
+	return m_tree.Floor(data);
+}
+
+template<typename T, int N>
+inline const T* FixedAVLTree<T, N>::Ceiling(const T & data) const
+{
+	return m_tree.Ceiling(data);
+}
+
+template<typename T, int N>
+inline bool FixedAVLTree<T, N>::IsEmpty() const
+{
+	return m_tree.IsEmpty();
+}
+
+template<typename T, int N>
+inline bool FixedAVLTree<T, N>::IsFull() const
+{
+	return m_tree.Size() == m_capacity;
+}
+
+template<typename T, int N>
+inline bool FixedAVLTree<T, N>::IsBalanced() const
+{
+	return m_tree.IsBalanced();
+}
+
+template<typename T, int N>
+template<typename Visitor>
+inline bool FixedAVLTree<T, N>::InOrder(Visitor visit)
+{
+	//named explicitly so a plain function does not pick the void InOrder(void visit(T&)) overload
+	return m_tree.template InOrder<Visitor>(visit);
+}
@@ -0,0 +1,157 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: FixedAllocator.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+#include "Exception.h"
+
+/************************************************************************
+* Class: FixedAllocator
+*
+* Purpose: This class hands out storage for Node objects from slots
+*		given to it by Assign, either an array inside its owner or a
+*		buffer the caller supplies. It never asks the heap for memory.
+*		Freed slots go on a free list threaded through them and are
+*		reused by the next Allocate. Once every slot is in use Allocate
+*		returns nullptr instead of growing, which AVLTree::TryInsert
+*		turns into false (and AVLTree::Insert into an Exception).
+*		It has the same interface as ArenaAllocator otherwise.
+*
+* Manager functions:
+* FixedAllocator();
+*		Creates an allocator without any slots, Assign gives it some
+*
+* Methods:
+* void Assign(Slot* slots, int capacity);
+*		Makes the capacity slots starting at slots the storage to hand out. They have to
+*		outlive every Node built in them
+* void* Allocate();
+*		Returns storage for one Node, or nullptr if every slot is in use
+* void Deallocate(void* block);
+*		Puts a block back on the free list
+* void Reserve(int count);
+*		Does nothing, the slots are all there from the start
+* void Release();
+*		Makes every slot free again at once. Any Node still in a slot is invalid afterwards
+* void Adopt(FixedAllocator<Node>& other);
+*		Throws, the slots of other belong to other's owner and cannot change hands
+* void Swap(FixedAllocator<Node>& other);
+*		Exchanges slots and free lists with other in O(1)
+*
+* Types:
+* Slot
+*		Storage for one Node, sized and aligned for it. Assign takes an array of these
+*
+* Constants:
+* RELEASES_ALL
+*		true, Release frees every slot so the owner does not need to
+*		Deallocate nodes one by one before it
+*
+*************************************************************************/
+template <typename Node>
+class FixedAllocator
+{
+public:
+	static const bool RELEASES_ALL = true;
+
+	union Slot
+	{
+		Slot* m_next;
+		typename std::aligned_storage<sizeof(Node), alignof(Node)>::type m_storage;
+	};
+
+	FixedAllocator();
+
+	void Assign(Slot* slots, int capacity);
+	void* Allocate();
+	void Deallocate(void* block);
+	void Reserve(int count);
+	void Release();
+	void Adopt(FixedAllocator<Node>& other);
+	void Swap(FixedAllocator<Node>& other);
+
+private:
+	FixedAllocator(const FixedAllocator<Node>& copy);
+	FixedAllocator<Node>& operator=(const FixedAllocator<Node>& rhs);
+
+	Slot* m_slots;
+	Slot* m_next; //slots from here on were never handed out, so they need no free list
+	Slot* m_end;
+	Slot* m_free; //slots given back by Deallocate
+};
+
+
+/// Function Code ///
+
+template<typename Node>
+inline FixedAllocator<Node>::FixedAllocator() : m_slots(nullptr), m_next(nullptr), m_end(nullptr), m_free(nullptr)
+{
+}
+
+template<typename Node>
+inline void FixedAllocator<Node>::Assign(Slot* slots, int capacity)
+{
+	m_slots = slots;
+	m_next = slots;
+	m_end = slots + capacity;
+	m_free = nullptr;
+}
+
+template<typename Node>
+inline void* FixedAllocator<Node>::Allocate()
+{
+	if (m_free != nullptr)
+	{
+		Slot* slot = m_free;
+		m_free = slot->m_next;
+
+		return slot;
+	}
+
+	if (m_next == m_end)
+		return nullptr;
+
+	return m_next++;
+}
+
+template<typename Node>
+inline void FixedAllocator<Node>::Deallocate(void* block)
+{
+	Slot* freed = static_cast<Slot*>(block);
+	freed->m_next = m_free;
+	m_free = freed;
+}
+
+template<typename Node>
+inline void FixedAllocator<Node>::Reserve(int)
+{
+}
+
+template<typename Node>
+inline void FixedAllocator<Node>::Release()
+{
+	//Default values
+	m_next = m_slots;
+	m_free = nullptr;
+}
+
+template<typename Node>
+inline void FixedAllocator<Node>::Adopt(FixedAllocator<Node>&)
+{
+	throw Exception("Tried to move nodes between fixed allocators");
+}
+
+template<typename Node>
+inline void FixedAllocator<Node>::Swap(FixedAllocator<Node>& other)
+{
+	std::swap(m_slots, other.m_slots);
+	std::swap(m_next, other.m_next);
+	std::swap(m_end, other.m_end);
+	std::swap(m_free, other.m_free);
+}
@@ -0,0 +1,388 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: FrozenAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+using std::max;
+using std::min;
+#include "AVLTreeNode.h"
+#include "Exception.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#define AVL_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define AVL_PREFETCH(address) ((void)(address))
+#endif
+
+enum FROZEN_LAYOUT : int
+{
+	FROZEN_EYTZINGER, //breadth first: the children of slot k are 2k and 2k + 1
+	FROZEN_VEB //van Emde Boas: every subtree of about half the height is one contiguous run
+};
+
+/************************************************************************
+* Class: FrozenAVLTree
+*
+* Purpose: This class is a read only copy of a sorted set of items (made
+*		by AVLTree::Freeze) laid out as a perfectly balanced search tree
+*		in one array, without pointers. A search reads one array slot per
+*		level and chooses the next slot with arithmetic, so the only branch
+*		is the loop itself and the CPU never waits on a mispredicted turn.
+*		FROZEN_EYTZINGER stores the levels one after another. The
+*		descendants four levels down from a slot are next to each other,
+*		so the search prefetches them while it compares. FROZEN_VEB
+*		stores the top half of the tree's height as one block, followed
+*		by each bottom half subtree, recursively. A search touches about
+*		log(n) / log(cache line) blocks on every level of the memory
+*		hierarchy without knowing the line size.
+*		Items are copied once. Equal items in the source are kept, and a
+*		search finds the first of them.
+*
+* Manager functions:
+* FrozenAVLTree();
+*		Makes an empty tree
+* template <typename ForwardIt> FrozenAVLTree(ForwardIt first, ForwardIt last, FROZEN_LAYOUT layout = FROZEN_EYTZINGER);
+*		Copies a sorted range into the given layout in O(n), throws if the range is not sorted
+*
+* Methods:
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* const T* Find(const T& data) const;
+*		Returns the stored equivalent data, or nullptr
+* const T* LowerBound(const T& data) const;
+*		Returns the smallest item that is not less than data, or nullptr
+* int Size() const;
+*		returns the number of items
+* bool IsEmpty() const;
+*		Returns true if there are no items
+* FROZEN_LAYOUT Layout() const;
+*		Returns the layout the items are stored in
+* template <typename Visitor> bool InOrder(Visitor visit) const;
+*		Calls visit with every item in order. If visit returns a bool, returning false stops
+*		the traversal. Returns false if it was stopped, true if it finished
+*
+* --- HELPER FUNCTIONS ---
+* template <typename ForwardIt> void FillEytzinger(int slot, ForwardIt& current);
+*		Copies the next items into the subtree at slot, in order
+* void PlanVeb(int topDepth, int height);
+*		Fills m_top, m_bottom and m_topDepth for the subtree of height height at topDepth
+* template <typename ForwardIt> void FillVeb(int node, int depth, int* position, ForwardIt& current);
+*		Copies the next items into the subtree of breadth first index node, in order
+* int VebPosition(int node, int depth, const int* position) const;
+*		Returns where the node of breadth first index node at depth sits, given its ancestors' positions
+* int LowerBoundSlot(const T& data) const;
+*		Returns the array slot of the first item not less than data, or -1
+* int SlotOf(int node) const;
+*		Returns the array slot of breadth first index node, for InOrder
+* template <typename Visitor> static bool Visit(Visitor& visit, const T& data);
+*		Calls visit and turns its result into "keep going"
+*
+*************************************************************************/
+template <typename T>
+class FrozenAVLTree
+{
+public:
+	FrozenAVLTree();
+	template <typename ForwardIt> FrozenAVLTree(ForwardIt first, ForwardIt last, FROZEN_LAYOUT layout = FROZEN_EYTZINGER);
+
+	//Lookups
+	bool Contains(const T& data) const;
+	const T* Find(const T& data) const;
+	const T* LowerBound(const T& data) const;
+	int Size() const;
+	bool IsEmpty() const;
+	FROZEN_LAYOUT Layout() const;
+
+	//Traversals
+	template <typename Visitor> bool InOrder(Visitor visit) const;
+
+private:
+	enum PREFETCH : int { PREFETCH_LEVELS = 4 }; //the 16 slots four levels down are one run
+
+	template <typename ForwardIt> void FillEytzinger(int slot, ForwardIt& current);
+	void PlanVeb(int topDepth, int height);
+	template <typename ForwardIt> void FillVeb(int node, int depth, int* position, ForwardIt& current);
+	int VebPosition(int node, int depth, const int* position) const;
+	int LowerBoundSlot(const T& data) const;
+	int SlotOf(int node) const;
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data);
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data, std::true_type);
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data, std::false_type);
+
+	FROZEN_LAYOUT m_layout;
+	int m_numElements;
+	int m_height;
+	std::vector<T> m_items; //slot 0 is unused by FROZEN_EYTZINGER, FROZEN_VEB has unused slots past a full last level
+
+	//FROZEN_VEB: for the nodes at depth d, the size of the top tree above their bottom tree,
+	//the size of that bottom tree and the depth of the top tree's root
+	int m_top[AVL_MAX_HEIGHT];
+	int m_bottom[AVL_MAX_HEIGHT];
+	int m_topDepth[AVL_MAX_HEIGHT];
+};
+
+
+/// Function Code ///
+
+template<typename T>
+inline FrozenAVLTree<T>::FrozenAVLTree() : m_layout(FROZEN_EYTZINGER), m_numElements(0), m_height(0)
+{
+}
+
+template<typename T>
+template<typename ForwardIt>
+inline FrozenAVLTree<T>::FrozenAVLTree(ForwardIt first, ForwardIt last, FROZEN_LAYOUT layout) : m_layout(layout), m_numElements(0), m_height(0)
+{
+	for (ForwardIt current = first; current != last; ++current)
+	{
+		ForwardIt next = current;
+		if (++next != last && *next < *current)
+			throw Exception("Tried to freeze an unsorted range");
+
+		++m_numElements;
+	}
+
+	if (m_numElements == 0)
+		return;
+
+	//the smallest complete tree that holds every item
+	while ((1 << m_height) - 1 < m_numElements)
+		++m_height;
+
+	//the slots no search reaches hold copies of the first item, so every slot is a real T
+	ForwardIt current = first;
+
+	if (m_layout == FROZEN_EYTZINGER)
+	{
+		m_items.assign(m_numElements + 1, *first);
+		FillEytzinger(1, current);
+	}
+	else
+	{
+		m_items.assign((1 << m_height) - 1, *first);
+
+		m_top[0] = 0;
+		m_bottom[0] = 0;
+		m_topDepth[0] = 0;
+		PlanVeb(0, m_height);
+
+		int position[AVL_MAX_HEIGHT];
+		FillVeb(1, 0, position, current);
+	}
+}
+
+template<typename T>
+inline bool FrozenAVLTree<T>::Contains(const T & data) const
+{
+	return Find(data) != nullptr;
+}
+
+template<typename T>
+inline const T* FrozenAVLTree<T>::Find(const T & data) const
+{
+	const T* found = LowerBound(data);
+
+	return (found != nullptr && !(data < *found)) ? found : nullptr;
+}
+
+template<typename T>
+inline const T* FrozenAVLTree<T>::LowerBound(const T & data) const
+{
+	int slot = LowerBoundSlot(data);
+
+	return slot != -1 ? &m_items[slot] : nullptr;
+}
+
+template<typename T>
+inline int FrozenAVLTree<T>::Size() const
+{
+	return m_numElements;
+}
+
+template<typename T>
+inline bool FrozenAVLTree<T>::IsEmpty() const
+{
+	return m_numElements == 0;
+}
+
+template<typename T>
+inline FROZEN_LAYOUT FrozenAVLTree<T>::Layout() const
+{
+	return m_layout;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool FrozenAVLTree<T>::InOrder(Visitor visit) const
+{
+	//the breadth first indices of the implicit tree, walked like the pointer trees
+	int path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	int current = 1;
+
+	while (current <= m_numElements || depth > 0)
+	{
+		while (current <= m_numElements)
+		{
+			path[depth++] = current;
+			current *= 2;
+		}
+
+		current = path[--depth];
+		if (!Visit(visit, m_items[SlotOf(current)]))
+			return false;
+
+		current = current * 2 + 1;
+	}
+
+	return true;
+}
+
+template<typename T>
+template<typename ForwardIt>
+inline void FrozenAVLTree<T>::FillEytzinger(int slot, ForwardIt& current)
+{
+	if (slot > m_numElements)
+		return;
+
+	FillEytzinger(slot * 2, current);
+	m_items[slot] = *current;
+	++current;
+	FillEytzinger(slot * 2 + 1, current);
+}
+
+template<typename T>
+inline void FrozenAVLTree<T>::PlanVeb(int topDepth, int height)
+{
+	if (height <= 1)
+		return;
+
+	//cut the height in half, the bottom trees hang below the top tree's leaves
+	int topHeight = height / 2;
+	int bottomHeight = height - topHeight;
+	int depth = topDepth + topHeight;
+
+	m_top[depth] = (1 << topHeight) - 1;
+	m_bottom[depth] = (1 << bottomHeight) - 1;
+	m_topDepth[depth] = topDepth;
+
+	PlanVeb(topDepth, topHeight);
+	PlanVeb(depth, bottomHeight);
+}
+
+template<typename T>
+template<typename ForwardIt>
+inline void FrozenAVLTree<T>::FillVeb(int node, int depth, int* position, ForwardIt& current)
+{
+	if (node > m_numElements)
+		return;
+
+	position[depth] = VebPosition(node, depth, position);
+
+	FillVeb(node * 2, depth + 1, position, current);
+	m_items[position[depth]] = *current;
+	++current;
+	FillVeb(node * 2 + 1, depth + 1, position, current);
+}
+
+template<typename T>
+inline int FrozenAVLTree<T>::VebPosition(int node, int depth, const int* position) const
+{
+	if (depth == 0)
+		return 0;
+
+	//skip the top tree, then the bottom trees to the left of this one (the low bits of node pick it)
+	return position[m_topDepth[depth]] + m_top[depth] + (node & m_top[depth]) * m_bottom[depth];
+}
+
+template<typename T>
+inline int FrozenAVLTree<T>::LowerBoundSlot(const T & data) const
+{
+	const T* items = m_items.data();
+	const int count = m_numElements;
+	int node = 1;
+
+	if (m_layout == FROZEN_EYTZINGER)
+	{
+		//the last slot is a safe prefetch target when the descendants are past the end
+		const int lastSlot = count;
+
+		while (node <= count)
+		{
+			AVL_PREFETCH(items + min(node << PREFETCH_LEVELS, lastSlot));
+			node = node * 2 + (items[node] < data);
+		}
+
+		//undo the right turns taken since the last left turn, that left turn was at the answer
+		while (node & 1)
+			node >>= 1;
+		node >>= 1;
+
+		return node != 0 ? node : -1;
+	}
+
+	int position[AVL_MAX_HEIGHT];
+	int depth = 0;
+	int best = -1;
+
+	while (node <= count)
+	{
+		position[depth] = VebPosition(node, depth, position);
+
+		bool right = items[position[depth]] < data;
+		best = right ? best : position[depth];
+		node = node * 2 + right;
+		++depth;
+	}
+
+	return best;
+}
+
+template<typename T>
+inline int FrozenAVLTree<T>::SlotOf(int node) const
+{
+	if (m_layout == FROZEN_EYTZINGER)
+		return node;
+
+	//rebuild the ancestors' positions from the root down
+	int depth = 0;
+	while ((node >> (depth + 1)) != 0)
+		++depth;
+
+	int position[AVL_MAX_HEIGHT];
+	for (int level = 0; level <= depth; ++level)
+		position[level] = VebPosition(node >> (depth - level), level, position);
+
+	return position[depth];
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool FrozenAVLTree<T>::Visit(Visitor& visit, const T& data)
+{
+	return Visit(visit, data, std::is_void<decltype(visit(data))>());
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool FrozenAVLTree<T>::Visit(Visitor& visit, const T& data, std::true_type)
+{
+	visit(data);
+	return true;
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool FrozenAVLTree<T>::Visit(Visitor& visit, const T& data, std::false_type)
+{
+	return static_cast<bool>(visit(data));
+}
@@ -0,0 +1,282 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: FrozenBlockTree.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "Exception.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AVL_SIMD_AVX2
+#endif
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define AVL_SIMD_SSE2
+#endif
+
+/************************************************************************
+* Class: FrozenBlockTree
+*
+* Purpose: This class is a read only search tree for integral keys,
+*		built once from a sorted range such as the in-order contents of
+*		an AVLTree. Keys are stored BlockKeys to a block (16 keys of 32
+*		bits fill one cache line), and the blocks form an implicit B-tree
+*		in one array: block k has children k * (BlockKeys + 1) + 1 to
+*		k * (BlockKeys + 1) + BlockKeys + 1. A search reads one block per
+*		level and compares the key against the whole block at once, so it
+*		takes log(n) / log(BlockKeys + 1) cache misses instead of log(n).
+*		For 32 bit keys the block is compared with SSE2 (or AVX2 when the
+*		compiler targets it), adding up the compare masks to get how many
+*		keys are less. Other key sizes, and builds without SSE2, use a
+*		scalar loop with no branches that the compiler can vectorize.
+*		The last block is padded with the largest value of T, the search
+*		tells padding from a real key by the real largest key.
+*
+* Manager functions:
+* FrozenBlockTree();
+*		Makes an empty tree
+* template <typename ForwardIt> FrozenBlockTree(ForwardIt first, ForwardIt last);
+*		Copies a sorted range in O(n), throws if it is not sorted
+*
+* Methods:
+* bool Contains(T key) const;
+*		Returns true if key is in the tree
+* const T* Find(T key) const;
+*		Returns the stored key, or nullptr
+* const T* LowerBound(T key) const;
+*		Returns the smallest key that is not less than key, or nullptr
+* int Size() const;
+*		returns the number of keys
+* bool IsEmpty() const;
+*		Returns true if there are no keys
+*
+* --- HELPER FUNCTIONS ---
+* template <typename ForwardIt> void Fill(int block, ForwardIt& current, int& remaining);
+*		Copies the next keys into the subtree of block, in order, padding once they run out
+* const T* Blocks() const;
+*		Returns the first block, aligned to a cache line
+* static int CountLess(const T* block, T key);
+*		Returns how many keys of a block are less than key, picking the SIMD version if it applies
+*
+*************************************************************************/
+template <typename T, int BlockKeys = 16>
+class FrozenBlockTree
+{
+public:
+	FrozenBlockTree();
+	template <typename ForwardIt> FrozenBlockTree(ForwardIt first, ForwardIt last);
+
+	//Lookups
+	bool Contains(T key) const;
+	const T* Find(T key) const;
+	const T* LowerBound(T key) const;
+	int Size() const;
+	bool IsEmpty() const;
+
+private:
+	static_assert(std::is_integral<T>::value, "FrozenBlockTree compares keys as integers, T has to be integral");
+	static_assert(BlockKeys % 16 == 0, "BlockKeys has to be a multiple of 16 (16 and 64 are the usual sizes)");
+
+	enum ALIGNMENT : int { CACHE_LINE = 64 };
+
+	template <typename ForwardIt> void Fill(int block, ForwardIt& current, int& remaining);
+	const T* Blocks() const;
+	static int CountLess(const T* block, T key);
+	static int CountLess(const T* block, T key, std::true_type);
+	static int CountLess(const T* block, T key, std::false_type);
+
+	int m_numElements;
+	int m_numBlocks;
+	T m_largest; //the largest real key, padding is never larger
+	std::vector<T> m_storage; //the blocks, plus room to start them on a cache line
+	int m_offset; //where the first block starts in m_storage
+};
+
+
+/// Function Code ///
+
+template<typename T, int BlockKeys>
+inline FrozenBlockTree<T, BlockKeys>::FrozenBlockTree() : m_numElements(0), m_numBlocks(0), m_largest(0), m_offset(0)
+{
+}
+
+template<typename T, int BlockKeys>
+template<typename ForwardIt>
+inline FrozenBlockTree<T, BlockKeys>::FrozenBlockTree(ForwardIt first, ForwardIt last) : m_numElements(0), m_numBlocks(0), m_largest(0), m_offset(0)
+{
+	for (ForwardIt current = first; current != last; ++current)
+	{
+		ForwardIt next = current;
+		if (++next != last && *next < *current)
+			throw Exception("Tried to freeze an unsorted range");
+
+		m_largest = *current;
+		++m_numElements;
+	}
+
+	m_numBlocks = (m_numElements + BlockKeys - 1) / BlockKeys;
+
+	const int slack = CACHE_LINE / static_cast<int>(sizeof(T));
+	m_storage.assign(static_cast<size_t>(m_numBlocks) * BlockKeys + slack, std::numeric_limits<T>::max());
+
+	//position in the vector is fixed from here on, so the offset stays valid in copies
+	//(they may lose the alignment, but never the contents)
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_storage.data());
+	m_offset = static_cast<int>(((CACHE_LINE - address % CACHE_LINE) % CACHE_LINE) / sizeof(T));
+
+	ForwardIt current = first;
+	int remaining = m_numElements;
+	Fill(0, current, remaining);
+}
+
+template<typename T, int BlockKeys>
+inline bool FrozenBlockTree<T, BlockKeys>::Contains(T key) const
+{
+	return Find(key) != nullptr;
+}
+
+template<typename T, int BlockKeys>
+inline const T* FrozenBlockTree<T, BlockKeys>::Find(T key) const
+{
+	const T* found = LowerBound(key);
+
+	return (found != nullptr && *found == key) ? found : nullptr;
+}
+
+template<typename T, int BlockKeys>
+inline const T* FrozenBlockTree<T, BlockKeys>::LowerBound(T key) const
+{
+	//past the largest key only padding is left
+	if (m_numElements == 0 || m_largest < key)
+		return nullptr;
+
+	const T* blocks = Blocks();
+	int answer = -1;
+	int block = 0;
+
+	while (block < m_numBlocks)
+	{
+		int less = CountLess(blocks + static_cast<size_t>(block) * BlockKeys, key);
+
+		//the first key not less than key in this block is the best answer so far
+		answer = (less < BlockKeys) ? block * BlockKeys + less : answer;
+		block = block * (BlockKeys + 1) + less + 1;
+	}
+
+	//key <= m_largest, so a real key answers. A padding slot only wins a tie with the largest value
+	return (blocks[answer] == m_largest) ? &m_largest : blocks + answer;
+}
+
+template<typename T, int BlockKeys>
+inline int FrozenBlockTree<T, BlockKeys>::Size() const
+{
+	return m_numElements;
+}
+
+template<typename T, int BlockKeys>
+inline bool FrozenBlockTree<T, BlockKeys>::IsEmpty() const
+{
+	return m_numElements == 0;
+}
+
+template<typename T, int BlockKeys>
+template<typename ForwardIt>
+inline void FrozenBlockTree<T, BlockKeys>::Fill(int block, ForwardIt& current, int& remaining)
+{
+	if (block >= m_numBlocks)
+		return;
+
+	T* keys = m_storage.data() + m_offset + static_cast<size_t>(block) * BlockKeys;
+
+	for (int i = 0; i < BlockKeys; ++i)
+	{
+		Fill(block * (BlockKeys + 1) + i + 1, current, remaining);
+
+		//the slots left once the keys ran out keep the padding m_storage was filled with
+		if (remaining > 0)
+		{
+			keys[i] = *current;
+			++current;
+			--remaining;
+		}
+	}
+
+	Fill(block * (BlockKeys + 1) + BlockKeys + 1, current, remaining);
+}
+
+template<typename T, int BlockKeys>
+inline const T* FrozenBlockTree<T, BlockKeys>::Blocks() const
+{
+	return m_storage.data() + m_offset;
+}
+
+template<typename T, int BlockKeys>
+inline int FrozenBlockTree<T, BlockKeys>::CountLess(const T* block, T key)
+{
+#if defined(AVL_SIMD_SSE2)
+	return CountLess(block, key, std::integral_constant<bool, sizeof(T) == 4>());
+#else
+	return CountLess(block, key, std::false_type());
+#endif
+}
+
+template<typename T, int BlockKeys>
+inline int FrozenBlockTree<T, BlockKeys>::CountLess(const T* block, T key, std::true_type)
+{
+#if defined(AVL_SIMD_SSE2)
+	//the compares are signed, flipping the sign bit orders unsigned keys the same way
+	const std::int32_t flip = std::is_signed<T>::value ? 0 : INT32_MIN;
+	const std::int32_t biased = static_cast<std::int32_t>(static_cast<std::uint32_t>(key) ^ static_cast<std::uint32_t>(flip));
+
+#if defined(AVL_SIMD_AVX2)
+	const __m256i wanted = _mm256_set1_epi32(biased);
+	const __m256i sign = _mm256_set1_epi32(flip);
+	__m256i total = _mm256_setzero_si256();
+
+	for (int i = 0; i < BlockKeys; i += 8)
+	{
+		__m256i keys = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i)), sign);
+		total = _mm256_add_epi32(total, _mm256_cmpgt_epi32(wanted, keys)); //-1 in every lane holding a smaller key
+	}
+
+	__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+#else
+	const __m128i wanted = _mm_set1_epi32(biased);
+	const __m128i sign = _mm_set1_epi32(flip);
+	__m128i sum = _mm_setzero_si128();
+
+	for (int i = 0; i < BlockKeys; i += 4)
+	{
+		__m128i keys = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i)), sign);
+		sum = _mm_add_epi32(sum, _mm_cmpgt_epi32(wanted, keys)); //-1 in every lane holding a smaller key
+	}
+#endif
+
+	//add the four lanes together, each is minus the count of its lane
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	return -_mm_cvtsi128_si32(sum);
+#else
+	return CountLess(block, key, std::false_type());
+#endif
+}
+
+template<typename T, int BlockKeys>
+inline int FrozenBlockTree<T, BlockKeys>::CountLess(const T* block, T key, std::false_type)
+{
+	//no branch per key, compilers turn this into vector compares on their own
+	int less = 0;
+	for (int i = 0; i < BlockKeys; ++i)
+		less += (block[i] < key) ? 1 : 0;
+
+	return less;
+}
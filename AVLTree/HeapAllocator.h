@@ -0,0 +1,88 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: HeapAllocator.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - Added Reserve for bulk builds
+*		- 10/17/2026 - Added Adopt so trees can take over each other's nodes
+*		- 10/17/2026 - Added Swap so moving a tree hands its allocator over whole
+**************************************************************/
+
+#pragma once
+
+#include <new>
+
+/************************************************************************
+* Class: HeapAllocator
+*
+* Purpose: This class gets storage for each Node straight from the
+*		global heap. It has the same interface as ArenaAllocator, for
+*		trees that should not keep an arena around.
+*
+* Methods:
+* void* Allocate();
+*		Returns storage for one Node from operator new
+* void Deallocate(void* block);
+*		Returns a block to operator delete
+* void Reserve(int count);
+*		Does nothing, the heap is asked for each block separately
+* void Release();
+*		Does nothing, every block has to be Deallocated on its own
+* void Adopt(HeapAllocator<Node>& other);
+*		Does nothing, blocks from any HeapAllocator can be given back to any other
+* void Swap(HeapAllocator<Node>& other);
+*		Does nothing, there is no state to exchange
+*
+* Constants:
+* RELEASES_ALL
+*		false, the owner has to Deallocate every node itself
+*
+*************************************************************************/
+template <typename Node>
+class HeapAllocator
+{
+public:
+	static const bool RELEASES_ALL = false;
+
+	void* Allocate();
+	void Deallocate(void* block);
+	void Reserve(int count);
+	void Release();
+	void Adopt(HeapAllocator<Node>& other);
+	void Swap(HeapAllocator<Node>& other);
+};
+
+
+/// Function Code ///
+
+template<typename Node>
+inline void* HeapAllocator<Node>::Allocate()
+{
+	return ::operator new(sizeof(Node));
+}
+
+template<typename Node>
+inline void HeapAllocator<Node>::Deallocate(void* block)
+{
+	::operator delete(block);
+}
+
+template<typename Node>
+inline void HeapAllocator<Node>::Reserve(int)
+{
+}
+
+template<typename Node>
+inline void HeapAllocator<Node>::Release()
+{
+}
+
+template<typename Node>
+inline void HeapAllocator<Node>::Adopt(HeapAllocator<Node>&)
+{
+}
+
+template<typename Node>
+inline void HeapAllocator<Node>::Swap(HeapAllocator<Node>&)
+{
+}
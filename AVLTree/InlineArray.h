@@ -0,0 +1,231 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: InlineArray.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/************************************************************************
+* Class: InlineArray
+*
+* Purpose: This class is an array of up to Capacity items stored inside
+*		the object, of which only the first Count() slots hold items.
+*		The owner keeps the items sorted by choosing where they go, the
+*		array only shifts them. SmallAVLTree keeps its small sets in one
+*		and every BucketAVLTreeNode is one.
+*
+* Manager functions:
+* InlineArray();
+* ~InlineArray();
+*		Destroys every item
+*
+* Methods:
+* int Count() const;
+*		Returns how many slots hold items
+* bool IsFull() const;
+*		Returns true if there is no free slot
+* T& Item(int index); / const T& Item(int index) const;
+*		Returns the item in a slot
+* template <typename U> void InsertAt(int index, U&& data);
+*		Shifts the items from index up one slot and puts data at index
+* void RemoveAt(int index);
+*		Removes the item at index, shifting the items after it down
+* template <typename U> void PushBack(U&& data);
+*		Puts data in the slot after the last item
+* void CopyFrom(const InlineArray<T, Capacity>& copy);
+*		Copies the items of copy into this array, which is empty. If a copy throws
+*		the array is left empty
+* void TakeFront(InlineArray<T, Capacity>& from);
+*		Moves every item of from (all not greater than ours) in front of ours
+* void TakeBack(InlineArray<T, Capacity>& from);
+*		Moves every item of from (all not less than ours) after ours
+* void SplitInto(InlineArray<T, Capacity>& upper);
+*		Moves the upper half of the items into the empty array upper
+* void Clear();
+*		Destroys every item
+*
+*************************************************************************/
+template <typename T, int Capacity>
+class InlineArray
+{
+public:
+	InlineArray();
+	~InlineArray();
+
+	int Count() const;
+	bool IsFull() const;
+	T& Item(int index);
+	const T& Item(int index) const;
+	template <typename U> void InsertAt(int index, U&& data);
+	void RemoveAt(int index);
+	template <typename U> void PushBack(U&& data);
+	void CopyFrom(const InlineArray<T, Capacity>& copy);
+	void TakeFront(InlineArray<T, Capacity>& from);
+	void TakeBack(InlineArray<T, Capacity>& from);
+	void SplitInto(InlineArray<T, Capacity>& upper);
+	void Clear();
+
+private:
+	InlineArray(const InlineArray<T, Capacity>& copy);
+	InlineArray<T, Capacity>& operator=(const InlineArray<T, Capacity>& rhs);
+
+	typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+	int m_count;
+	Slot m_items[Capacity];
+};
+
+
+/// Function Code ///
+
+template<typename T, int Capacity>
+inline InlineArray<T, Capacity>::InlineArray() : m_count(0)
+{
+}
+
+template<typename T, int Capacity>
+inline InlineArray<T, Capacity>::~InlineArray()
+{
+	Clear();
+}
+
+template<typename T, int Capacity>
+inline int InlineArray<T, Capacity>::Count() const
+{
+	return m_count;
+}
+
+template<typename T, int Capacity>
+inline bool InlineArray<T, Capacity>::IsFull() const
+{
+	return m_count == Capacity;
+}
+
+template<typename T, int Capacity>
+inline T& InlineArray<T, Capacity>::Item(int index)
+{
+	return *reinterpret_cast<T*>(&m_items[index]);
+}
+
+template<typename T, int Capacity>
+inline const T& InlineArray<T, Capacity>::Item(int index) const
+{
+	return *reinterpret_cast<const T*>(&m_items[index]);
+}
+
+template<typename T, int Capacity>
+template<typename U>
+inline void InlineArray<T, Capacity>::InsertAt(int index, U&& data)
+{
+	if (index == m_count)
+	{
+		new (&m_items[m_count]) T(std::forward<U>(data));
+	}
+	else
+	{
+		//data may be one of our own items, so it is copied out before the shift
+		T item(std::forward<U>(data));
+
+		new (&m_items[m_count]) T(std::move(Item(m_count - 1)));
+		for (int slot = m_count - 1; slot > index; --slot)
+			Item(slot) = std::move(Item(slot - 1));
+
+		Item(index) = std::move(item);
+	}
+
+	++m_count;
+}
+
+template<typename T, int Capacity>
+inline void InlineArray<T, Capacity>::RemoveAt(int index)
+{
+	for (int slot = index; slot < m_count - 1; ++slot)
+		Item(slot) = std::move(Item(slot + 1));
+
+	--m_count;
+	Item(m_count).~T();
+}
+
+template<typename T, int Capacity>
+template<typename U>
+inline void InlineArray<T, Capacity>::PushBack(U&& data)
+{
+	new (&m_items[m_count]) T(std::forward<U>(data));
+	++m_count;
+}
+
+template<typename T, int Capacity>
+inline void InlineArray<T, Capacity>::CopyFrom(const InlineArray<T, Capacity>& copy)
+{
+	try
+	{
+		for (; m_count < copy.m_count; ++m_count)
+			new (&m_items[m_count]) T(copy.Item(m_count));
+	}
+	catch (...)
+	{
+		Clear();
+		throw;
+	}
+}
+
+template<typename T, int Capacity>
+inline void InlineArray<T, Capacity>::TakeFront(InlineArray<T, Capacity>& from)
+{
+	const int moved = from.m_count;
+
+	//shift ours up, the slots past the old end are raw and get constructed
+	for (int slot = m_count - 1; slot >= 0; --slot)
+	{
+		if (slot + moved >= m_count)
+			new (&m_items[slot + moved]) T(std::move(Item(slot)));
+		else
+			Item(slot + moved) = std::move(Item(slot));
+	}
+
+	for (int slot = 0; slot < moved; ++slot)
+	{
+		if (slot < m_count)
+			Item(slot) = std::move(from.Item(slot));
+		else
+			new (&m_items[slot]) T(std::move(from.Item(slot)));
+	}
+
+	m_count += moved;
+	from.Clear();
+}
+
+template<typename T, int Capacity>
+inline void InlineArray<T, Capacity>::TakeBack(InlineArray<T, Capacity>& from)
+{
+	for (int slot = 0; slot < from.m_count; ++slot)
+		new (&m_items[m_count + slot]) T(std::move(from.Item(slot)));
+
+	m_count += from.m_count;
+	from.Clear();
+}
+
+template<typename T, int Capacity>
+inline void InlineArray<T, Capacity>::SplitInto(InlineArray<T, Capacity>& upper)
+{
+	const int half = m_count / 2;
+
+	for (int slot = half; slot < m_count; ++slot)
+		upper.PushBack(std::move(Item(slot)));
+
+	while (m_count > half)
+		Item(--m_count).~T();
+}
+
+template<typename T, int Capacity>
+inline void InlineArray<T, Capacity>::Clear()
+{
+	while (m_count > 0)
+		Item(--m_count).~T();
+}
@@ -0,0 +1,275 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: PersistentAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - Added iterators, LowerBound and UpperBound so it can stand in for a copied AVLTree
+*		- 10/17/2026 - Reverse iterators are AVLTreeReverseIterator, which does not copy its path to dereference
+*		- 10/17/2026 - Points to AVL_COPY_ON_WRITE for AVLTrees that share nodes
+*		- 10/17/2026 - Built on AVLTree with AVL_COPY_ON_WRITE instead of its own copy of the copy-on-write code
+**************************************************************/
+
+#pragma once
+
+#include <utility>
+#include "AVLTree.h"
+#include "HeapAllocator.h"
+
+/************************************************************************
+* Class: PersistentAVLTree
+*
+* Purpose: This class represents an AVLTree whose versions share nodes.
+*		Copying the tree or taking a Snapshot is O(1). Insert and Delete
+*		only copy the nodes on their path that another version still
+*		points at, a node used by one version alone is changed in place.
+*		So a snapshot never changes, whatever happens to the tree it was
+*		taken from, and it can be read on another thread while that tree
+*		is written. Nodes are reference counted and freed when the last
+*		version using them is gone.
+*		It is an AVLTree<T, HeapAllocator, AVL_COPY_ON_WRITE> underneath,
+*		with only the read only side of it open, so no one can change the
+*		items a snapshot shares through a T&.
+*
+* Manager functions:
+* PersistentAVLTree();
+* PersistentAVLTree(const PersistentAVLTree<T>& copy);
+*		Shares the nodes of copy in O(1)
+* PersistentAVLTree(PersistentAVLTree<T>&& other);
+*		Takes the nodes of other, leaving it empty
+* ~PersistentAVLTree();
+*		Lets go of the root, freeing every node no other version uses
+* PersistentAVLTree<T>& operator=(const PersistentAVLTree<T>& rhs);
+* PersistentAVLTree<T>& operator=(PersistentAVLTree<T>&& rhs);
+*
+* Methods:
+* PersistentAVLTree<T> Snapshot() const;
+*		Returns the current version in O(1), later changes to this tree do not show in it
+* void Insert(const T& data); / void Insert(T&& data);
+*		Inserts data into the tree
+* void Delete(const T& data);
+*		Deletes the equivalent data from the tree, throws if there is none
+* void Purge();
+*		Empties this version (other versions keep their items)
+* int Height() const;
+*		returns the height of the tree in O(1), throws if it is empty
+* int Size() const;
+*		returns the number of items in the tree in O(1)
+* bool IsEmpty() const;
+*		Returns true if the tree is empty
+* bool IsBalanced() const;
+*		Returns true if all balance factors are between -1 and 1
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* const T* Find(const T& data) const;
+*		Returns a pointer to the stored equivalent data, or nullptr. It stays valid as long as
+*		some version holding the item is alive
+* const_iterator LowerBound(const T& data) const;
+*		Returns an iterator to the smallest item that is not less than data, or end()
+* const_iterator UpperBound(const T& data) const;
+*		Returns an iterator to the smallest item that is greater than data, or end()
+* template <typename Visitor> bool InOrder(Visitor visit) const;
+*		Calls visit with every item in order. If visit returns a bool, returning false stops
+*		the traversal. Returns false if it was stopped, true if it finished
+*
+* Iterators (AVLTreeIterator over this version, changing the tree invalidates them):
+* const_iterator begin() const; / const_iterator end() const;
+* const_reverse_iterator rbegin() const; / const_reverse_iterator rend() const;
+*
+*************************************************************************/
+template <typename T>
+class PersistentAVLTree
+{
+public:
+	typedef AVLTree<T, HeapAllocator, AVL_COPY_ON_WRITE> Tree;
+	typedef typename Tree::iterator iterator;
+	typedef typename Tree::const_iterator const_iterator;
+	typedef typename Tree::reverse_iterator reverse_iterator;
+	typedef typename Tree::const_reverse_iterator const_reverse_iterator;
+
+	PersistentAVLTree();
+	PersistentAVLTree(const PersistentAVLTree<T>& copy);
+	PersistentAVLTree(PersistentAVLTree<T>&& other);
+	~PersistentAVLTree();
+	PersistentAVLTree<T>& operator=(const PersistentAVLTree<T>& rhs);
+	PersistentAVLTree<T>& operator=(PersistentAVLTree<T>&& rhs);
+
+	//Methods
+	PersistentAVLTree<T> Snapshot() const; //Returns the current version in O(1)
+	void Insert(const T& data); //Inserts data into the tree
+	void Insert(T&& data); //Inserts data into the tree, moving it into the node
+	void Delete(const T& data); //Deletes the equivalent data from the tree
+	void Purge(); //Empties this version
+	int Height() const; //returns the height of the tree
+	int Size() const; //returns the number of items in the tree
+
+	//Lookups
+	bool IsEmpty() const;
+	bool IsBalanced() const;
+	bool Contains(const T& data) const;
+	const T* Find(const T& data) const;
+	const_iterator LowerBound(const T& data) const;
+	const_iterator UpperBound(const T& data) const;
+
+	//Iterators
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_reverse_iterator rbegin() const;
+	const_reverse_iterator rend() const;
+
+	//Traversals
+	template <typename Visitor> bool InOrder(Visitor visit) const;
+
+private:
+	Tree m_tree;
+};
+
+
+/// Function Code ///
+
+template<typename T>
+inline PersistentAVLTree<T>::PersistentAVLTree()
+{
+}
+
+template<typename T>
+inline PersistentAVLTree<T>::PersistentAVLTree(const PersistentAVLTree<T> & copy) : m_tree(copy.m_tree)
+{
+}
+
+template<typename T>
+inline PersistentAVLTree<T>::PersistentAVLTree(PersistentAVLTree<T> && other) : m_tree(std::move(other.m_tree))
+{
+}
+
+template<typename T>
+inline PersistentAVLTree<T>::~PersistentAVLTree()
+{
+	//m_tree lets go of its nodes, the ones another version shares stay alive
+}
+
+template<typename T>
+inline PersistentAVLTree<T>& PersistentAVLTree<T>::operator=(const PersistentAVLTree<T> & rhs)
+{
+	m_tree = rhs.m_tree;
+
+	return *this;
+}
+
+template<typename T>
+inline PersistentAVLTree<T>& PersistentAVLTree<T>::operator=(PersistentAVLTree<T> && rhs)
+{
+	m_tree = std::move(rhs.m_tree);
+
+	return *this;
+}
+
+template<typename T>
+inline PersistentAVLTree<T> PersistentAVLTree<T>::Snapshot() const
+{
+	return PersistentAVLTree<T>(*this);
+}
+
+template<typename T>
+inline void PersistentAVLTree<T>::Insert(const T & data)
+{
+	m_tree.Insert(data);
+}
+
+template<typename T>
+inline void PersistentAVLTree<T>::Insert(T && data)
+{
+	m_tree.Insert(std::move(data));
+}
+
+template<typename T>
+inline void PersistentAVLTree<T>::Delete(const T & data)
+{
+	m_tree.Delete(data);
+}
+
+template<typename T>
+inline void PersistentAVLTree<T>::Purge()
+{
+	m_tree.Purge();
+}
+
+template<typename T>
+inline int PersistentAVLTree<T>::Height() const
+{
+	return m_tree.Height();
+}
+
+template<typename T>
+inline int PersistentAVLTree<T>::Size() const
+{
+	return m_tree.Size();
+}
+
+template<typename T>
+inline bool PersistentAVLTree<T>::IsEmpty() const
+{
+	return m_tree.IsEmpty();
+}
+
+template<typename T>
+inline bool PersistentAVLTree<T>::IsBalanced() const
+{
+	return m_tree.IsBalanced();
+}
+
+template<typename T>
+inline bool PersistentAVLTree<T>::Contains(const T & data) const
+{
+	return m_tree.Contains(data);
+}
+
+template<typename T>
+inline const T* PersistentAVLTree<T>::Find(const T & data) const
+{
+	return m_tree.Find(data);
+}
+
+template<typename T>
+inline typename PersistentAVLTree<T>::const_iterator PersistentAVLTree<T>::LowerBound(const T & data) const
+{
+	return m_tree.LowerBound(data);
+}
+
+template<typename T>
+inline typename PersistentAVLTree<T>::const_iterator PersistentAVLTree<T>::UpperBound(const T & data) const
+{
+	return m_tree.UpperBound(data);
+}
+
+template<typename T>
+inline typename PersistentAVLTree<T>::const_iterator PersistentAVLTree<T>::begin() const
+{
+	return m_tree.begin();
+}
+
+template<typename T>
+inline typename PersistentAVLTree<T>::const_iterator PersistentAVLTree<T>::end() const
+{
+	return m_tree.end();
+}
+
+template<typename T>
+inline typename PersistentAVLTree<T>::const_reverse_iterator PersistentAVLTree<T>::rbegin() const
+{
+	return m_tree.rbegin();
+}
+
+template<typename T>
+inline typename PersistentAVLTree<T>::const_reverse_iterator PersistentAVLTree<T>::rend() const
+{
+	return m_tree.rend();
+}
+
+template<typename T>
+template<typename Visitor>
+inline bool PersistentAVLTree<T>::InOrder(Visitor visit) const
+{
+	//the const traversal only reads, so the nodes stay shared with the other versions.
+	//Named explicitly so a plain function does not pick the void InOrder(void visit(const T&)) overload
+	return m_tree.template InOrder<Visitor>(visit);
+}
@@ -0,0 +1,389 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: ReadMostlyAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include "Exception.h"
+#include "PersistentAVLTree.h"
+#include "Queue.h"
+
+/************************************************************************
+* Class: ReadMostlyAVLTree
+*
+* Purpose: This class is an AVL tree for one writer and many reader
+*		threads. Readers never lock and never write to shared memory
+*		other than their own slot, so reads scale with the number of cores.
+*		The writer changes a private PersistentAVLTree (which copies the
+*		path of every change instead of touching published nodes) and then
+*		publishes the new version with one atomic store of its root. A
+*		reader pins the epoch it starts in and reads whichever version
+*		was published at that point, which no writer changes again.
+*		Replaced versions are retired with the epoch they were replaced
+*		in and deleted once every pinned reader started after it, so a
+*		delete never frees nodes a reader may still be walking.
+*		Writes are serialized by a lock, so several writer threads are
+*		safe, they just take turns. The tree must not be destroyed while
+*		a Reader of it is alive.
+*
+* Manager functions:
+* ReadMostlyAVLTree();
+* ~ReadMostlyAVLTree();
+*		Deletes the published version and every retired one
+*
+* Methods (writer side):
+* void Insert(const T& data); / void Insert(T&& data);
+*		Inserts data and publishes the new version
+* void Delete(const T& data);
+*		Deletes the equivalent data and publishes the new version, throws if there is none
+* void Purge();
+*		Publishes an empty version
+* void Reclaim();
+*		Deletes every retired version no pinned reader can still see. Every write
+*		does this too, call it to free memory after readers left and writes stopped
+* int Retired() const;
+*		Returns how many replaced versions are waiting for readers to leave
+*
+* Class: ReadMostlyAVLTree<T>::Reader
+*		A reader's handle on the tree. Each reading thread keeps its own Reader,
+*		which holds one of MAX_READERS slots for as long as it lives.
+*
+*	Reader(ReadMostlyAVLTree<T>& tree);
+*		Takes a free slot, throws if all MAX_READERS are in use
+*	~Reader();
+*		Leaves if needed and frees the slot
+*	const PersistentAVLTree<T>& Enter();
+*		Pins the current epoch and returns the version published now. The version and
+*		everything found in it (pointers, iterators) stays valid and unchanged until Leave.
+*		Entering again before Leave returns the same version
+*	void Leave();
+*		Unpins, so the versions this reader saw may be deleted
+*	bool Contains(const T& data);
+*		Enters, looks data up in the current version and leaves
+*	bool Find(const T& data, T& found);
+*		Like Contains, and copies the stored item into found if it is there
+*	int Size();
+*		Returns the number of items in the current version
+*	PersistentAVLTree<T> Snapshot();
+*		Returns the current version in O(1). It holds its own references, so it
+*		can be kept and read after Leave
+*
+* --- HELPER FUNCTIONS ---
+* void Publish();
+*		Makes a copy of the writer's version current and retires the one it replaces
+* void ReclaimRetired();
+*		Reclaim without taking the lock, for the writer functions that already hold it
+* unsigned long long OldestPinned() const;
+*		Returns the smallest epoch pinned by a reader, or the current epoch if none is
+*
+*************************************************************************/
+template <typename T>
+class ReadMostlyAVLTree
+{
+public:
+	enum READERS : int { MAX_READERS = 64 };
+
+	class Reader
+	{
+	public:
+		explicit Reader(ReadMostlyAVLTree<T>& tree);
+		~Reader();
+
+		const PersistentAVLTree<T>& Enter();
+		void Leave();
+
+		bool Contains(const T& data);
+		bool Find(const T& data, T& found);
+		int Size();
+		PersistentAVLTree<T> Snapshot();
+
+	private:
+		Reader(const Reader& copy);
+		Reader& operator=(const Reader& rhs);
+
+		ReadMostlyAVLTree<T>& m_tree;
+		int m_slot;
+		const PersistentAVLTree<T>* m_version; //nullptr while not entered
+	};
+
+	ReadMostlyAVLTree();
+	~ReadMostlyAVLTree();
+
+	//Writer
+	void Insert(const T& data); //Inserts data and publishes the new version
+	void Insert(T&& data); //Inserts data, moving it into the node
+	void Delete(const T& data); //Deletes the equivalent data and publishes the new version
+	void Purge(); //Publishes an empty version
+	void Reclaim(); //Deletes the retired versions no reader can see
+	int Retired() const; //Returns how many versions wait for readers to leave
+
+private:
+	ReadMostlyAVLTree(const ReadMostlyAVLTree<T>& copy);
+	ReadMostlyAVLTree<T>& operator=(const ReadMostlyAVLTree<T>& rhs);
+
+	//aligned to a cache line of its own, so readers never write to a line another reader uses
+	struct alignas(64) ReaderSlot
+	{
+		ReaderSlot() : m_epoch(IDLE), m_taken(false) {}
+
+		std::atomic<unsigned long long> m_epoch; //IDLE or the epoch the reader entered in
+		std::atomic<bool> m_taken;
+	};
+
+	struct RetiredVersion
+	{
+		const PersistentAVLTree<T>* m_version;
+		unsigned long long m_epoch; //the epoch it was replaced in
+
+		bool operator!=(const RetiredVersion& rhs) const { return m_version != rhs.m_version; } //List::Extract finds items by value
+	};
+
+	static const unsigned long long IDLE = 0;
+
+	void Publish();
+	void ReclaimRetired();
+	unsigned long long OldestPinned() const;
+
+	ReaderSlot m_slots[MAX_READERS];
+	std::atomic<const PersistentAVLTree<T>*> m_published;
+	std::atomic<unsigned long long> m_epoch;
+
+	//writer only, guarded by m_writeLock
+	mutable std::mutex m_writeLock;
+	PersistentAVLTree<T> m_writer;
+	Queue<RetiredVersion> m_retired; //oldest first, so reclaiming stops at the first one still visible
+};
+
+
+/// Function Code ///
+
+template<typename T>
+inline ReadMostlyAVLTree<T>::Reader::Reader(ReadMostlyAVLTree<T>& tree) : m_tree(tree), m_slot(-1), m_version(nullptr)
+{
+	for (int i = 0; i < MAX_READERS && m_slot == -1; ++i)
+	{
+		if (!m_tree.m_slots[i].m_taken.load(std::memory_order_relaxed) && !m_tree.m_slots[i].m_taken.exchange(true, std::memory_order_acquire))
+			m_slot = i;
+	}
+
+	if (m_slot == -1)
+		throw Exception("Too many readers on tree");
+}
+
+template<typename T>
+inline ReadMostlyAVLTree<T>::Reader::~Reader()
+{
+	Leave();
+	m_tree.m_slots[m_slot].m_taken.store(false, std::memory_order_release);
+
+	//Default values
+	m_version = nullptr;
+	m_slot = -1;
+}
+
+template<typename T>
+inline const PersistentAVLTree<T>& ReadMostlyAVLTree<T>::Reader::Enter()
+{
+	if (m_version == nullptr)
+	{
+		//pin before loading the root: a writer that retires the version loaded here sees the pin.
+		//seq_cst keeps the store and the load below in that order on every platform
+		m_tree.m_slots[m_slot].m_epoch.store(m_tree.m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+		m_version = m_tree.m_published.load(std::memory_order_seq_cst);
+	}
+
+	return *m_version;
+}
+
+template<typename T>
+inline void ReadMostlyAVLTree<T>::Reader::Leave()
+{
+	if (m_version != nullptr)
+	{
+		m_tree.m_slots[m_slot].m_epoch.store(IDLE, std::memory_order_release);
+		m_version = nullptr;
+	}
+}
+
+template<typename T>
+inline bool ReadMostlyAVLTree<T>::Reader::Contains(const T & data)
+{
+	bool found = false;
+
+	try
+	{
+		found = Enter().Contains(data);
+	}
+	catch (...)
+	{
+		Leave();
+		throw;
+	}
+
+	Leave();
+
+	return found;
+}
+
+template<typename T>
+inline bool ReadMostlyAVLTree<T>::Reader::Find(const T & data, T & found)
+{
+	bool wasFound = false;
+
+	try
+	{
+		const T* item = Enter().Find(data);
+		if (item != nullptr)
+		{
+			found = *item;
+			wasFound = true;
+		}
+	}
+	catch (...)
+	{
+		Leave();
+		throw;
+	}
+
+	Leave();
+
+	return wasFound;
+}
+
+template<typename T>
+inline int ReadMostlyAVLTree<T>::Reader::Size()
+{
+	int size = Enter().Size();
+	Leave();
+
+	return size;
+}
+
+template<typename T>
+inline PersistentAVLTree<T> ReadMostlyAVLTree<T>::Reader::Snapshot()
+{
+	//retaining the root is safe while pinned, the version still holds its reference
+	PersistentAVLTree<T> snapshot(Enter());
+	Leave();
+
+	return snapshot;
+}
+
+template<typename T>
+inline ReadMostlyAVLTree<T>::ReadMostlyAVLTree() : m_published(new PersistentAVLTree<T>()), m_epoch(IDLE + 1)
+{
+}
+
+template<typename T>
+inline ReadMostlyAVLTree<T>::~ReadMostlyAVLTree()
+{
+	delete m_published.load(std::memory_order_relaxed);
+
+	while (!m_retired.isEmpty())
+		delete m_retired.Dequeue().m_version;
+
+	//Default values
+	m_published.store(nullptr, std::memory_order_relaxed);
+}
+
+template<typename T>
+inline void ReadMostlyAVLTree<T>::Insert(const T & data)
+{
+	std::lock_guard<std::mutex> lock(m_writeLock);
+
+	m_writer.Insert(data);
+	Publish();
+}
+
+template<typename T>
+inline void ReadMostlyAVLTree<T>::Insert(T && data)
+{
+	std::lock_guard<std::mutex> lock(m_writeLock);
+
+	m_writer.Insert(std::move(data));
+	Publish();
+}
+
+template<typename T>
+inline void ReadMostlyAVLTree<T>::Delete(const T & data)
+{
+	std::lock_guard<std::mutex> lock(m_writeLock);
+
+	//throws before anything changes if data is not there, so nothing is published
+	m_writer.Delete(data);
+	Publish();
+}
+
+template<typename T>
+inline void ReadMostlyAVLTree<T>::Purge()
+{
+	std::lock_guard<std::mutex> lock(m_writeLock);
+
+	m_writer.Purge();
+	Publish();
+}
+
+template<typename T>
+inline void ReadMostlyAVLTree<T>::Reclaim()
+{
+	std::lock_guard<std::mutex> lock(m_writeLock);
+
+	ReclaimRetired();
+}
+
+template<typename T>
+inline int ReadMostlyAVLTree<T>::Retired() const
+{
+	std::lock_guard<std::mutex> lock(m_writeLock);
+
+	return m_retired.Size();
+}
+
+template<typename T>
+inline void ReadMostlyAVLTree<T>::Publish()
+{
+	//the published copy holds a reference on the root, so the writer's next change copies
+	//its path instead of changing nodes readers can reach
+	RetiredVersion retired;
+	retired.m_version = m_published.exchange(new PersistentAVLTree<T>(m_writer), std::memory_order_seq_cst);
+
+	//readers that pin a later epoch load the new root, only the ones pinned at or before this one may hold the old
+	retired.m_epoch = m_epoch.fetch_add(1, std::memory_order_seq_cst);
+	m_retired.Enqueue(retired);
+
+	ReclaimRetired();
+}
+
+template<typename T>
+inline void ReadMostlyAVLTree<T>::ReclaimRetired()
+{
+	unsigned long long oldest = OldestPinned();
+
+	while (!m_retired.isEmpty() && m_retired.Front().m_epoch < oldest)
+	{
+		//drops the version's references, nodes still used by newer versions survive
+		delete m_retired.Dequeue().m_version;
+	}
+}
+
+template<typename T>
+inline unsigned long long ReadMostlyAVLTree<T>::OldestPinned() const
+{
+	unsigned long long oldest = m_epoch.load(std::memory_order_seq_cst);
+
+	for (int i = 0; i < MAX_READERS; ++i)
+	{
+		unsigned long long pinned = m_slots[i].m_epoch.load(std::memory_order_seq_cst);
+
+		if (pinned != IDLE && pinned < oldest)
+			oldest = pinned;
+	}
+
+	return oldest;
+}
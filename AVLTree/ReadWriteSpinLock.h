@@ -0,0 +1,127 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: ReadWriteSpinLock.h
+* Date Created: 10/17/2026
+* Modifications:
+**************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+/************************************************************************
+* Class: ReadWriteSpinLock
+*
+* Purpose: This class is a reader/writer lock that fits in one int, so
+*		every node of a concurrent tree can carry its own. Any number of
+*		readers or one writer can hold it. A waiting writer keeps new
+*		readers out so a steady stream of lookups cannot starve it.
+*		Waiters spin for a moment and then yield their time slice, the
+*		lock is meant to be held only for a few pointer updates.
+*
+* Manager functions:
+* ReadWriteSpinLock();
+*		Starts unlocked
+*
+* Methods:
+* void Lock();
+*		Waits until no one else holds the lock and takes it exclusively
+* void Unlock();
+*		Releases an exclusive hold
+* void LockShared();
+*		Waits until no writer holds or waits for the lock and takes it shared
+* void UnlockShared();
+*		Releases a shared hold
+*
+* --- HELPER FUNCTIONS ---
+* static void Backoff(int& spins);
+*		Spins a few times, then yields
+*
+*************************************************************************/
+class ReadWriteSpinLock
+{
+public:
+	ReadWriteSpinLock();
+
+	void Lock();
+	void Unlock();
+	void LockShared();
+	void UnlockShared();
+
+private:
+	ReadWriteSpinLock(const ReadWriteSpinLock& copy);
+	ReadWriteSpinLock& operator=(const ReadWriteSpinLock& rhs);
+
+	enum STATE : int { WRITER = 1, WAITING = 2, READER = 4 }; //readers are counted in steps of READER
+	enum SPINS : int { SPINS_BEFORE_YIELD = 64 };
+
+	static void Backoff(int& spins);
+
+	std::atomic<int> m_state;
+};
+
+
+/// Function Code ///
+
+inline ReadWriteSpinLock::ReadWriteSpinLock() : m_state(0)
+{
+}
+
+inline void ReadWriteSpinLock::Lock()
+{
+	int spins = 0;
+
+	for (;;)
+	{
+		int state = m_state.load(std::memory_order_relaxed);
+
+		if ((state & ~WAITING) == 0)
+		{
+			//taking the lock clears WAITING, other waiting writers set it again on their next try
+			if (m_state.compare_exchange_weak(state, WRITER, std::memory_order_acquire, std::memory_order_relaxed))
+				return;
+		}
+		else if ((state & WAITING) == 0)
+		{
+			m_state.fetch_or(WAITING, std::memory_order_relaxed);
+		}
+
+		Backoff(spins);
+	}
+}
+
+inline void ReadWriteSpinLock::Unlock()
+{
+	m_state.fetch_and(~WRITER, std::memory_order_release);
+}
+
+inline void ReadWriteSpinLock::LockShared()
+{
+	int spins = 0;
+
+	for (;;)
+	{
+		int state = m_state.load(std::memory_order_relaxed);
+
+		if ((state & (WRITER | WAITING)) == 0 &&
+			m_state.compare_exchange_weak(state, state + READER, std::memory_order_acquire, std::memory_order_relaxed))
+			return;
+
+		Backoff(spins);
+	}
+}
+
+inline void ReadWriteSpinLock::UnlockShared()
+{
+	m_state.fetch_sub(READER, std::memory_order_release);
+}
+
+inline void ReadWriteSpinLock::Backoff(int& spins)
+{
+	if (++spins >= SPINS_BEFORE_YIELD)
+	{
+		spins = 0;
+		std::this_thread::yield();
+	}
+}
@@ -0,0 +1,657 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: ShardedAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - A hot shard hands half its items to one neighbor instead of every shard being rebuilt, with back off
+**************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AVLTree.h"
+#include "Exception.h"
+#include "ReadWriteSpinLock.h"
+
+/************************************************************************
+* Class: ShardedAVLTree
+*
+* Purpose: This class splits one ordered set of items over several
+*		independent AVLTrees (shards), each holding one range of keys and
+*		guarded by its own lock. Threads working in different ranges lock
+*		different shards, so writes with good key locality scale across
+*		cores without any change to AVLTree itself.
+*		Each shard keeps the first key past its range, so shard i holds the
+*		items that are not less than the bound of shard i - 1 and less than
+*		its own. A fresh tree puts everything in shard 0 and the shards
+*		after the last one in use are empty and have no range yet.
+*		The tree counts the writes each shard takes, and when one shard has
+*		taken more than HOT_FACTOR times its share of the last
+*		CHECK_INTERVAL writes per shard, half of its items move across one
+*		of its bounds: into the next unused shard if it is the last one in
+*		use, otherwise to the neighbor that took fewer writes. Only the two
+*		shards on that bound are locked and only the items that change
+*		shard are moved. If the same shard is hot again in the next window
+*		(increasing keys follow the end of the key space wherever the bound
+*		is) the windows double, up to MAX_BACKOFF times, before it is tried
+*		again.
+*		Lookups route with a copy of the bounds and step to a neighbor if
+*		the bound moved before they got the shard. Scans hold the next
+*		shard before they let go of the last one, so no item can cross
+*		behind them, but they do not see all shards at one instant.
+*
+* Manager functions:
+* explicit ShardedAVLTree(int shards = DEFAULT_SHARDS);
+*		Makes a tree with shards shards, throws if shards is less than 1
+* ~ShardedAVLTree();
+*
+* Methods (safe to call from any number of threads):
+* void Insert(const T& data); / void Insert(T&& data);
+*		Inserts data into the shard for its key
+* void Delete(const T& data);
+*		Deletes the equivalent data, throws if there is none
+* void Purge();
+*		Removes every item, the bounds stay
+* void Rebalance();
+*		Moves the bounds so every shard holds the same number of items,
+*		each item crossing only the bounds between its shard and its new one
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* bool Find(const T& data, T& found) const;
+*		Like Contains, and copies the stored item into found if it is there
+* int Size() const;
+*		returns the number of items in the tree
+* bool IsEmpty() const;
+*		Returns true if the tree has no items
+* int ShardCount() const;
+*		Returns the number of shards
+* int ShardSize(int shard) const;
+*		Returns the number of items in one shard, throws if there is no such shard
+* template <typename Visitor> bool InOrder(Visitor visit) const;
+*		Calls visit with every item in order, shard after shard
+* template <typename Visitor> bool Range(const T& low, const T& high, Visitor visit) const;
+*		Calls visit in order with every item between low and high, inclusive
+*		For both scans, if visit returns a bool, returning false stops the scan.
+*		They return false if it was stopped, true if it finished
+*
+* --- HELPER FUNCTIONS ---
+* struct Shard
+*		One AVLTree, its lock, its upper bound and its write count this window
+* template <typename U> void InsertItem(U&& data);
+*		Helps both Inserts
+* int LockShardOf(const T& data) const;
+*		Locks the shard whose range holds data and returns its index
+* template <typename Operation> void UseShard(const T& data, Operation op) const;
+*		Runs op on the shard for data with that shard locked
+* template <typename Visitor> bool Scan(int shard, const T* low, const T* high, Visitor& visit) const;
+*		Visits the items from low to high (nullptr for no limit) from the
+*		locked shard on, and unlocks the last shard it locked
+* void MoveBoundary(int boundary, int count);
+*		Moves about count items across the bound after shard boundary,
+*		to the right if count is positive and to the left if it is negative
+* void NoteWrite();
+*		Counts a write and cools the hottest shard when a window closes on a hot one
+* void CoolShard(int hot);
+*		Moves half of the hot shard's items into a neighbor
+* int HottestShard() const;
+*		Returns the shard that took the most writes this window
+* int Window() const;
+*		Returns the number of writes in a window with the current back off
+* void ResetWrites();
+*		Starts a new window
+* template <typename Visitor> static bool Visit(Visitor& visit, const T& data);
+*		Calls visit and turns its result into "keep going"
+*
+*************************************************************************/
+template <typename T, template <typename> class Allocator = ArenaAllocator, unsigned Options = AVL_PLAIN>
+class ShardedAVLTree
+{
+public:
+	enum TUNING : int { DEFAULT_SHARDS = 8, CHECK_INTERVAL = 1024, HOT_FACTOR = 2, MAX_BACKOFF = 64 };
+
+	explicit ShardedAVLTree(int shards = DEFAULT_SHARDS);
+	~ShardedAVLTree();
+
+	//Methods
+	void Insert(const T& data); //Inserts data into the shard for its key
+	void Insert(T&& data); //Inserts data, moving it into the node
+	void Delete(const T& data); //Deletes the equivalent data
+	void Purge(); //Removes every item
+	void Rebalance(); //Evens out the shards
+	int Size() const; //returns the number of items in the tree
+
+	//Lookups
+	bool IsEmpty() const;
+	bool Contains(const T& data) const;
+	bool Find(const T& data, T& found) const;
+	int ShardCount() const;
+	int ShardSize(int shard) const;
+
+	//Scans
+	template <typename Visitor> bool InOrder(Visitor visit) const;
+	template <typename Visitor> bool Range(const T& low, const T& high, Visitor visit) const;
+
+private:
+	static_assert((Options & AVL_COUNTED) == 0, "ShardedAVLTree moves items between shards one by one, AVL_COUNTED is not supported");
+
+	ShardedAVLTree(const ShardedAVLTree<T, Allocator, Options>& copy);
+	ShardedAVLTree<T, Allocator, Options>& operator=(const ShardedAVLTree<T, Allocator, Options>& rhs);
+
+	struct Shard
+	{
+		Shard() : m_high(nullptr), m_writes(0) {}
+		~Shard() { delete m_high; }
+
+		std::mutex m_lock;
+		AVLTree<T, Allocator, Options> m_tree;
+		T* m_high; //first key past this shard, nullptr for the last shard in use and the ones after it
+		std::atomic<int> m_writes;
+	};
+
+	template <typename U> void InsertItem(U&& data);
+	int LockShardOf(const T& data) const;
+	template <typename Operation> void UseShard(const T& data, Operation op) const;
+	template <typename Visitor> bool Scan(int shard, const T* low, const T* high, Visitor& visit) const;
+	void MoveBoundary(int boundary, int count);
+	void NoteWrite();
+	void CoolShard(int hot);
+	int HottestShard() const;
+	int Window() const;
+	void ResetWrites();
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data);
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data, std::true_type);
+	template <typename Visitor> static bool Visit(Visitor& visit, const T& data, std::false_type);
+
+	int m_numShards;
+	Shard* m_shards;
+	std::vector<T> m_splits; //copies of the bounds of the shards in use but the last, only a hint for routing
+	mutable ReadWriteSpinLock m_layoutLock; //guards m_splits, never held while waiting for a shard
+	std::mutex m_rebalanceLock; //one bound moves at a time, taken before any shard
+	int m_used; //shards in use, changed under m_rebalanceLock
+	int m_lastHot; //the shard cooled at the last check, -1 if none
+	std::atomic<int> m_backoff; //windows are this many times CHECK_INTERVAL per shard
+	std::atomic<int> m_numElements;
+	std::atomic<int> m_writes; //since the last hot check
+};
+
+
+/// Function Code ///
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline ShardedAVLTree<T, Allocator, Options>::ShardedAVLTree(int shards) : m_numShards(shards), m_shards(nullptr), m_used(1), m_lastHot(-1), m_backoff(1), m_numElements(0), m_writes(0)
+{
+	if (shards < 1)
+		throw Exception("A sharded tree needs at least one shard");
+
+	m_shards = new Shard[m_numShards];
+
+	//the hint never grows past this, so updating it cannot reallocate
+	m_splits.reserve(m_numShards - 1);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline ShardedAVLTree<T, Allocator, Options>::~ShardedAVLTree()
+{
+	delete[] m_shards;
+
+	//Default values
+	m_shards = nullptr;
+	m_numShards = 0;
+	m_used = 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::Insert(const T & data)
+{
+	InsertItem(data);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::Insert(T && data)
+{
+	InsertItem(std::move(data));
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::Delete(const T & data)
+{
+	UseShard(data, [&](Shard& shard)
+	{
+		shard.m_tree.Delete(data);
+		shard.m_writes.fetch_add(1, std::memory_order_relaxed);
+	});
+
+	--m_numElements;
+	NoteWrite();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::Purge()
+{
+	//in shard order, like every other holder of more than one shard
+	for (int i = 0; i < m_numShards; ++i)
+		m_shards[i].m_lock.lock();
+
+	for (int i = 0; i < m_numShards; ++i)
+	{
+		m_shards[i].m_tree.Purge();
+		m_shards[i].m_writes.store(0, std::memory_order_relaxed);
+	}
+
+	m_numElements = 0;
+	m_writes.store(0, std::memory_order_relaxed);
+
+	for (int i = m_numShards - 1; i >= 0; --i)
+		m_shards[i].m_lock.unlock();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::Rebalance()
+{
+	if (m_numShards == 1)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_rebalanceLock);
+
+	std::vector<int> sizes(m_numShards);
+	int total = 0;
+	for (int i = 0; i < m_numShards; ++i)
+	{
+		sizes[i] = ShardSize(i);
+		total += sizes[i];
+	}
+
+	//flow[i] is how many items have to cross the bound after shard i, positive to the right
+	std::vector<int> flow(m_numShards - 1);
+	int before = 0;
+	for (int i = 0; i < m_numShards - 1; ++i)
+	{
+		before += sizes[i];
+		flow[i] = before - static_cast<int>(static_cast<long long>(total) * (i + 1) / m_numShards);
+	}
+
+	//rightward moves go left to right and leftward moves right to left, so every
+	//shard has already received what it passes on and each item moves hop by hop
+	for (int i = 0; i < m_numShards - 1; ++i)
+	{
+		if (flow[i] > 0)
+			MoveBoundary(i, flow[i]);
+	}
+
+	for (int i = m_numShards - 2; i >= 0; --i)
+	{
+		if (flow[i] < 0)
+			MoveBoundary(i, flow[i]);
+	}
+
+	m_lastHot = -1;
+	m_backoff.store(1, std::memory_order_relaxed);
+	ResetWrites();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int ShardedAVLTree<T, Allocator, Options>::Size() const
+{
+	return m_numElements.load();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool ShardedAVLTree<T, Allocator, Options>::IsEmpty() const
+{
+	return Size() == 0;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool ShardedAVLTree<T, Allocator, Options>::Contains(const T & data) const
+{
+	bool found = false;
+	UseShard(data, [&](Shard& shard) { found = shard.m_tree.Contains(data); });
+
+	return found;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline bool ShardedAVLTree<T, Allocator, Options>::Find(const T & data, T & found) const
+{
+	bool wasFound = false;
+	UseShard(data, [&](Shard& shard)
+	{
+		const T* item = shard.m_tree.Find(data);
+		if (item != nullptr)
+		{
+			found = *item;
+			wasFound = true;
+		}
+	});
+
+	return wasFound;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int ShardedAVLTree<T, Allocator, Options>::ShardCount() const
+{
+	return m_numShards;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int ShardedAVLTree<T, Allocator, Options>::ShardSize(int shard) const
+{
+	if (shard < 0 || shard >= m_numShards)
+		throw Exception("No such shard");
+
+	std::lock_guard<std::mutex> lock(m_shards[shard].m_lock);
+
+	return m_shards[shard].m_tree.Size();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool ShardedAVLTree<T, Allocator, Options>::InOrder(Visitor visit) const
+{
+	m_shards[0].m_lock.lock();
+
+	return Scan(0, nullptr, nullptr, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool ShardedAVLTree<T, Allocator, Options>::Range(const T & low, const T & high, Visitor visit) const
+{
+	return Scan(LockShardOf(low), &low, &high, visit);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename U>
+inline void ShardedAVLTree<T, Allocator, Options>::InsertItem(U && data)
+{
+	UseShard(data, [&](Shard& shard)
+	{
+		shard.m_tree.Insert(std::forward<U>(data));
+		shard.m_writes.fetch_add(1, std::memory_order_relaxed);
+	});
+
+	++m_numElements;
+	NoteWrite();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int ShardedAVLTree<T, Allocator, Options>::LockShardOf(const T & data) const
+{
+	//shard i starts at split i - 1, so the hint is the number of split points not greater than data
+	m_layoutLock.LockShared();
+	int shard = static_cast<int>(std::upper_bound(m_splits.begin(), m_splits.end(), data) - m_splits.begin());
+	m_layoutLock.UnlockShared();
+
+	//a bound can only move with both of its shards locked, so the locked shard's range is settled
+	while (true)
+	{
+		m_shards[shard].m_lock.lock();
+
+		int step = 0;
+		try
+		{
+			const T* low = (shard > 0) ? m_shards[shard - 1].m_high : nullptr;
+			const T* high = m_shards[shard].m_high;
+
+			if (shard > 0 && (low == nullptr || data < *low)) //past the shards in use, or below this range
+				step = -1;
+			else if (high != nullptr && !(data < *high))
+				step = 1;
+		}
+		catch (...)
+		{
+			m_shards[shard].m_lock.unlock();
+			throw;
+		}
+
+		if (step == 0)
+			return shard;
+
+		m_shards[shard].m_lock.unlock();
+		shard += step;
+	}
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Operation>
+inline void ShardedAVLTree<T, Allocator, Options>::UseShard(const T & data, Operation op) const
+{
+	Shard& shard = m_shards[LockShardOf(data)];
+	std::lock_guard<std::mutex> lock(shard.m_lock, std::adopt_lock);
+
+	op(shard);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool ShardedAVLTree<T, Allocator, Options>::Scan(int shard, const T * low, const T * high, Visitor & visit) const
+{
+	bool finished = true;
+	bool pastHigh = false;
+
+	try
+	{
+		while (true)
+		{
+			const AVLTree<T, Allocator, Options>& tree = m_shards[shard].m_tree;
+
+			for (typename AVLTree<T, Allocator, Options>::const_iterator current = (low != nullptr) ? tree.LowerBound(*low) : tree.begin();
+				current != tree.end() && finished; ++current)
+			{
+				if (high != nullptr && *high < *current)
+				{
+					pastHigh = true;
+					break;
+				}
+
+				finished = Visit(visit, *current);
+			}
+
+			if (!finished || pastHigh || m_shards[shard].m_high == nullptr)
+				break;
+
+			//hand over hand, so no item can move from a shard ahead of the scan into one behind it
+			m_shards[shard + 1].m_lock.lock();
+			m_shards[shard].m_lock.unlock();
+			++shard;
+		}
+	}
+	catch (...)
+	{
+		m_shards[shard].m_lock.unlock();
+		throw;
+	}
+
+	m_shards[shard].m_lock.unlock();
+
+	return finished;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::MoveBoundary(int boundary, int count)
+{
+	Shard& left = m_shards[boundary];
+	Shard& right = m_shards[boundary + 1];
+	std::lock_guard<std::mutex> leftLock(left.m_lock);
+	std::lock_guard<std::mutex> rightLock(right.m_lock);
+
+	bool toRight = count > 0;
+	Shard& from = toRight ? left : right;
+	Shard& to = toRight ? right : left;
+
+	//a shard not in use is empty, and so is the one past it
+	count = std::min(toRight ? count : -count, from.m_tree.Size());
+	if (count == 0 || (toRight ? boundary : boundary + 1) >= m_used)
+		return;
+
+	std::vector<T> moving;
+	T* high = nullptr; //the new bound of left, nullptr if right drops out of use
+	bool activates = toRight && boundary + 1 == m_used;
+
+	if (toRight)
+	{
+		typename AVLTree<T, Allocator, Options>::const_iterator first = from.m_tree.end();
+		for (int i = 0; i < count; ++i)
+			--first;
+
+		//equal items never straddle a bound
+		first = from.m_tree.LowerBound(*first);
+		moving.assign(first, from.m_tree.end());
+		high = new T(moving.front());
+	}
+	else
+	{
+		typename AVLTree<T, Allocator, Options>::const_iterator last = from.m_tree.begin();
+		for (int i = 1; i < count; ++i)
+			++last;
+
+		last = from.m_tree.UpperBound(*last);
+		moving.assign(from.m_tree.begin(), last);
+		if (last != from.m_tree.end())
+			high = new T(*last);
+		else if (right.m_high != nullptr)
+			high = new T(*right.m_high);
+	}
+
+	//every moving item sorts on the far side of the items to already holds, so undoing the inserts deletes only them
+	typename std::vector<T>::const_iterator current = moving.begin();
+	try
+	{
+		for (; current != moving.end(); ++current)
+			to.m_tree.Insert(*current);
+	}
+	catch (...)
+	{
+		while (current != moving.begin())
+			to.m_tree.Delete(*--current);
+
+		delete high;
+		throw;
+	}
+
+	for (current = moving.begin(); current != moving.end(); ++current)
+		from.m_tree.Delete(*current);
+
+	delete left.m_high;
+	left.m_high = high;
+
+	m_layoutLock.Lock();
+
+	if (activates)
+	{
+		++m_used;
+		m_splits.push_back(*high);
+	}
+	else if (high == nullptr)
+	{
+		--m_used;
+		m_splits.pop_back();
+	}
+	else
+	{
+		m_splits[boundary] = *high;
+	}
+
+	m_layoutLock.Unlock();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::NoteWrite()
+{
+	//the counts are a heuristic and need no lock, the writes past a full window keep trying until one gets the check
+	if (m_numShards == 1 || m_writes.fetch_add(1, std::memory_order_relaxed) + 1 < Window())
+		return;
+
+	std::unique_lock<std::mutex> lock(m_rebalanceLock, std::try_to_lock);
+	if (!lock.owns_lock() || m_writes.load(std::memory_order_relaxed) < Window())
+		return;
+
+	int hot = HottestShard();
+	int backoff = m_backoff.load(std::memory_order_relaxed);
+
+	if (m_shards[hot].m_writes.load(std::memory_order_relaxed) <= HOT_FACTOR * CHECK_INTERVAL * backoff)
+	{
+		m_lastHot = -1;
+		m_backoff.store(1, std::memory_order_relaxed);
+	}
+	else if (hot == m_lastHot && backoff < MAX_BACKOFF)
+	{
+		//cooling it last time did not help, give the load longer to move on before moving items again
+		m_backoff.store(2 * backoff, std::memory_order_relaxed);
+	}
+	else
+	{
+		CoolShard(hot);
+		m_lastHot = hot;
+	}
+
+	ResetWrites();
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::CoolShard(int hot)
+{
+	int half = ShardSize(hot) / 2;
+
+	if (hot + 1 == m_used && m_used < m_numShards)
+		MoveBoundary(hot, half);
+	else if (hot > 0 && (hot + 1 == m_used || m_shards[hot - 1].m_writes.load(std::memory_order_relaxed) <= m_shards[hot + 1].m_writes.load(std::memory_order_relaxed)))
+		MoveBoundary(hot - 1, -half);
+	else
+		MoveBoundary(hot, half);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int ShardedAVLTree<T, Allocator, Options>::HottestShard() const
+{
+	int hot = 0;
+
+	for (int i = 1; i < m_used; ++i)
+	{
+		if (m_shards[i].m_writes.load(std::memory_order_relaxed) > m_shards[hot].m_writes.load(std::memory_order_relaxed))
+			hot = i;
+	}
+
+	return hot;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline int ShardedAVLTree<T, Allocator, Options>::Window() const
+{
+	return CHECK_INTERVAL * m_numShards * m_backoff.load(std::memory_order_relaxed);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+inline void ShardedAVLTree<T, Allocator, Options>::ResetWrites()
+{
+	for (int i = 0; i < m_numShards; ++i)
+		m_shards[i].m_writes.store(0, std::memory_order_relaxed);
+	m_writes.store(0, std::memory_order_relaxed);
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool ShardedAVLTree<T, Allocator, Options>::Visit(Visitor& visit, const T& data)
+{
+	return Visit(visit, data, std::is_void<decltype(visit(data))>());
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool ShardedAVLTree<T, Allocator, Options>::Visit(Visitor& visit, const T& data, std::true_type)
+{
+	visit(data);
+	return true;
+}
+
+template<typename T, template <typename> class Allocator, unsigned Options>
+template<typename Visitor>
+inline bool ShardedAVLTree<T, Allocator, Options>::Visit(Visitor& visit, const T& data, std::false_type)
+{
+	return static_cast<bool>(visit(data));
+}
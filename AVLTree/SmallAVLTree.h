@@ -0,0 +1,436 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: SmallAVLTree.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - The array is an InlineArray, which BucketAVLTreeNode shares
+**************************************************************/
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+#include "AVLTree.h"
+#include "Exception.h"
+#include "InlineArray.h"
+
+/************************************************************************
+* Class: SmallAVLTree
+*
+* Purpose: This class is an AVLTree for sets that are usually tiny. Up to
+*		InlineSize items are kept in a sorted array inside the object, so
+*		a small tree allocates nothing and a search is a linear scan of
+*		one contiguous array (branch free for arithmetic items, which the
+*		compiler can vectorize). The insert that would overflow the array
+*		builds an AVLTree out of the items in O(InlineSize) and every
+*		later call goes to it. When deletes shrink that tree to half of
+*		InlineSize the items move back into the array and its nodes are
+*		given back, so a tree that hovers around the limit does not
+*		convert back and forth on every change.
+*		Equal items are kept, like AVLTree.
+*
+* Manager functions:
+* SmallAVLTree();
+* SmallAVLTree(const SmallAVLTree<T, InlineSize, Allocator>& copy);
+* SmallAVLTree(SmallAVLTree<T, InlineSize, Allocator>&& other);
+*		Takes over the items of other, leaving it empty
+* ~SmallAVLTree();
+* SmallAVLTree<T, InlineSize, Allocator>& operator=(const SmallAVLTree<T, InlineSize, Allocator>& rhs);
+* SmallAVLTree<T, InlineSize, Allocator>& operator=(SmallAVLTree<T, InlineSize, Allocator>&& rhs);
+*
+* Methods:
+* void Insert(const T& data); / void Insert(T&& data);
+*		Inserts data into the tree
+* void Delete(const T& data);
+*		Deletes one equivalent item from the tree, throws if there is none
+* void Purge();
+*		Removes every item and gives back every node
+* int Size() const;
+*		returns the number of items in the tree in O(1)
+*
+* Lookups:
+* bool Contains(const T& data) const;
+*		Returns true if equivalent data is in the tree
+* const T* Find(const T& data) const;
+*		Returns a pointer to the stored equivalent data, or nullptr. It is valid until the next change
+* const T* Floor(const T& data) const;
+*		Returns the largest item that is not greater than data, or nullptr
+* const T* Ceiling(const T& data) const;
+*		Returns the smallest item that is not less than data, or nullptr
+*
+* Testing:
+* bool IsEmpty() const;
+*		Returns true if the tree is empty
+* bool IsInline() const;
+*		Returns true if the items are in the inline array rather than in nodes
+*
+* Traversals:
+* template <typename Visitor> bool InOrder(Visitor visit);
+*		Calls visit with every item in order. If visit returns a bool, returning false stops
+*		the traversal. Returns false if it was stopped, true if it finished
+*
+* --- HELPER FUNCTIONS ---
+* template <typename U> void InsertItem(U&& data);
+*		Helps Insert by putting data in the array, or in the tree once the array is full
+* void MoveInline();
+*		Moves the items of the tree back into the array and purges the tree
+* int LowerSlot(const T& data) const; / int UpperSlot(const T& data) const;
+*		Returns the first slot of the array that is not less than / greater than data
+* int CountLess(const T& data, std::true_type) const;
+*		Counts the items that are less than data, branch free for arithmetic items
+* void CopyInline(const SmallAVLTree<T, InlineSize, Allocator>& copy);
+*		Copies the array of copy into ours, which is empty, and purges the tree if that throws
+* template <typename Visitor> static bool Visit(Visitor& visit, T& data);
+*		Calls visit and turns its result into "keep going"
+*
+*************************************************************************/
+template <typename T, int InlineSize = 16, template <typename> class Allocator = ArenaAllocator>
+class SmallAVLTree
+{
+public:
+	SmallAVLTree();
+	SmallAVLTree(const SmallAVLTree<T, InlineSize, Allocator>& copy);
+	SmallAVLTree(SmallAVLTree<T, InlineSize, Allocator>&& other);
+	~SmallAVLTree();
+	SmallAVLTree<T, InlineSize, Allocator>& operator=(const SmallAVLTree<T, InlineSize, Allocator>& rhs);
+	SmallAVLTree<T, InlineSize, Allocator>& operator=(SmallAVLTree<T, InlineSize, Allocator>&& rhs);
+
+	//Methods
+	void Insert(const T& data); //Inserts data into the tree
+	void Insert(T&& data); //Inserts data into the tree, moving it
+	void Delete(const T& data); //Deletes one equivalent item from the tree
+	void Purge(); //Removes every item
+	int Size() const; //returns the number of items in the tree
+
+	//Lookups
+	bool Contains(const T& data) const;
+	const T* Find(const T& data) const;
+	const T* Floor(const T& data) const;
+	const T* Ceiling(const T& data) const;
+
+	//Testing
+	bool IsEmpty() const;
+	bool IsInline() const;
+
+	//Traversals
+	template <typename Visitor> bool InOrder(Visitor visit);
+
+private:
+	static_assert(InlineSize >= 2, "InlineSize has to be at least 2, the tree moves back inline at half of it");
+
+	template <typename U> void InsertItem(U&& data);
+	void MoveInline();
+	int LowerSlot(const T& data) const;
+	int UpperSlot(const T& data) const;
+	int CountLess(const T& data, std::true_type) const;
+	int CountLess(const T& data, std::false_type) const;
+	void CopyInline(const SmallAVLTree<T, InlineSize, Allocator>& copy);
+
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data);
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data, std::true_type);
+	template <typename Visitor> static bool Visit(Visitor& visit, T& data, std::false_type);
+
+	InlineArray<T, InlineSize> m_items; //empty while the tree holds the items
+	AVLTree<T, Allocator> m_tree; //empty while the array holds the items
+};
+
+
+/// Function Code ///
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline SmallAVLTree<T, InlineSize, Allocator>::SmallAVLTree()
+{
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline SmallAVLTree<T, InlineSize, Allocator>::SmallAVLTree(const SmallAVLTree<T, InlineSize, Allocator>& copy) : m_tree(copy.m_tree)
+{
+	CopyInline(copy);
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline SmallAVLTree<T, InlineSize, Allocator>::SmallAVLTree(SmallAVLTree<T, InlineSize, Allocator>&& other) : m_tree(std::move(other.m_tree))
+{
+	m_items.TakeBack(other.m_items);
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline SmallAVLTree<T, InlineSize, Allocator>::~SmallAVLTree()
+{
+	//m_items destroys the items of the array, m_tree its nodes
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline SmallAVLTree<T, InlineSize, Allocator>& SmallAVLTree<T, InlineSize, Allocator>::operator=(const SmallAVLTree<T, InlineSize, Allocator>& rhs)
+{
+	if (this != &rhs)
+	{
+		Purge();
+
+		//copy
+		m_tree = rhs.m_tree;
+		CopyInline(rhs);
+	}
+
+	return *this;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline SmallAVLTree<T, InlineSize, Allocator>& SmallAVLTree<T, InlineSize, Allocator>::operator=(SmallAVLTree<T, InlineSize, Allocator>&& rhs)
+{
+	if (this != &rhs)
+	{
+		Purge();
+
+		//move
+		m_tree = std::move(rhs.m_tree);
+		m_items.TakeBack(rhs.m_items);
+	}
+
+	return *this;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline void SmallAVLTree<T, InlineSize, Allocator>::Insert(const T & data)
+{
+	InsertItem(data);
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline void SmallAVLTree<T, InlineSize, Allocator>::Insert(T && data)
+{
+	InsertItem(std::move(data));
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline void SmallAVLTree<T, InlineSize, Allocator>::Delete(const T & data)
+{
+	if (IsEmpty())
+		throw Exception("Tried to delete from empty tree");
+
+	if (IsInline())
+	{
+		int slot = LowerSlot(data);
+
+		if (slot == m_items.Count() || data < m_items.Item(slot))
+			throw Exception("Could not find item to delete from tree");
+
+		m_items.RemoveAt(slot);
+	}
+	else
+	{
+		m_tree.Delete(data);
+
+		if (m_tree.Size() <= InlineSize / 2)
+			MoveInline();
+	}
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline void SmallAVLTree<T, InlineSize, Allocator>::Purge()
+{
+	m_items.Clear();
+	m_tree.Purge();
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline int SmallAVLTree<T, InlineSize, Allocator>::Size() const
+{
+	return m_items.Count() + m_tree.Size();
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline bool SmallAVLTree<T, InlineSize, Allocator>::Contains(const T & data) const
+{
+	return Find(data) != nullptr;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline const T* SmallAVLTree<T, InlineSize, Allocator>::Find(const T & data) const
+{
+	if (!IsInline())
+		return m_tree.Find(data);
+
+	int slot = LowerSlot(data);
+
+	return (slot < m_items.Count() && !(data < m_items.Item(slot))) ? &m_items.Item(slot) : nullptr;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline const T* SmallAVLTree<T, InlineSize, Allocator>::Floor(const T & data) const
+{
+	if (!IsInline())
+		return m_tree.Floor(data);
+
+	int slot = UpperSlot(data);
+
+	return (slot > 0) ? &m_items.Item(slot - 1) : nullptr;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline const T* SmallAVLTree<T, InlineSize, Allocator>::Ceiling(const T & data) const
+{
+	if (!IsInline())
+		return m_tree.Ceiling(data);
+
+	int slot = LowerSlot(data);
+
+	return (slot < m_items.Count()) ? &m_items.Item(slot) : nullptr;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline bool SmallAVLTree<T, InlineSize, Allocator>::IsEmpty() const
+{
+	return Size() == 0;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline bool SmallAVLTree<T, InlineSize, Allocator>::IsInline() const
+{
+	return m_tree.IsEmpty();
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+template<typename Visitor>
+inline bool SmallAVLTree<T, InlineSize, Allocator>::InOrder(Visitor visit)
+{
+	if (!IsInline())
+		return m_tree.template InOrder<Visitor>(visit); //not the function pointer overload, which returns nothing
+
+	for (int slot = 0; slot < m_items.Count(); ++slot)
+	{
+		if (!Visit(visit, m_items.Item(slot)))
+			return false;
+	}
+
+	return true;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+template<typename U>
+inline void SmallAVLTree<T, InlineSize, Allocator>::InsertItem(U&& data)
+{
+	if (!IsInline())
+	{
+		m_tree.Insert(std::forward<U>(data));
+	}
+	else if (!m_items.IsFull())
+	{
+		//after any equal items, like AVLTree puts equal items to the right
+		m_items.InsertAt(UpperSlot(data), std::forward<U>(data));
+	}
+	else
+	{
+		//the array is full, build the tree from copies so a throw leaves the array as it was
+		const T* first = &m_items.Item(0);
+		m_tree.BuildFromSorted(first, first + m_items.Count());
+
+		try
+		{
+			m_tree.Insert(std::forward<U>(data)); //data may be one of our items, which are still alive
+		}
+		catch (...)
+		{
+			m_tree.Purge();
+			throw;
+		}
+
+		m_items.Clear();
+	}
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline void SmallAVLTree<T, InlineSize, Allocator>::MoveInline()
+{
+	try
+	{
+		m_tree.InOrder([this](T& item) { m_items.PushBack(std::move_if_noexcept(item)); });
+	}
+	catch (...)
+	{
+		//the items are all still in the tree, so it just stays a tree
+		m_items.Clear();
+		return;
+	}
+
+	m_tree.Purge();
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline int SmallAVLTree<T, InlineSize, Allocator>::LowerSlot(const T & data) const
+{
+	return CountLess(data, std::is_arithmetic<T>());
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline int SmallAVLTree<T, InlineSize, Allocator>::UpperSlot(const T & data) const
+{
+	int slot = LowerSlot(data);
+
+	while (slot < m_items.Count() && !(data < m_items.Item(slot)))
+		++slot;
+
+	return slot;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline int SmallAVLTree<T, InlineSize, Allocator>::CountLess(const T & data, std::true_type) const
+{
+	//no early exit, so there is no branch to mispredict and the loop vectorizes
+	const T* items = &m_items.Item(0);
+	int count = 0;
+
+	for (int slot = 0; slot < m_items.Count(); ++slot)
+		count += (items[slot] < data) ? 1 : 0;
+
+	return count;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline int SmallAVLTree<T, InlineSize, Allocator>::CountLess(const T & data, std::false_type) const
+{
+	//comparisons may be expensive, so stop at the first item that is not less
+	int count = 0;
+
+	while (count < m_items.Count() && m_items.Item(count) < data)
+		++count;
+
+	return count;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+inline void SmallAVLTree<T, InlineSize, Allocator>::CopyInline(const SmallAVLTree<T, InlineSize, Allocator>& copy)
+{
+	try
+	{
+		m_items.CopyFrom(copy.m_items);
+	}
+	catch (...)
+	{
+		//CopyFrom left the array empty
+		m_tree.Purge();
+		throw;
+	}
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+template<typename Visitor>
+inline bool SmallAVLTree<T, InlineSize, Allocator>::Visit(Visitor& visit, T& data)
+{
+	return Visit(visit, data, std::is_void<decltype(visit(data))>());
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+template<typename Visitor>
+inline bool SmallAVLTree<T, InlineSize, Allocator>::Visit(Visitor& visit, T& data, std::true_type)
+{
+	visit(data);
+	return true;
+}
+
+template<typename T, int InlineSize, template <typename> class Allocator>
+template<typename Visitor>
+inline bool SmallAVLTree<T, InlineSize, Allocator>::Visit(Visitor& visit, T& data, std::false_type)
+{
+	return static_cast<bool>(visit(data));
+}
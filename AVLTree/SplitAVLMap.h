@@ -0,0 +1,477 @@
+/*************************************************************
+* Author: Dillon Wall
+* Filename: SplitAVLMap.h
+* Date Created: 10/17/2026
+* Modifications:
+*		- 10/17/2026 - operator[], InsertOrAssign and TryEmplace find or add the key in one walk
+**************************************************************/
+
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "CompactAVLTree.h"
+#include "Exception.h"
+
+/************************************************************************
+* Class: SplitAVLMap
+*
+* Purpose: This class is an ordered key/value map that keeps the parts
+*		a search reads apart from the parts it does not. The keys, child
+*		links and balance bits are a CompactAVLTree (the hot array), and
+*		the values sit in a second array at the same slot numbers (the
+*		cold array). A search walks only the hot array, which for small
+*		keys is 12 bytes a node however big the values are, and touches
+*		the cold array once, after it found the key. With an AVLMap every
+*		node on the path drags its value through the cache along with the
+*		key. Keys are unique and only need operator<. The methods work
+*		like AVLMap's; instead of iterators it has InOrder, which hands
+*		out each key with its value.
+*
+* Manager functions:
+* SplitAVLMap();
+* SplitAVLMap(const SplitAVLMap<K, V>& copy);
+*		Copies both arrays in O(n)
+* SplitAVLMap(SplitAVLMap<K, V>&& other);
+*		Takes over the arrays of other, leaving it empty
+* ~SplitAVLMap();
+* SplitAVLMap<K, V>& operator=(const SplitAVLMap<K, V>& rhs);
+* SplitAVLMap<K, V>& operator=(SplitAVLMap<K, V>&& rhs);
+*
+* Methods:
+* V& operator[](const K& key);
+*		Returns the value of key, inserting a default constructed value first if key is new
+* bool Insert(const K& key, const V& value);
+*		Adds key with value if key is new. Returns true if it was added, an existing value is left alone
+* template <typename M> bool InsertOrAssign(const K& key, M&& value);
+*		Adds key with value, or assigns value to the existing entry. Returns true if key was new
+* template <typename... Args> bool TryEmplace(const K& key, Args&&... args);
+*		Adds key with a value constructed in place from args if key is new. Returns true if it was added,
+*		args are not touched otherwise
+* void Delete(const K& key);
+*		Deletes the entry of key, throws if there is none
+* V* Find(const K& key); / const V* Find(const K& key) const;
+*		Returns the value of key, or nullptr. It is valid until the next insert
+* bool Contains(const K& key) const;
+*		Returns true if key is in the map, without touching the values
+* int Size() const;
+*		Returns the number of entries
+* bool IsEmpty() const;
+*		Returns true if the map has no entries
+* void Purge();
+*		Removes every entry
+* void Reserve(int count);
+*		Makes room for count more entries in both arrays
+* template <typename Visitor> bool InOrder(Visitor visit);
+*		Calls visit(key, value) for every entry in key order. If visit returns a bool, returning
+*		false stops the traversal. Returns false if it was stopped, true if it finished
+*
+* --- HELPER FUNCTIONS ---
+* struct ValueSlot
+*		Storage for one value
+* V& Value(Index slot); / const V& Value(Index slot) const;
+*		Returns the value in a slot
+* template <typename... Args> void Place(Index slot, const K& key, Args&&... args);
+*		Builds the value of key, which CompactAVLTree::FindOrInsert just put in slot. If that
+*		throws key is deleted again
+* void GrowValues(Index capacity);
+*		Moves the values to an array of capacity slots
+* bool HasValue(Index slot) const;
+*		Returns true if slot holds a key, so its value is alive
+* void CopyValues(const SplitAVLMap<K, V>& copy);
+*		Copies the values of copy into the slots m_keys copied
+* void DestroyValues();
+*		Destroys every value, the keys are left alone
+* template <typename Visitor> static bool Visit(Visitor& visit, const K& key, V& value);
+*		Calls visit and turns its result into "keep going"
+*
+*************************************************************************/
+template <typename K, typename V>
+class SplitAVLMap
+{
+public:
+	SplitAVLMap();
+	SplitAVLMap(const SplitAVLMap<K, V>& copy);
+	SplitAVLMap(SplitAVLMap<K, V>&& other);
+	~SplitAVLMap();
+	SplitAVLMap<K, V>& operator=(const SplitAVLMap<K, V>& rhs);
+	SplitAVLMap<K, V>& operator=(SplitAVLMap<K, V>&& rhs);
+
+	V& operator[](const K& key);
+	bool Insert(const K& key, const V& value);
+	template <typename M> bool InsertOrAssign(const K& key, M&& value);
+	template <typename... Args> bool TryEmplace(const K& key, Args&&... args);
+	void Delete(const K& key);
+
+	V* Find(const K& key);
+	const V* Find(const K& key) const;
+	bool Contains(const K& key) const;
+	int Size() const;
+	bool IsEmpty() const;
+	void Purge();
+	void Reserve(int count);
+
+	template <typename Visitor> bool InOrder(Visitor visit);
+
+private:
+	typedef typename CompactAVLTree<K>::Index Index;
+
+	struct ValueSlot
+	{
+		typename std::aligned_storage<sizeof(V), alignof(V)>::type m_storage;
+	};
+
+	V& Value(Index slot);
+	const V& Value(Index slot) const;
+	template <typename... Args> void Place(Index slot, const K& key, Args&&... args);
+	void GrowValues(Index capacity);
+	bool HasValue(Index slot) const;
+	void CopyValues(const SplitAVLMap<K, V>& copy);
+	void DestroyValues();
+
+	template <typename Visitor> static bool Visit(Visitor& visit, const K& key, V& value);
+	template <typename Visitor> static bool Visit(Visitor& visit, const K& key, V& value, std::true_type);
+	template <typename Visitor> static bool Visit(Visitor& visit, const K& key, V& value, std::false_type);
+
+	CompactAVLTree<K> m_keys; //the hot array: keys, links and balance bits
+	std::vector<ValueSlot> m_values; //the cold array, slot i holds the value of the key in slot i of m_keys
+};
+
+
+/// Function Code ///
+
+template<typename K, typename V>
+inline SplitAVLMap<K, V>::SplitAVLMap()
+{
+}
+
+template<typename K, typename V>
+inline SplitAVLMap<K, V>::SplitAVLMap(const SplitAVLMap<K, V>& copy) : m_keys(copy.m_keys)
+{
+	//m_keys copied every slot in place, so the values go to the same slot numbers
+	CopyValues(copy);
+}
+
+template<typename K, typename V>
+inline SplitAVLMap<K, V>::SplitAVLMap(SplitAVLMap<K, V>&& other) : m_keys(std::move(other.m_keys)), m_values(std::move(other.m_values))
+{
+	//Default values
+	other.m_values.clear();
+}
+
+template<typename K, typename V>
+inline SplitAVLMap<K, V>::~SplitAVLMap()
+{
+	DestroyValues();
+}
+
+template<typename K, typename V>
+inline SplitAVLMap<K, V>& SplitAVLMap<K, V>::operator=(const SplitAVLMap<K, V>& rhs)
+{
+	if (this != &rhs)
+	{
+		SplitAVLMap<K, V> copy(rhs);
+		*this = std::move(copy);
+	}
+
+	return *this;
+}
+
+template<typename K, typename V>
+inline SplitAVLMap<K, V>& SplitAVLMap<K, V>::operator=(SplitAVLMap<K, V>&& rhs)
+{
+	if (this != &rhs)
+	{
+		Purge();
+
+		m_keys = std::move(rhs.m_keys);
+		m_values.swap(rhs.m_values);
+	}
+
+	return *this;
+}
+
+template<typename K, typename V>
+inline V& SplitAVLMap<K, V>::operator[](const K & key)
+{
+	bool inserted = false;
+	Index slot = m_keys.FindOrInsert(key, inserted);
+
+	if (inserted)
+		Place(slot, key);
+
+	return Value(slot);
+}
+
+template<typename K, typename V>
+inline bool SplitAVLMap<K, V>::Insert(const K & key, const V & value)
+{
+	return TryEmplace(key, value);
+}
+
+template<typename K, typename V>
+template<typename M>
+inline bool SplitAVLMap<K, V>::InsertOrAssign(const K & key, M && value)
+{
+	bool inserted = false;
+	Index slot = m_keys.FindOrInsert(key, inserted);
+
+	if (inserted)
+	{
+		Place(slot, key, std::forward<M>(value));
+
+		return true;
+	}
+
+	Value(slot) = std::forward<M>(value);
+
+	return false;
+}
+
+template<typename K, typename V>
+template<typename... Args>
+inline bool SplitAVLMap<K, V>::TryEmplace(const K & key, Args&&... args)
+{
+	bool inserted = false;
+	Index slot = m_keys.FindOrInsert(key, inserted);
+
+	if (inserted)
+		Place(slot, key, std::forward<Args>(args)...);
+
+	return inserted;
+}
+
+template<typename K, typename V>
+inline void SplitAVLMap<K, V>::Delete(const K & key)
+{
+	Index slot = m_keys.FindNode(key);
+
+	//m_keys throws the same exceptions AVLMap does when key is missing
+	m_keys.Delete(key);
+
+	//the node of key is the one unlinked (a predecessor is moved, not copied), so its slot is free now
+	Value(slot).~V();
+}
+
+template<typename K, typename V>
+inline V* SplitAVLMap<K, V>::Find(const K & key)
+{
+	Index slot = m_keys.FindNode(key);
+
+	return slot != CompactAVLTree<K>::NIL ? &Value(slot) : nullptr;
+}
+
+template<typename K, typename V>
+inline const V* SplitAVLMap<K, V>::Find(const K & key) const
+{
+	Index slot = m_keys.FindNode(key);
+
+	return slot != CompactAVLTree<K>::NIL ? &Value(slot) : nullptr;
+}
+
+template<typename K, typename V>
+inline bool SplitAVLMap<K, V>::Contains(const K & key) const
+{
+	return m_keys.Contains(key);
+}
+
+template<typename K, typename V>
+inline int SplitAVLMap<K, V>::Size() const
+{
+	return m_keys.Size();
+}
+
+template<typename K, typename V>
+inline bool SplitAVLMap<K, V>::IsEmpty() const
+{
+	return m_keys.IsEmpty();
+}
+
+template<typename K, typename V>
+inline void SplitAVLMap<K, V>::Purge()
+{
+	DestroyValues();
+	std::vector<ValueSlot>().swap(m_values);
+	m_keys.Purge();
+}
+
+template<typename K, typename V>
+inline void SplitAVLMap<K, V>::Reserve(int count)
+{
+	m_keys.Reserve(count);
+
+	if (m_values.size() < m_keys.m_pool.size())
+		GrowValues(static_cast<Index>(m_keys.m_pool.size()));
+}
+
+template<typename K, typename V>
+template<typename Visitor>
+inline bool SplitAVLMap<K, V>::InOrder(Visitor visit)
+{
+	Index path[AVL_MAX_HEIGHT];
+	int depth = 0;
+	Index current = m_keys.m_root;
+
+	while (current != CompactAVLTree<K>::NIL || depth > 0)
+	{
+		//go as far left as possible, then visit and step into the right subtree
+		while (current != CompactAVLTree<K>::NIL)
+		{
+			path[depth++] = current;
+			current = m_keys.Left(current);
+		}
+
+		current = path[--depth];
+		if (!Visit(visit, m_keys.Data(current), Value(current)))
+			return false;
+
+		current = m_keys.Right(current);
+	}
+
+	return true;
+}
+
+template<typename K, typename V>
+inline V& SplitAVLMap<K, V>::Value(Index slot)
+{
+	return *reinterpret_cast<V*>(&m_values[slot].m_storage);
+}
+
+template<typename K, typename V>
+inline const V& SplitAVLMap<K, V>::Value(Index slot) const
+{
+	return *reinterpret_cast<const V*>(&m_values[slot].m_storage);
+}
+
+template<typename K, typename V>
+template<typename... Args>
+inline void SplitAVLMap<K, V>::Place(Index slot, const K & key, Args&&... args)
+{
+	try
+	{
+		if (slot >= m_values.size())
+		{
+			//args may point into the cold array, so the value is built before it moves
+			V value(std::forward<Args>(args)...);
+			GrowValues(static_cast<Index>(m_keys.m_pool.size()));
+			new (&m_values[slot].m_storage) V(std::move(value));
+		}
+		else
+		{
+			new (&m_values[slot].m_storage) V(std::forward<Args>(args)...);
+		}
+	}
+	catch (...)
+	{
+		m_keys.Delete(key);
+		throw;
+	}
+}
+
+template<typename K, typename V>
+inline void SplitAVLMap<K, V>::GrowValues(Index capacity)
+{
+	//only slots below the old size can hold a value, the new key's slot is filled by the caller
+	const Index oldSize = static_cast<Index>(m_values.size());
+	std::vector<ValueSlot> bigger(capacity);
+	Index moved = 1;
+
+	try
+	{
+		//a throwing copy leaves the old array untouched, only values that cannot throw are moved
+		for (; moved < oldSize; ++moved)
+		{
+			if (HasValue(moved))
+				new (&bigger[moved].m_storage) V(std::move_if_noexcept(Value(moved)));
+		}
+	}
+	catch (...)
+	{
+		for (Index slot = 1; slot < moved; ++slot)
+		{
+			if (HasValue(slot))
+				reinterpret_cast<V*>(&bigger[slot].m_storage)->~V();
+		}
+
+		throw;
+	}
+
+	for (Index slot = 1; slot < oldSize; ++slot)
+	{
+		if (HasValue(slot))
+			Value(slot).~V();
+	}
+
+	m_values.swap(bigger);
+}
+
+template<typename K, typename V>
+inline bool SplitAVLMap<K, V>::HasValue(Index slot) const
+{
+	return slot < m_keys.m_used && m_keys.IsLive(m_keys.m_pool[slot]);
+}
+
+template<typename K, typename V>
+inline void SplitAVLMap<K, V>::CopyValues(const SplitAVLMap<K, V>& copy)
+{
+	std::vector<ValueSlot> values(m_keys.m_pool.size());
+	Index copied = 1;
+
+	try
+	{
+		for (; copied < m_keys.m_used; ++copied)
+		{
+			if (HasValue(copied))
+				new (&values[copied].m_storage) V(copy.Value(copied));
+		}
+	}
+	catch (...)
+	{
+		for (Index slot = 1; slot < copied; ++slot)
+		{
+			if (HasValue(slot))
+				reinterpret_cast<V*>(&values[slot].m_storage)->~V();
+		}
+
+		throw;
+	}
+
+	m_values.swap(values);
+}
+
+template<typename K, typename V>
+inline void SplitAVLMap<K, V>::DestroyValues()
+{
+	if (!std::is_trivially_destructible<V>::value)
+	{
+		for (Index slot = 1; slot < m_values.size(); ++slot)
+		{
+			if (HasValue(slot))
+				Value(slot).~V();
+		}
+	}
+}
+
+template<typename K, typename V>
+template<typename Visitor>
+inline bool SplitAVLMap<K, V>::Visit(Visitor& visit, const K& key, V& value)
+{
+	return Visit(visit, key, value, std::is_void<decltype(visit(key, value))>());
+}
+
+template<typename K, typename V>
+template<typename Visitor>
+inline bool SplitAVLMap<K, V>::Visit(Visitor& visit, const K& key, V& value, std::true_type)
+{
+	visit(key, value);
+	return true;
+}
+
+template<typename K, typename V>
+template<typename Visitor>
+inline bool SplitAVLMap<K, V>::Visit(Visitor& visit, const K& key, V& value, std::false_type)
+{
+	return static_cast<bool>(visit(key, value));
+}